@@ -0,0 +1,36 @@
+#include "utils.hpp"
+
+static void BM_BufferLayoutConstruct(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        AGI::BufferLayout layout = {
+            { AGI::ShaderDataType::Float3, "a_Position" },
+            { AGI::ShaderDataType::Float4, "a_Colour" },
+            { AGI::ShaderDataType::Float2, "a_TexCoord" },
+            { AGI::ShaderDataType::Float, "a_TexIndex" },
+            { AGI::ShaderDataType::Float, "a_TilingFactor" },
+            { AGI::ShaderDataType::Int, "a_EntityID" }
+        };
+
+        benchmark::DoNotOptimize(layout);
+    }
+}
+BENCHMARK(BM_BufferLayoutConstruct);
+
+static void BM_BufferLayoutLookup(benchmark::State& state)
+{
+    AGI::BufferLayout layout;
+    for (int i = 0; i < state.range(0); i++)
+        layout.PushBack({ AGI::ShaderDataType::Float4, std::format("a_Attribute{}", i) });
+
+    // Worst case, the element at the back
+    std::string name = std::format("a_Attribute{}", state.range(0) - 1);
+
+    for (auto _ : state)
+    {
+        AGI::BufferElement& element = layout[name];
+        benchmark::DoNotOptimize(element);
+    }
+}
+BENCHMARK(BM_BufferLayoutLookup)->Arg(4)->Arg(16);
@@ -0,0 +1,59 @@
+#include "utils.hpp"
+
+// Gradients with a little noise, a mix of smooth and busy blocks
+static const std::vector<uint8_t>& GetEncoderImage()
+{
+    static std::vector<uint8_t> s_Image = []()
+    {
+        std::vector<uint8_t> image(1024 * 1024 * 4);
+        uint32_t seed = 1;
+
+        for (uint32_t y = 0; y < 1024; y++)
+        {
+            for (uint32_t x = 0; x < 1024; x++)
+            {
+                seed = seed * 1664525 + 1013904223;
+                uint8_t noise = seed >> 27;
+
+                uint8_t* texel = &image[(y * 1024 + x) * 4];
+                texel[0] = (uint8_t)(x / 4 + noise);
+                texel[1] = (uint8_t)(y / 4 + noise);
+                texel[2] = (uint8_t)((x + y) / 8);
+                texel[3] = (uint8_t)(255 - x / 4);
+            }
+        }
+
+        return image;
+    }();
+
+    return s_Image;
+}
+
+// Args are the format, the quality and the worker count. PerCore is source bytes
+// per second divided by the workers, compare it between thread counts for scaling.
+static void BM_EncodeBlocks(benchmark::State& state)
+{
+    auto format = (AGI::ImageFormat)state.range(0);
+    auto quality = (AGI::TextureCompression)state.range(1);
+    uint32_t threads = (uint32_t)state.range(2);
+
+    const std::vector<uint8_t>& image = GetEncoderImage();
+    std::vector<uint8_t> output(1024 * 1024);
+
+    for (auto _ : state)
+    {
+        AGI::Utils::EncodeBlocks(image.data(), { 1024, 1024 }, 4, format, output.data(), quality, threads);
+        benchmark::DoNotOptimize(output);
+    }
+
+    int64_t bytes = state.iterations() * (int64_t)image.size();
+    state.SetBytesProcessed(bytes);
+    state.counters["PerCore"] = benchmark::Counter((double)bytes / threads, benchmark::Counter::kIsRate, benchmark::Counter::kIs1024);
+}
+BENCHMARK(BM_EncodeBlocks)
+    ->ArgsProduct({
+        { (int64_t)AGI::ImageFormat::BC1, (int64_t)AGI::ImageFormat::BC3, (int64_t)AGI::ImageFormat::BC4, (int64_t)AGI::ImageFormat::BC5, (int64_t)AGI::ImageFormat::ETC2_RGB, (int64_t)AGI::ImageFormat::ETC2_RGBA },
+        { (int64_t)AGI::TextureCompression::Fast, (int64_t)AGI::TextureCompression::High },
+        { 1, 4 }
+    })
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,44 @@
+#include "utils.hpp"
+
+static void BM_DrawIndexed(benchmark::State& state)
+{
+    AGI_BENCH_REQUIRE_CONTEXT(state, context);
+
+    float vertices[10 * 4] = {
+        -0.5f, -0.5f, 0.0f,  1.0f, 1.0f, 1.0f, 1.0f,  0.0f, 0.0f,  0.0f,
+         0.5f, -0.5f, 0.0f,  1.0f, 1.0f, 1.0f, 1.0f,  1.0f, 0.0f,  0.0f,
+         0.5f,  0.5f, 0.0f,  1.0f, 1.0f, 1.0f, 1.0f,  1.0f, 1.0f,  0.0f,
+        -0.5f,  0.5f, 0.0f,  1.0f, 1.0f, 1.0f, 1.0f,  0.0f, 1.0f,  0.0f
+    };
+
+    uint32_t indices[6] = { 0, 1, 2, 2, 3, 0 };
+
+    AGI::Shader shader = context->CreateShader(AGI::Utils::ProcessSource(s_BenchShader));
+
+    AGI::VertexArray vertexArray = context->CreateVertexArray();
+    AGI::VertexBuffer vertexBuffer = context->CreateVertexBuffer(4, shader->GetLayout());
+    vertexBuffer->SetData(vertices, sizeof(vertices));
+    vertexArray->AddVertexBuffer(vertexBuffer);
+
+    AGI::IndexBuffer indexBuffer = context->CreateIndexBuffer(indices, 6);
+    vertexArray->SetIndexBuffer(indexBuffer);
+
+    shader->Bind();
+    shader->SetMat4("u_ViewProjection", glm::mat4(1.0f));
+    shader->SetMat4("u_Transform", glm::mat4(1.0f));
+    shader->SetFloat4("u_Tint", glm::vec4(1.0f));
+
+    // Frames of 'range(0)' draws, measures submission rather than GPU work
+    for (auto _ : state)
+    {
+        context->BeginFrame();
+
+        for (int i = 0; i < state.range(0); i++)
+            context->DrawIndexed(vertexArray);
+
+        context->EndFrame();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DrawIndexed)->Arg(1)->Arg(100)->Arg(1000);
@@ -0,0 +1,43 @@
+#include "utils.hpp"
+
+class BenchResource : public AGI::RefCounted
+{
+public:
+    uint64_t Payload = 0;
+};
+
+// Lives for the whole run so the reference count never reaches zero under contention
+static AGI::ResourceBarrier<BenchResource> s_SharedResource = AGI::ResourceBarrier<BenchResource>::Create();
+
+static void BM_ResourceBarrierCopy(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        AGI::ResourceBarrier<BenchResource> copy = s_SharedResource;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_ResourceBarrierCopy)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ResourceBarrierMove(benchmark::State& state)
+{
+    AGI::ResourceBarrier<BenchResource> local = s_SharedResource;
+
+    for (auto _ : state)
+    {
+        AGI::ResourceBarrier<BenchResource> moved = std::move(local);
+        local = std::move(moved);
+        benchmark::DoNotOptimize(local);
+    }
+}
+BENCHMARK(BM_ResourceBarrierMove)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ResourceBarrierCreateDestroy(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto resource = AGI::ResourceBarrier<BenchResource>::Create();
+        benchmark::DoNotOptimize(resource);
+    }
+}
+BENCHMARK(BM_ResourceBarrierCreateDestroy)->ThreadRange(1, 8)->UseRealTime();
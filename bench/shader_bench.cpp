@@ -0,0 +1,88 @@
+#include "utils.hpp"
+
+// Pads both stages with 'lines' lines of helper functions
+static std::string MakeLargeSource(int lines)
+{
+    std::string body;
+    for (int i = 0; i < lines; i++)
+        body += std::format("    float helper{0}(float x) {{ return x * {0}.0 + 1.0; }}\n", i);
+
+    return std::format(
+        "#type vertex\n#version 330 core\nlayout(location = 0) in vec3 a_Position;\n{0}void main() {{ gl_Position = vec4(a_Position, 1.0); }}\n"
+        "#type fragment\n#version 330 core\nlayout(location = 0) out vec4 color;\n{0}void main() {{ color = vec4(1.0); }}\n",
+        body);
+}
+
+static void BM_ProcessSource(benchmark::State& state)
+{
+    std::string source = MakeLargeSource(state.range(0));
+
+    for (auto _ : state)
+    {
+        AGI::ShaderSources sources = AGI::Utils::ProcessSource(source);
+        benchmark::DoNotOptimize(sources);
+    }
+
+    state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_ProcessSource)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_ShaderGetLayout(benchmark::State& state)
+{
+    AGI_BENCH_REQUIRE_CONTEXT(state, context);
+    AGI::Shader shader = context->CreateShader(AGI::Utils::ProcessSource(s_BenchShader));
+
+    for (auto _ : state)
+    {
+        AGI::BufferLayout layout = shader->GetLayout();
+        benchmark::DoNotOptimize(layout);
+    }
+}
+BENCHMARK(BM_ShaderGetLayout);
+
+static void BM_ShaderSetUniforms(benchmark::State& state)
+{
+    AGI_BENCH_REQUIRE_CONTEXT(state, context);
+    AGI::Shader shader = context->CreateShader(AGI::Utils::ProcessSource(s_BenchShader));
+    shader->Bind();
+
+    glm::mat4 transform = glm::mat4(1.0f);
+    float time = 0.0f;
+
+    for (auto _ : state)
+    {
+        shader->SetMat4("u_ViewProjection", transform);
+        shader->SetMat4("u_Transform", transform);
+        shader->SetFloat4("u_Tint", glm::vec4(1.0f));
+        shader->SetFloat("u_Time", time += 0.016f);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_ShaderSetUniforms);
+
+static void BM_ShaderSetUniformsByID(benchmark::State& state)
+{
+    AGI_BENCH_REQUIRE_CONTEXT(state, context);
+    AGI::Shader shader = context->CreateShader(AGI::Utils::ProcessSource(s_BenchShader));
+    shader->Bind();
+
+    constexpr AGI::UniformID viewProjection = AGI::ShaderBase::GetUniformID("u_ViewProjection");
+    constexpr AGI::UniformID transformID = AGI::ShaderBase::GetUniformID("u_Transform");
+    constexpr AGI::UniformID tint = AGI::ShaderBase::GetUniformID("u_Tint");
+    constexpr AGI::UniformID timeID = AGI::ShaderBase::GetUniformID("u_Time");
+
+    glm::mat4 transform = glm::mat4(1.0f);
+    float time = 0.0f;
+
+    for (auto _ : state)
+    {
+        shader->SetMat4(viewProjection, transform);
+        shader->SetMat4(transformID, transform);
+        shader->SetFloat4(tint, glm::vec4(1.0f));
+        shader->SetFloat(timeID, time += 0.016f);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_ShaderSetUniformsByID);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <AGI/agi.hpp>
+#include <benchmark/benchmark.h>
+
+static void OnAGIMessage(std::string_view message, AGI::LogLevel level)
+{
+    // Keep the benchmark output clean, only errors are worth seeing
+    if (level == AGI::LogLevel::Error)
+        std::fprintf(stderr, "AGI: %.*s\n", (int)message.size(), message.data());
+}
+
+// One headless llvmpipe context shared by every GPU benchmark, benchmarks
+// run sequentially on the main thread so this stays current for all of them
+static AGI::RenderContext* GetHeadlessContext()
+{
+    static AGI::RenderContext* s_Context = []() -> AGI::RenderContext*
+    {
+        AGI::Settings settings;
+        settings.PreferedAPI = AGI::APIType::OpenGL;
+        settings.MessageFunc = OnAGIMessage;
+        settings.Headless = true;
+
+        AGI::WindowProps windowProps;
+        windowProps.Title = "agi_bench";
+        windowProps.Size = { 256, 256 };
+
+        auto window = AGI::Window::Create(settings, windowProps);
+        auto context = AGI::RenderContext::Create(window);
+
+        if (!context->Init())
+        {
+            delete context;
+            return nullptr;
+        }
+
+        return context;
+    }();
+
+    return s_Context;
+}
+
+#define AGI_BENCH_REQUIRE_CONTEXT(state, context) \
+    AGI::RenderContext* context = GetHeadlessContext(); \
+    if (!context) { state.SkipWithError("Could not create a headless OpenGL context"); return; }
+
+static const char* s_BenchShader = R"(
+    #type vertex
+    #version 330 core
+
+    layout(location = 0) in vec3 a_Position;
+    layout(location = 1) in vec4 a_Colour;
+    layout(location = 2) in vec2 a_TexCoord;
+    layout(location = 3) in float a_TexIndex;
+
+    uniform mat4 u_ViewProjection;
+    uniform mat4 u_Transform;
+
+    out vec4 v_Colour;
+    out vec2 v_TexCoord;
+    out float v_TexIndex;
+
+    void main()
+    {
+        v_Colour = a_Colour;
+        v_TexCoord = a_TexCoord;
+        v_TexIndex = a_TexIndex;
+        gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
+    }
+
+    #type fragment
+    #version 330 core
+
+    layout(location = 0) out vec4 color;
+
+    in vec4 v_Colour;
+    in vec2 v_TexCoord;
+    in float v_TexIndex;
+
+    uniform vec4 u_Tint;
+    uniform float u_Time;
+
+    void main()
+    {
+        color = v_Colour * u_Tint * (0.5 + 0.5 * sin(u_Time + v_TexIndex));
+    }
+)";
@@ -0,0 +1,103 @@
+# agi_add_shaders(<target> FILES <files...> [API OPENGL|VULKAN] [EMBED] [NAME <symbol>] [OUTPUT <file>])
+#
+# Compiles '#type' shader files to SPIR-V at build time and packs them into a
+# single indexed file, load it with AGI::ShaderPack and pass
+# GetBinaries("<file name without extension>") to CreateShader(). Shader errors
+# fail the build instead of showing up at startup. Files go through
+# AGI::ShaderPreprocessor first, so '#include' works like it does at runtime.
+# Varying locations and sampler bindings that aren't spelled out are assigned
+# in declaration order per stage, so declare varyings in the same order in
+# every stage or give them a location.
+#
+#   API     SPIR-V flavour, OPENGL allows loose uniforms (default) while
+#           VULKAN follows the Vulkan rules
+#   EMBED   compiles the pack into <target>, include "<symbol>.hpp" and
+#           construct AGI::ShaderPack(<symbol>). Otherwise the pack is copied
+#           next to the target's binary
+#   NAME    symbol and header name for EMBED, defaults to <target>_shaders
+#   OUTPUT  where the pack is written, defaults to <target>.agipack in the
+#           current binary directory
+
+find_program(AGI_GLSLANG_VALIDATOR NAMES glslangValidator glslang HINTS "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+
+function(agi_add_shaders TARGET)
+    cmake_parse_arguments(ARG "EMBED" "API;NAME;OUTPUT" "FILES" ${ARGN})
+
+    if (NOT ARG_FILES)
+        message(FATAL_ERROR "agi_add_shaders(${TARGET}) needs at least one file in FILES")
+    endif()
+
+    if (NOT AGI_GLSLANG_VALIDATOR)
+        message(FATAL_ERROR "agi_add_shaders(${TARGET}) needs glslangValidator, install the Vulkan SDK or set AGI_GLSLANG_VALIDATOR")
+    endif()
+
+    if (NOT ARG_API)
+        set(ARG_API OPENGL)
+    endif()
+
+    if (ARG_API STREQUAL "OPENGL")
+        set(SHADER_TARGET opengl)
+    elseif (ARG_API STREQUAL "VULKAN")
+        set(SHADER_TARGET vulkan)
+    else()
+        message(FATAL_ERROR "agi_add_shaders(${TARGET}) API must be OPENGL or VULKAN, got '${ARG_API}'")
+    endif()
+
+    if (NOT ARG_NAME)
+        set(ARG_NAME "${TARGET}_shaders")
+    endif()
+    string(MAKE_C_IDENTIFIER "${ARG_NAME}" ARG_NAME)
+
+    if (NOT ARG_OUTPUT)
+        set(ARG_OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/${TARGET}.agipack")
+    endif()
+
+    set(SHADER_FILES)
+    foreach(FILE ${ARG_FILES})
+        get_filename_component(FILE "${FILE}" ABSOLUTE)
+        list(APPEND SHADER_FILES "${FILE}")
+    endforeach()
+
+    set(TEMP_DIR "${CMAKE_CURRENT_BINARY_DIR}/agi_shaders/${TARGET}")
+    set(OUTPUTS "${ARG_OUTPUT}")
+    set(EMBED_ARGS)
+
+    if (ARG_EMBED)
+        set(EMBED_SOURCE "${CMAKE_CURRENT_BINARY_DIR}/agi_shaders/${ARG_NAME}.cpp")
+        set(EMBED_HEADER "${CMAKE_CURRENT_BINARY_DIR}/agi_shaders/${ARG_NAME}.hpp")
+        list(APPEND OUTPUTS "${EMBED_SOURCE}" "${EMBED_HEADER}")
+        set(EMBED_ARGS --embed "${ARG_NAME}" "${EMBED_SOURCE}" "${EMBED_HEADER}")
+    endif()
+
+    # Included files only trigger a rebuild where the generator reads depfiles
+    set(DEPFILE_ARGS)
+    set(DEPFILE_OPTION)
+    if (CMAKE_GENERATOR MATCHES "Ninja" OR (CMAKE_GENERATOR MATCHES "Makefiles" AND CMAKE_VERSION VERSION_GREATER_EQUAL 3.20))
+        set(DEPFILE_ARGS --depfile "${TEMP_DIR}/${TARGET}.d")
+        set(DEPFILE_OPTION DEPFILE "${TEMP_DIR}/${TARGET}.d")
+    endif()
+
+    add_custom_command(
+        OUTPUT ${OUTPUTS}
+        COMMAND agi_shaderc --glslang "${AGI_GLSLANG_VALIDATOR}" --target ${SHADER_TARGET} --temp "${TEMP_DIR}"
+                --output "${ARG_OUTPUT}" ${EMBED_ARGS} ${DEPFILE_ARGS} ${SHADER_FILES}
+        DEPENDS agi_shaderc ${SHADER_FILES}
+        ${DEPFILE_OPTION}
+        COMMENT "Compiling shaders for ${TARGET}"
+        VERBATIM
+    )
+
+    if (ARG_EMBED)
+        target_sources(${TARGET} PRIVATE "${EMBED_SOURCE}")
+        target_include_directories(${TARGET} PRIVATE "${CMAKE_CURRENT_BINARY_DIR}/agi_shaders")
+    else()
+        add_custom_target(${TARGET}_agi_shaders DEPENDS "${ARG_OUTPUT}")
+        add_dependencies(${TARGET} ${TARGET}_agi_shaders)
+
+        get_filename_component(PACK_NAME "${ARG_OUTPUT}" NAME)
+        add_custom_command(TARGET ${TARGET} POST_BUILD
+            COMMAND ${CMAKE_COMMAND} -E copy_if_different "${ARG_OUTPUT}" "$<TARGET_FILE_DIR:${TARGET}>/${PACK_NAME}"
+            VERBATIM
+        )
+    endif()
+endfunction()
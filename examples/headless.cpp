@@ -0,0 +1,103 @@
+#include "utils.hpp"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+static std::string shaderSrc = R"(
+    #type vertex
+    #version 330 core
+			
+    layout(location = 0) in vec3 a_Position;
+
+	out vec3 v_Position;
+
+    void main()
+    {
+		v_Position = a_Position;
+	    gl_Position = vec4(a_Position, 1.0);	
+    }
+
+    #type fragment
+    #version 330 core
+			
+    layout(location = 0) out vec4 color;
+
+	in vec3 v_Position;
+
+    void main()
+    {
+	    color = vec4(v_Position * 0.5 + 0.5, 1.0);
+    }
+)";
+
+int main(void)
+{
+    // Init spdlog for AGI callbacks
+    InitLogging();
+
+    // No GLFW window or display server, everything renders through EGL
+    AGI::Settings settings;
+    settings.PreferedAPI = AGI::APIType::OpenGL;
+    settings.MessageFunc = OnAGIMessage;
+    settings.Headless = true;
+
+    AGI::WindowProps windowProps;
+    windowProps.Title = EXECUTABLE_NAME;
+    windowProps.Size = { 512, 512 };
+
+    auto window = AGI::Window::Create(settings, windowProps);
+    auto context = AGI::RenderContext::Create(window);
+
+    if (!context->Init())
+        return 1;
+
+    float squareVertices[3 * 4] = {
+        -0.5f, -0.5f, 0.0f,
+         0.5f, -0.5f, 0.0f,
+         0.5f,  0.5f, 0.0f,
+        -0.5f,  0.5f, 0.0f
+    };
+
+    uint32_t squareIndices[6] = { 0, 1, 2, 2, 3, 0 };
+
+    AGI::BufferLayout layout = {
+        { AGI::ShaderDataType::Float3, "a_Position" }
+    };
+
+    AGI::VertexArray squareVA = context->CreateVertexArray();
+
+    AGI::VertexBuffer squareVB = context->CreateVertexBuffer(4, layout);
+    squareVB->SetData(squareVertices, sizeof(squareVertices));
+    squareVA->AddVertexBuffer(squareVB);
+
+    AGI::IndexBuffer squareIB = context->CreateIndexBuffer(squareIndices, sizeof(squareIndices) / sizeof(uint32_t));
+    squareVA->SetIndexBuffer(squareIB);
+
+    AGI::Shader shader = context->CreateShader(AGI::Utils::ProcessSource(shaderSrc));
+
+    // Render a single frame and read it back
+    context->SetClearColour({ 0.1f, 0.1f, 0.1f, 1 });
+    context->BeginFrame();
+
+    context->DrawIndexed(squareVA);
+
+    context->EndFrame();
+
+    glm::uvec2 size = window->GetSize();
+    std::vector<uint8_t> pixels(size.x * size.y * 4);
+    context->ReadPixels(0, 0, size.x, size.y, pixels.data());
+
+    // OpenGL rows start at the bottom
+    stbi_flip_vertically_on_write(1);
+    stbi_write_png("headless.png", size.x, size.y, 4, pixels.data(), size.x * 4);
+
+    shader = nullptr;
+    squareIB = nullptr;
+    squareVB = nullptr;
+    squareVA = nullptr;
+
+    context->Shutdown();
+    delete context;
+    
+    return 0;
+}
@@ -52,6 +52,7 @@ int main(void)
     for (int i=0; i<layout.GetSize(); i++)
         AGI_INFO("Attribute #{} \"{}\" (Size: {}) ", i, layout[i].Name, layout[i].Size);
 
+    shader = nullptr;
     context->Shutdown();
     delete context;
     
@@ -87,6 +87,12 @@ int main(void)
         window->PollEvents();
     }
 
+    // Resources report back to their context, so release them first
+    shader = nullptr;
+    squareIB = nullptr;
+    squareVB = nullptr;
+    squareVA = nullptr;
+
     context->Shutdown();
     delete context;
     
@@ -97,6 +97,13 @@ int main(void)
         window->PollEvents();
     }
 
+    // Resources report back to their context, so release them first
+    texture = nullptr;
+    shader = nullptr;
+    squareIB = nullptr;
+    squareVB = nullptr;
+    squareVA = nullptr;
+
     context->Shutdown();
     delete context;
     return 0;
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "MipChain.hpp"
+
+namespace AGI {
+
+	namespace Utils {
+
+		// BC1, BC3, BC4, BC5, ETC2_RGB and ETC2_RGBA
+		bool CanEncode(ImageFormat format);
+
+		// Encodes size.x * size.y texels of tightly packed 8 bit data with 'channels'
+		// channels into GetRegionDatasize() bytes of 'format' at 'output'. Rows of
+		// blocks are shared between 'threads' workers, 0 using every core. Colours
+		// are fitted in whatever space the data is in, sRGB data stays sRGB.
+		bool EncodeBlocks(const void* data, const glm::uvec2& size, uint32_t channels, ImageFormat format, void* output,
+			TextureCompression quality = TextureCompression::Fast, uint32_t threads = 0);
+
+		// Encodes every level of an 8 bit chain, empty when 'format' can't be encoded
+		MipChain EncodeMipChain(const MipChain& chain, uint32_t channels, ImageFormat format,
+			TextureCompression quality = TextureCompression::Fast, uint32_t threads = 0);
+
+	};
+
+}
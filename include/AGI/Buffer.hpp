@@ -6,7 +6,7 @@ namespace AGI {
 
 	enum class ShaderDataType
 	{
-		Float = 0, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+		Float = 0, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool, Unknown
 	};
 
 	namespace Utils {
@@ -26,6 +26,7 @@ namespace AGI {
 			case ShaderDataType::Int3:     return 4 * 3;
 			case ShaderDataType::Int4:     return 4 * 4;
 			case ShaderDataType::Bool:     return 1;
+			case ShaderDataType::Unknown:  return 0;
 			}
 
 			return 0;
@@ -62,6 +63,7 @@ namespace AGI {
 				case ShaderDataType::Int3:    return 3;
 				case ShaderDataType::Int4:    return 4;
 				case ShaderDataType::Bool:    return 1;
+				case ShaderDataType::Unknown: return 0;
 			}
 
 			return 0;
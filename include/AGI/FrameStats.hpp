@@ -0,0 +1,53 @@
+#pragma once
+
+namespace AGI {
+
+	struct FrameStats
+	{
+		uint64_t Frame = 0;
+
+		uint32_t DrawCalls = 0;
+		uint32_t Instances = 0;
+		uint64_t Triangles = 0;
+		uint64_t BytesUploaded = 0;
+
+		uint32_t ShaderBinds = 0;
+		uint32_t TextureBinds = 0;
+		uint32_t SamplerBinds = 0;
+		uint32_t FramebufferSwitches = 0;
+
+		uint32_t ResourcesCreated = 0;
+		uint32_t ResourcesDestroyed = 0;
+
+		uint64_t CpuTime = 0; // Nanoseconds spent inside AGI calls
+	};
+
+	// Adds the lifetime of the scope to FrameStats::CpuTime. Only the outermost
+	// timer on a thread counts, CreateTexture() calling SetData() is one call.
+	class FrameStatsTimer
+	{
+	public:
+		FrameStatsTimer(FrameStats& stats)
+			: m_Stats(stats), m_Outermost(s_Depth++ == 0)
+		{
+			if (m_Outermost) m_Start = std::chrono::steady_clock::now();
+		}
+
+		~FrameStatsTimer()
+		{
+			--s_Depth;
+			if (m_Outermost)
+				m_Stats.CpuTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count();
+		}
+
+		FrameStatsTimer(const FrameStatsTimer&) = delete;
+		FrameStatsTimer& operator=(const FrameStatsTimer&) = delete;
+	private:
+		FrameStats& m_Stats;
+		bool m_Outermost;
+		std::chrono::steady_clock::time_point m_Start;
+
+		static inline thread_local uint32_t s_Depth = 0;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+namespace AGI {
+
+	struct GpuZone
+	{
+		std::string Name;
+		uint64_t Duration = 0; // Nanoseconds
+
+		uint32_t Depth = 0;
+		int32_t Parent = -1; // Index into GpuFrameTimings::Zones, -1 for root zones
+
+		double GetMilliseconds() const { return (double)Duration / 1000000.0; }
+	};
+
+	// Zones are stored in the order they were opened, so every
+	// child zone appears after its parent.
+	struct GpuFrameTimings
+	{
+		uint64_t Frame = 0;
+		std::vector<GpuZone> Zones;
+	};
+
+}
\ No newline at end of file
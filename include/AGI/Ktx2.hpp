@@ -0,0 +1,25 @@
+#pragma once
+
+#include "MipChain.hpp"
+
+namespace AGI {
+
+	// A KTX2 file with every level inflated, ready for RenderContext::CreateTexture()
+	struct Ktx2Image
+	{
+		TextureSpecification Specification; // Data stays nullptr, the levels are in Chain
+		MipChain Chain;
+	};
+
+	namespace Utils {
+
+		// Reads 2D, array, cube and 3D KTX2 files whose vkFormat has a matching
+		// ImageFormat. Zstandard supercompressed levels are inflated here, ZLIB ones
+		// too when AGI was built with zlib. BasisLZ and UASTC need a Basis Universal
+		// transcoder and are rejected, as are 1D textures.
+		bool LoadKtx2(std::span<const uint8_t> data, Ktx2Image& image);
+		bool LoadKtx2(const std::filesystem::path& path, Ktx2Image& image);
+
+	};
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Texture.hpp"
+
+namespace AGI {
+
+	enum class MipFilter
+	{
+		Box = 0, Kaiser
+	};
+
+	struct MipLevel
+	{
+		glm::uvec2 Size;
+		uint32_t Offset = 0;
+		uint32_t Datasize = 0;
+	};
+
+	// Every level of a texture packed back to back, level 0 first
+	struct MipChain
+	{
+		std::vector<uint8_t> Data;
+		std::vector<MipLevel> Levels;
+
+		void* GetData(uint32_t mip) { return Data.data() + Levels[mip].Offset; }
+		const void* GetData(uint32_t mip) const { return Data.data() + Levels[mip].Offset; }
+	};
+
+	namespace Utils {
+
+		// Downsamples every layer in spec.Data into spec.MipLevels levels on the CPU, for 8 bit
+		// and 32 bit float data. Touches no GPU state, so it can run on worker
+		// threads or offline in an asset pipeline. Box averages 2x2 blocks, weighted
+		// by coverage on odd sizes, Kaiser is a windowed sinc that keeps more detail
+		// in the smaller levels. 3D textures are filtered across slices too. With
+		// spec.SRGB set the colour channels are filtered in linear space.
+		MipChain GenerateMipChain(const TextureSpecification& spec, MipFilter filter = MipFilter::Box);
+
+	};
+
+}
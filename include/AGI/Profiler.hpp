@@ -0,0 +1,55 @@
+#pragma once
+
+#include <filesystem>
+
+namespace AGI {
+
+	// CPU profiler backing AGI_PROFILE_SCOPE. Each thread records into its own
+	// buffer without taking locks, the only shared state is the list of
+	// buffers which is touched once per thread. Names must outlive the export,
+	// string literals are expected.
+	class Profiler
+	{
+	public:
+		static uint64_t Now(); // Nanoseconds since the profiler started
+		static void Record(const char* name, uint64_t start, uint64_t end);
+
+		// Chrome trace / Perfetto compatible JSON
+		static std::string ExportChromeTrace();
+		static bool WriteChromeTrace(const std::filesystem::path& path);
+
+		static void Clear();
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name)
+			: m_Name(name), m_Start(Profiler::Now())
+		{
+		}
+
+		~ProfileScope()
+		{
+			Profiler::Record(m_Name, m_Start, Profiler::Now());
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+	private:
+		const char* m_Name;
+		uint64_t m_Start;
+	};
+
+#if defined(AGI_PROFILING)
+	#define AGI_PROFILE_CONCAT_IMPL(x, y) x##y
+	#define AGI_PROFILE_CONCAT(x, y) AGI_PROFILE_CONCAT_IMPL(x, y)
+
+	#define AGI_PROFILE_SCOPE(name) ::AGI::ProfileScope AGI_PROFILE_CONCAT(agiProfileScope, __LINE__)(name)
+	#define AGI_PROFILE_FUNCTION() AGI_PROFILE_SCOPE(__func__)
+#else
+	#define AGI_PROFILE_SCOPE(name)
+	#define AGI_PROFILE_FUNCTION()
+#endif
+
+}
\ No newline at end of file
@@ -4,8 +4,13 @@
 #include "Framebuffer.hpp"
 #include "Shader.hpp"
 #include "Texture.hpp"
+#include "Sampler.hpp"
+#include "Ktx2.hpp"
 #include "VertexArray.hpp"
 #include "Log.hpp"
+#include "GpuProfiler.hpp"
+#include "FrameStats.hpp"
+#include "ResourceCache.hpp"
 
 #include "Settings.hpp"
 #include "Window.hpp"
@@ -30,18 +35,68 @@ namespace AGI {
 		virtual void SetClearColour(const glm::vec4& colour) = 0;
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
 
+		// Reads RGBA8 pixels back from the default framebuffer, mainly for headless contexts.
+		// Vulkan reads the last presented frame and needs Settings::FrameReadback.
+		virtual void ReadPixels(uint32_t x, uint32_t y, uint32_t width, uint32_t height, void* data) = 0;
+
+		// GPU profiling, ignored unless Settings::GpuProfiling is set
+		virtual void BeginGpuZone(std::string_view name) = 0;
+		virtual void EndGpuZone() = 0;
+
 		// Creation functions
 		virtual VertexBuffer CreateVertexBuffer(uint32_t vertices, const BufferLayout& layout) = 0;
+		virtual VertexBuffer CreateVertexBuffer(const void* vertices, uint32_t size, const BufferLayout& layout) = 0;
 		virtual IndexBuffer CreateIndexBuffer(uint32_t* indices, uint32_t size) = 0;
 		virtual Framebuffer CreateFramebuffer(const FramebufferSpecification& spec) = 0;
 		virtual Shader CreateShader(const ShaderSources& shaderSources) = 0;
+		virtual Shader CreateShaderAsync(const ShaderSources& shaderSources) = 0;
+		virtual Shader CreateShader(const ShaderBinaries& binaries, const SpecializationConstants& constants = {}) = 0;
 		virtual Texture CreateTexture(const TextureSpecification& spec) = 0;
 		virtual VertexArray CreateVertexArray() = 0;
+
+		// Always shared, equal specifications return the live sampler
+		virtual Sampler CreateSampler(const SamplerSpecification& spec) = 0;
+
+		// Asynchronous texture uploads. Data is nullptr when the staging ring can't
+		// fit 'size' without waiting for uploads that are still being filled.
+		virtual TextureUpload AllocateUpload(uint32_t size) = 0;
+		virtual bool IsUploadComplete(const TextureUpload& upload) = 0;
+
+		// Gives back an upload that won't be passed to SetData(), the ring can't reuse it otherwise
+		virtual void DiscardUpload(const TextureUpload& upload) = 0;
+
+		// Whether textures of 'format' can be created and sampled
+		virtual bool IsFormatSupported(ImageFormat format) const = 0;
+
+		// Whether textures hand out bindless handles, needs Settings::BindlessTextures
+		virtual bool IsBindlessSupported() const = 0;
+
+		// First supported format out of 'candidates', RGBA when none are
+		ImageFormat ChooseFormat(std::initializer_list<ImageFormat> candidates) const;
+
+		// Uploads every level of a loaded KTX2 file, nullptr when its format isn't supported
+		Texture CreateTexture(const Ktx2Image& image);
 		
 		APIType GetType() const { return m_Settings.PreferedAPI; }
 		Window* GetBoundWindow() const { return m_BoundWindow; }
 		const ContextProperties& GetProps() const { return m_Properties; }
 
+		// Timings arrive a few frames after they were recorded
+		const GpuFrameTimings& GetGpuTimings() const { return m_GpuTimings; }
+
+		// Stats of a completed frame, 0 being the most recent one
+		FrameStats GetFrameStats(uint32_t framesAgo = 0) const;
+		FrameStats& GetCurrentFrameStats() { return *m_CurrentStats; }
+
+		// Resources report through this, so releasing one after the context is gone is safe
+		const std::shared_ptr<FrameStats>& GetSharedFrameStats() const { return m_CurrentStats; }
+
+		// Only counts while Settings::ShaderCacheDirectory is set
+		const ShaderCacheStats& GetShaderCacheStats() const { return m_ShaderCacheStats; }
+
+		// Only counts while Settings::DeduplicateResources is set
+		ResourceCacheStats GetResourceCacheStats() const { return m_ResourceCache->GetStats(); }
+
 		void PrintProperties()
 		{
 			const char* apiType = "";
@@ -60,6 +115,19 @@ namespace AGI {
 		Window* m_BoundWindow;
 		Settings m_Settings;
 		ContextProperties m_Properties;
+		GpuFrameTimings m_GpuTimings;
+		ShaderCacheStats m_ShaderCacheStats;
+		std::shared_ptr<ResourceCache> m_ResourceCache = std::make_shared<ResourceCache>(); // Outlives the context while resources are tracked
+
+		// Encodes spec.Data on the CPU, see TextureSpecification::Compression
+		Texture CreateCompressedTexture(const TextureSpecification& spec);
+
+		// Rolls m_CurrentStats into the history, called by backends at the start of BeginFrame()
+		void SubmitFrameStats();
+
+		std::shared_ptr<FrameStats> m_CurrentStats = std::make_shared<FrameStats>();
+		std::vector<FrameStats> m_StatsHistory;
+		uint64_t m_StatsFrame = 0;
 	private:
 		using ContextFactoryFn = std::function<RenderContext* ()>;
 		static inline std::array<ContextFactoryFn, static_cast<size_t>(APIType::__COUNT)> s_ContextFactory = {};
@@ -4,26 +4,80 @@
 
 namespace AGI {
 
+    class RefCounted;
+
+    // Hands out resources without owning them, tracked resources untrack themselves when they die or change.
+    // Tracked resources share ownership of the cache, so they can still untrack after their context is gone.
+    class ResourceCacheBase : public std::enable_shared_from_this<ResourceCacheBase>
+    {
+    public:
+        virtual ~ResourceCacheBase() = default;
+        virtual void Untrack(uint64_t key, const RefCounted* resource) = 0;
+    protected:
+        void Track(const RefCounted* resource, uint64_t key);
+    };
+
     class RefCounted
     {
     public:
-        virtual ~RefCounted() = default;
+        virtual ~RefCounted()
+        {
+            // ResourceBarrier already detached it, unless it was deleted by hand
+            DetachFromCache();
+        }
 
         void IncRefCount() const
         {
             ++m_RefCount;
         }
-        void DecRefCount() const
+        // Returns the new count
+        uint32_t DecRefCount() const
+        {
+            return --m_RefCount;
+        }
+
+        // Fails once the count reached zero, the resource is being destroyed then
+        bool TryIncRefCount() const
         {
-            --m_RefCount;
+            uint32_t count = m_RefCount.load();
+            while (count != 0)
+            {
+                if (m_RefCount.compare_exchange_weak(count, count + 1))
+                    return true;
+            }
+
+            return false;
         }
 
         uint32_t GetRefCount() const { return m_RefCount.load(); }
 
+    protected:
+        // Call before changing contents, so equal requests stop getting this resource
+        void DetachFromCache() const
+        {
+            if (!m_Cache) return;
+
+            m_Cache->Untrack(m_CacheKey, this);
+            m_Cache = nullptr;
+        }
+
     private:
         mutable std::atomic<uint32_t> m_RefCount = 0;
+
+        mutable std::shared_ptr<ResourceCacheBase> m_Cache;
+        mutable uint64_t m_CacheKey = 0;
+
+        friend class ResourceCacheBase;
+        template <typename T>
+        friend class ResourceBarrier;
     };
 
+    inline void ResourceCacheBase::Track(const RefCounted* resource, uint64_t key)
+    {
+        resource->m_Cache = shared_from_this();
+        resource->m_CacheKey = key;
+    }
+
     template <typename T>
     class ResourceBarrier
     {
@@ -35,7 +89,7 @@ namespace AGI {
         {
         }
 
-        ResourceBarrier(std::nullptr_t n)
+        ResourceBarrier(std::nullptr_t)
             : m_Instance(nullptr)
         {
         }
@@ -164,13 +218,15 @@ namespace AGI {
         {
             if (m_Instance)
             {
-                m_Instance->DecRefCount();
-
-                if (m_Instance->GetRefCount() == 0)
+                // Only the thread that took the count to zero may delete, and the
+                // cache has to forget the resource before any of it is destroyed
+                if (m_Instance->DecRefCount() == 0)
                 {
+                    m_Instance->DetachFromCache();
                     delete m_Instance;
-                    m_Instance = nullptr;
                 }
+
+                m_Instance = nullptr;
             }
         }
 
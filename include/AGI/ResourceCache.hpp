@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "Shader.hpp"
+#include "Texture.hpp"
+#include "Sampler.hpp"
+
+namespace AGI {
+
+	struct ResourceCacheStats
+	{
+		uint32_t ShaderHits = 0;
+		uint32_t TextureHits = 0;
+		uint32_t BufferHits = 0;
+		uint32_t SamplerHits = 0;
+		uint32_t Misses = 0;
+
+		uint64_t BytesSaved = 0; // Source, SPIR-V, pixel and buffer bytes that weren't uploaded again
+	};
+
+	namespace Utils {
+
+		// XXH64, fast enough to hash texture data on every upload
+		uint64_t HashData(const void* data, size_t size, uint64_t seed = 0);
+
+	};
+
+	// Maps the contents a resource was created from to the live resource, so
+	// creating something equal returns the existing handle. Entries don't keep
+	// resources alive and are dropped as soon as a resource dies or its
+	// contents change through SetData() or Reload(). Only enabled through
+	// Settings::DeduplicateResources, everything is created normally otherwise,
+	// except samplers. They can't change, so equal ones are always shared.
+	class ResourceCache : public ResourceCacheBase
+	{
+	public:
+		enum class Kind : uint8_t
+		{
+			Shader = 0, Texture, Buffer, Sampler
+		};
+
+		static uint64_t GetKey(const ShaderSources& sources);
+		static uint64_t GetKey(const ShaderBinaries& binaries, const SpecializationConstants& constants);
+		static uint64_t GetKey(const TextureSpecification& spec);
+		static uint64_t GetKey(const void* vertices, uint32_t size, const BufferLayout& layout);
+		static uint64_t GetKey(const uint32_t* indices, uint32_t count);
+		static uint64_t GetKey(const SamplerSpecification& spec);
+
+		void SetEnabled(bool enabled) { m_Enabled = enabled; }
+		bool IsEnabled() const { return m_Enabled; }
+
+		// 'bytes' is what a hit saves, 'create' only runs on a miss. Check
+		// IsEnabled() first, disabled contexts shouldn't pay for hashing.
+		template<typename T, typename CreateFn>
+		ResourceBarrier<T> GetOrCreate(Kind kind, uint64_t key, uint64_t bytes, CreateFn&& create)
+		{
+			return GetOrCreate<T>(kind, key, bytes, std::forward<CreateFn>(create), [](const T&) { return true; });
+		}
+
+		// 'matches' confirms a hit for keys that are cheap enough to compare
+		// in full, a hash collision is then created separately
+		template<typename T, typename CreateFn, typename MatchFn>
+		ResourceBarrier<T> GetOrCreate(Kind kind, uint64_t key, uint64_t bytes, CreateFn&& create, MatchFn&& matches)
+		{
+			{
+				std::lock_guard lock(m_Mutex);
+
+				// Entries are untracked before deletion, so anything found here is still alive,
+				// but its last handle may be going away on another thread
+				auto it = m_Entries.find(key);
+				if (it != m_Entries.end() && matches(*static_cast<const T*>(it->second)))
+				{
+					const RefCounted* cached = it->second;
+					if (cached->TryIncRefCount())
+					{
+						RecordHit(kind, bytes);
+
+						// Hand the reference taken above over to the handle
+						ResourceBarrier<T> resource(static_cast<T*>(const_cast<RefCounted*>(cached)));
+						cached->DecRefCount();
+						return resource;
+					}
+
+					// Dying, make room for the replacement
+					m_Entries.erase(it);
+				}
+
+				m_Stats.Misses++;
+			}
+
+			// Not locked while creating, a resource that dies in there would deadlock Untrack()
+			ResourceBarrier<T> resource = create();
+			if (!resource) return resource;
+
+			std::lock_guard lock(m_Mutex);
+			if (m_Entries.try_emplace(key, resource.Raw()).second)
+				Track(resource.Raw(), key);
+
+			return resource;
+		}
+
+		virtual void Untrack(uint64_t key, const RefCounted* resource) override;
+
+		ResourceCacheStats GetStats() const;
+		uint32_t GetEntryCount() const;
+	private:
+		void RecordHit(Kind kind, uint64_t bytes);
+	private:
+		bool m_Enabled = false;
+
+		mutable std::mutex m_Mutex;
+		std::unordered_map<uint64_t, const RefCounted*> m_Entries;
+		ResourceCacheStats m_Stats;
+	};
+
+}
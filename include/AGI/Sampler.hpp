@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Texture.hpp"
+
+namespace AGI {
+
+	enum class FilterMode
+	{
+		Nearest = 0, Linear
+	};
+
+	// None only ever samples the base level
+	enum class MipmapMode
+	{
+		None = 0, Nearest, Linear
+	};
+
+	// Compares against the depth stored in the texture, for shadow maps
+	enum class CompareFunction
+	{
+		None = 0, Never, Less, Equal, LessEqual, Greater, NotEqual, GreaterEqual, Always
+	};
+
+	struct SamplerSpecification
+	{
+		FilterMode MinFilter = FilterMode::Linear;
+		FilterMode MagFilter = FilterMode::Linear;
+		MipmapMode MipMode = MipmapMode::Linear;
+
+		// Clamped to what the driver supports, 1 disables anisotropic filtering
+		float Anisotropy = 1.0f;
+
+		WrappingType WrapU = WrappingType::Repeat;
+		WrappingType WrapV = WrappingType::Repeat;
+		WrappingType WrapW = WrappingType::Repeat;
+
+		CompareFunction Compare = CompareFunction::None;
+
+		// Read outside ClampBorder textures. Vulkan rounds it to transparent
+		// black, opaque black or opaque white.
+		glm::vec4 BorderColour = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		float MinLod = 0.0f;
+		float MaxLod = 1000.0f;
+		float LodBias = 0.0f;
+
+		bool operator==(const SamplerSpecification&) const = default;
+	};
+
+	namespace Utils {
+
+		// The sampling state a texture keeps for itself
+		SamplerSpecification GetSamplerSpecification(const TextureSpecification& spec);
+
+	};
+
+	// Sampling state that lives apart from textures, so one texture can be
+	// sampled in several ways. Samplers can't change after creation and the
+	// context hands out the same one for equal specifications.
+	class SamplerBase : public RefCounted
+	{
+	public:
+		virtual ~SamplerBase() = default;
+
+		virtual const SamplerSpecification& GetSpecification() const = 0;
+		virtual uint32_t GetRendererID() const = 0;
+
+		// Replaces the state of any texture bound to 'slot' until unbound
+		virtual void Bind(uint32_t slot = 0) const = 0;
+		virtual void Unbind(uint32_t slot = 0) const = 0;
+	};
+
+	using Sampler = ResourceBarrier<SamplerBase>;
+
+}
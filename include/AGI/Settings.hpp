@@ -51,6 +51,29 @@ namespace AGI {
 		bool EnableValidation = true;
 		bool ShareResources = true;
 		bool Blending = false;
+		bool GpuProfiling = false;
+		uint32_t FrameStatsHistory = 120;
+
+		// OpenGL only, renders offscreen through EGL without GLFW or a display server
+		bool Headless = false;
+
+		// Vulkan only, copies every presented frame so ReadPixels() can read it back
+		bool FrameReadback = false;
+
+		// Linked programs are cached here between runs, empty disables the cache
+		std::filesystem::path ShaderCacheDirectory;
+
+		// Creating a shader, texture or buffer from the same contents as a live one
+		// returns that one instead, so SetData() and Reload() affect every owner
+		bool DeduplicateResources = false;
+
+		// Staging memory shared by all asynchronous texture uploads
+		uint32_t UploadRingSize = 32 * 1024 * 1024;
+
+		// Lets textures hand out Texture::GetBindlessHandle(), through GL_ARB_bindless_texture
+		// or a descriptor indexing table with room for BindlessTableSize textures on Vulkan
+		bool BindlessTextures = false;
+		uint32_t BindlessTableSize = 16384;
 	};
 
 	APIType BestAPI();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ShaderReflection.hpp"
+
 #include <glm/glm.hpp>
 
 namespace AGI {
@@ -17,6 +19,53 @@ namespace AGI {
 
 	using ShaderSources = std::unordered_map<ShaderType, std::string>;
 
+	// Precompiled SPIR-V, one module per stage with "main" as the entry point
+	using ShaderBinaries = std::unordered_map<ShaderType, std::vector<uint32_t>>;
+
+	struct SpecializationConstant
+	{
+		uint32_t ID = 0;    // layout(constant_id = ...) in GLSL
+		uint32_t Value = 0; // Raw bits, std::bit_cast floats into this
+	};
+
+	using SpecializationConstants = std::vector<SpecializationConstant>;
+
+	struct ShaderCacheStats
+	{
+		uint32_t Hits = 0;
+		uint32_t Misses = 0;
+		uint32_t Rejected = 0; // Entries the driver refused, also counted as misses
+	};
+
+	namespace Utils {
+
+		// FNV-1a, usable at compile time so uniform names can be hashed ahead of time
+		constexpr UniformID HashUniformName(std::string_view name)
+		{
+			UniformID hash = 2166136261u;
+			for (char c : name)
+			{
+				hash ^= (uint8_t)c;
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+
+		// 64-bit FNV-1a for cache keys over shader sources, chain calls through 'hash'
+		constexpr uint64_t HashShaderSource(std::string_view data, uint64_t hash = 14695981039346656037ull)
+		{
+			for (char c : data)
+			{
+				hash ^= (uint8_t)c;
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+	};
+
 	class ShaderBase : public RefCounted
 	{
 	public:
@@ -25,22 +74,51 @@ namespace AGI {
 		virtual void Bind() = 0;
 		virtual void Unbind() = 0;
 
-		virtual BufferLayout GetLayout() const = 0;
+		// False while an async shader is still compiling, using it before then waits for the driver
+		virtual bool IsReady() = 0;
+
+		// Compiles 'sources' in the background while the current program keeps being used.
+		// The context swaps it in at the start of a frame once it links, on failure the
+		// errors are logged and the old program stays. References from GetReflection()
+		// don't survive the swap.
+		virtual bool Reload(const ShaderSources& sources) = 0;
+		virtual bool IsReloading() const = 0;
+
+		// Reflected once after linking, cheap to call
+		virtual const BufferLayout& GetLayout() const = 0;
+		virtual const ShaderReflection& GetReflection() const = 0;
 		virtual bool AttributeExists(const std::string& name) const = 0;
 
-		virtual void SetInt(const std::string& name, int value) = 0;
-		virtual void SetIntArray(const std::string& name, int* values, uint32_t count) = 0;
-		virtual void SetFloat(const std::string& name, float value) = 0;
-		virtual void SetFloat2(const std::string& name, const glm::vec2& value) = 0;
-		virtual void SetFloat3(const std::string& name, const glm::vec3& value) = 0;
-		virtual void SetFloat4(const std::string& name, const glm::vec4& value) = 0;
-		virtual void SetMat3(const std::string& name, const glm::mat3& matrix) = 0;
-		virtual void SetMat4(const std::string& name, const glm::mat4& value) = 0;
+		// String literals are hashed at compile time, keep the result around for per-frame sets
+		template<size_t N>
+		static consteval UniformID GetUniformID(const char(&name)[N]) { return Utils::HashUniformName(std::string_view(name, N - 1)); }
+		static UniformID GetUniformID(std::string_view name) { return Utils::HashUniformName(name); }
+
+		virtual void SetInt(UniformID id, int value) = 0;
+		virtual void SetIntArray(UniformID id, int* values, uint32_t count) = 0;
+		virtual void SetFloat(UniformID id, float value) = 0;
+		virtual void SetFloat2(UniformID id, const glm::vec2& value) = 0;
+		virtual void SetFloat3(UniformID id, const glm::vec3& value) = 0;
+		virtual void SetFloat4(UniformID id, const glm::vec4& value) = 0;
+		virtual void SetMat3(UniformID id, const glm::mat3& matrix) = 0;
+		virtual void SetMat4(UniformID id, const glm::mat4& value) = 0;
+
+		void SetInt(const std::string& name, int value)                         { SetInt(GetUniformID(name), value); }
+		void SetIntArray(const std::string& name, int* values, uint32_t count)  { SetIntArray(GetUniformID(name), values, count); }
+		void SetFloat(const std::string& name, float value)                     { SetFloat(GetUniformID(name), value); }
+		void SetFloat2(const std::string& name, const glm::vec2& value)         { SetFloat2(GetUniformID(name), value); }
+		void SetFloat3(const std::string& name, const glm::vec3& value)         { SetFloat3(GetUniformID(name), value); }
+		void SetFloat4(const std::string& name, const glm::vec4& value)         { SetFloat4(GetUniformID(name), value); }
+		void SetMat3(const std::string& name, const glm::mat3& matrix)          { SetMat3(GetUniformID(name), matrix); }
+		void SetMat4(const std::string& name, const glm::mat4& value)           { SetMat4(GetUniformID(name), value); }
 	};
 
 	namespace Utils {
 
-		ShaderSources ProcessSource(const std::string& source);
+		ShaderSources ProcessSource(std::string_view source);
+
+		// Empty when the file can't be read or isn't SPIR-V
+		std::vector<uint32_t> LoadSpirv(const std::filesystem::path& path);
 
 	};
 
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ShaderPreprocessor.hpp"
+
+#include <thread>
+#include <condition_variable>
+#include <deque>
+
+namespace AGI {
+
+	class RenderContext;
+
+	// One bit per toggle, or enough bits to index a multi-keyword axis
+	using ShaderVariantKey = uint64_t;
+
+	// A single keyword is an on/off toggle. With several keywords exactly one of
+	// them is defined, the first one when the key doesn't mention the axis.
+	using ShaderKeywordAxis = std::vector<std::string>;
+
+	// Compiles permutations of one '#type' source on demand. Every variant is
+	// preprocessed with its keywords '#define'd and compiled the first time its
+	// key is requested, then reused. All functions are safe to call from any
+	// thread, but Get() and Update() create resources and so follow the same
+	// threading rules as the render context. Prewarm() preprocesses on a worker
+	// thread and Update() hands the results to the driver asynchronously.
+	class ShaderLibrary
+	{
+	public:
+		ShaderLibrary(RenderContext* context, std::string source, std::vector<ShaderKeywordAxis> axes, ShaderFileProvider provider = nullptr);
+		~ShaderLibrary();
+
+		ShaderLibrary(const ShaderLibrary&) = delete;
+		ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+		// Unknown keywords are reported and ignored
+		ShaderVariantKey GetKey(std::initializer_list<std::string_view> keywords) const;
+		ShaderVariantKey GetKey(std::span<const std::string_view> keywords) const;
+
+		Shader Get(ShaderVariantKey key);
+		Shader Get(std::initializer_list<std::string_view> keywords) { return Get(GetKey(keywords)); }
+
+		void Prewarm(std::span<const ShaderVariantKey> keys);
+		void Prewarm(std::initializer_list<ShaderVariantKey> keys) { Prewarm(std::span<const ShaderVariantKey>(keys.begin(), keys.size())); }
+
+		// Creates prewarmed variants that finished preprocessing, call once a frame
+		void Update();
+
+		bool HasVariant(ShaderVariantKey key) const;
+		uint32_t GetVariantCount() const;
+
+		// Drops all compiled variants, they are recompiled on the next request
+		void Clear();
+	private:
+		struct Axis
+		{
+			std::vector<std::string> Keywords;
+			uint32_t Shift = 0;
+			uint32_t Bits = 0;
+		};
+
+		bool IsValidKey(ShaderVariantKey key) const;
+		ShaderDefines GetDefines(ShaderVariantKey key) const;
+		ShaderSources Preprocess(ShaderVariantKey key);
+
+		void WorkerLoop();
+	private:
+		RenderContext* m_Context;
+		std::string m_Source;
+		std::vector<Axis> m_Axes;
+
+		ShaderPreprocessor m_Preprocessor;
+		std::mutex m_PreprocessorMutex;
+
+		// m_CreateMutex serialises resource creation so a variant is only ever
+		// compiled once, m_Mutex guards the containers and is never held for long
+		std::mutex m_CreateMutex;
+		mutable std::mutex m_Mutex;
+		std::unordered_map<ShaderVariantKey, Shader> m_Variants;
+		std::unordered_map<ShaderVariantKey, ShaderSources> m_Prepared;
+
+		std::thread m_Worker;
+		std::condition_variable m_WorkerWake;
+		std::deque<ShaderVariantKey> m_PrewarmQueue;
+		bool m_StopWorker = false;
+	};
+
+}
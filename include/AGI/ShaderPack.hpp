@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Shader.hpp"
+#include "ShaderPackFormat.hpp"
+
+namespace AGI {
+
+	// Read-only view over a pack built by agi_add_shaders(). Lookups binary search
+	// the index and copy the SPIR-V out, nothing gets parsed or compiled from text.
+	class ShaderPack
+	{
+	public:
+		ShaderPack() = default;
+
+		// Doesn't copy, 'data' has to outlive the pack (embedded packs are static)
+		ShaderPack(std::span<const uint32_t> data);
+		ShaderPack(const std::filesystem::path& path);
+
+		// The views point into m_Storage, a copy would keep pointing at the original
+		ShaderPack(const ShaderPack&) = delete;
+		ShaderPack& operator=(const ShaderPack&) = delete;
+		ShaderPack(ShaderPack&& other) noexcept;
+		ShaderPack& operator=(ShaderPack&& other) noexcept;
+
+		bool IsValid() const { return m_Header != nullptr; }
+		ShaderPackFormat::Target GetTarget() const { return m_Header ? m_Header->API : ShaderPackFormat::Target::OpenGL; }
+
+		bool Contains(std::string_view name) const;
+		std::vector<std::string_view> GetNames() const;
+
+		// Empty when the pack doesn't have a shader called 'name'
+		ShaderBinaries GetBinaries(std::string_view name) const;
+	private:
+		bool Validate();
+		std::string_view GetName(const ShaderPackFormat::Entry& entry) const;
+		std::span<const ShaderPackFormat::Entry> FindEntries(std::string_view name) const;
+	private:
+		std::vector<uint32_t> m_Storage; // Only used when loaded from a file
+		std::span<const uint32_t> m_Data;
+
+		const ShaderPackFormat::Header* m_Header = nullptr;
+		std::span<const ShaderPackFormat::Entry> m_Entries;
+		std::string_view m_Names;
+		std::span<const uint32_t> m_Code;
+	};
+
+}
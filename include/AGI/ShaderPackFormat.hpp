@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of shader packs written by agi_shaderc, kept free of other
+// AGI headers so the build-time tool can share it. Everything is 32-bit words:
+// header, entries sorted by name then stage, the name table (padded to a
+// word) and finally the SPIR-V code.
+namespace AGI::ShaderPackFormat {
+
+	constexpr uint32_t Magic = 0x50494741; // "AGIP"
+	constexpr uint32_t Version = 1;
+
+	enum class Target : uint32_t
+	{
+		OpenGL = 0, Vulkan
+	};
+
+	// Matches AGI::ShaderType
+	enum class Stage : uint32_t
+	{
+		Vertex = 1, Fragment = 2
+	};
+
+	struct Header
+	{
+		uint32_t Magic = ShaderPackFormat::Magic;
+		uint32_t Version = ShaderPackFormat::Version;
+		Target API = Target::OpenGL;
+		uint32_t EntryCount = 0;
+		uint32_t NameWords = 0; // Size of the name table in words
+	};
+
+	struct Entry
+	{
+		uint32_t NameOffset = 0; // Bytes into the name table
+		uint32_t NameLength = 0;
+		Stage Type = Stage::Vertex;
+		uint32_t CodeOffset = 0; // Words from the start of the code section
+		uint32_t CodeWords = 0;
+	};
+
+}
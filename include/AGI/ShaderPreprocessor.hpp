@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Shader.hpp"
+
+#include <filesystem>
+
+namespace AGI {
+
+	// Fills 'contents' and returns true when 'path' exists
+	using ShaderFileProvider = std::function<bool(std::string_view path, std::string& contents)>;
+	using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+	// Splits '#type' stages like Utils::ProcessSource and additionally resolves
+	// '#include "file"' through a file provider, injects '#define's after
+	// '#version' and emits '#line <line> <source>' so driver errors point at the
+	// right file. Scanning works on views into the cached file contents, and a
+	// result is reused as long as none of the files it touched changed.
+	class ShaderPreprocessor
+	{
+	public:
+		ShaderPreprocessor(ShaderFileProvider provider = nullptr);
+
+		// 'dependencies' receives 'path' and every file it included, for watching them
+		ShaderSources ProcessFile(std::string_view path, const ShaderDefines& defines = {}, std::vector<std::string>* dependencies = nullptr);
+		ShaderSources Process(std::string_view source, const ShaderDefines& defines = {});
+
+		// Source number used in the '#line' directives, 0 is the top level source
+		std::string_view GetSourceName(uint32_t index) const;
+
+		uint32_t GetCacheHits() const { return m_CacheHits; }
+		uint32_t GetCacheMisses() const { return m_CacheMisses; }
+
+		static ShaderFileProvider FilesystemProvider(const std::filesystem::path& root);
+	private:
+		static constexpr size_t s_MaxResults = 256; // The least recently used one is dropped beyond this
+
+		struct CachedFile
+		{
+			std::string Storage;
+			std::string_view Contents;
+			uint64_t Hash = 0;
+			uint32_t SourceIndex = 0;
+			bool PragmaOnce = false;
+		};
+
+		struct CachedResult
+		{
+			ShaderSources Sources;
+			std::vector<std::pair<std::string, uint64_t>> Dependencies;
+			uint64_t LastUse = 0;
+		};
+
+		struct ExpandState
+		{
+			std::unordered_map<std::string, const CachedFile*> Loaded;
+			std::string Output;
+			std::vector<const CachedFile*> Stack;
+			std::vector<const CachedFile*> Included;
+			std::vector<std::pair<std::string, uint64_t>> Dependencies;
+		};
+
+		const CachedFile* LoadFile(const std::string& path);
+		const CachedFile* LoadFile(const std::string& path, ExpandState& state);
+		ShaderSources Split(const CachedFile& root, const ShaderDefines& defines, ExpandState& state);
+		void Expand(const CachedFile& file, std::string_view path, std::string_view text, uint32_t firstLine, const ShaderDefines* defines, ExpandState& state);
+		uint64_t GetResultKey(const CachedFile& root, const ShaderDefines& defines) const;
+	private:
+		ShaderFileProvider m_Provider;
+
+		std::unordered_map<std::string, CachedFile> m_Files;
+		std::unordered_map<uint64_t, CachedResult> m_Results;
+		uint64_t m_ResultUses = 0;
+		std::vector<std::string> m_SourceNames;
+
+		uint32_t m_CacheHits = 0;
+		uint32_t m_CacheMisses = 0;
+	};
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Buffer.hpp"
+
+namespace AGI {
+
+	using UniformID = uint32_t;
+
+	enum class SamplerType
+	{
+		Sampler1D = 0, Sampler2D, Sampler3D, SamplerCube, Sampler2DArray, SamplerCubeArray, SamplerBuffer, Unknown
+	};
+
+	struct ShaderAttribute
+	{
+		std::string Name;
+		ShaderDataType Type = ShaderDataType::Unknown;
+		uint32_t Location = 0;
+	};
+
+	// Uniforms outside of any block, only plain GLSL has these
+	struct ShaderUniform
+	{
+		std::string Name;
+		UniformID ID = 0;
+		ShaderDataType Type = ShaderDataType::Unknown;
+		int32_t Location = -1;
+		uint32_t ArraySize = 1;
+	};
+
+	struct ShaderBlockMember
+	{
+		std::string Name;
+		ShaderDataType Type = ShaderDataType::Unknown;
+		uint32_t Offset = 0;
+		uint32_t Size = 0; // Whole array for arrays, 0 for runtime arrays
+		uint32_t ArraySize = 1;
+		uint32_t ArrayStride = 0;
+	};
+
+	// Uniform or storage block, offsets follow the block's declared layout
+	struct ShaderBlock
+	{
+		std::string Name;
+		uint32_t Binding = 0;
+		uint32_t Set = 0;
+		uint32_t Size = 0;
+		std::vector<ShaderBlockMember> Members;
+
+		const ShaderBlockMember* FindMember(std::string_view name) const
+		{
+			for (const auto& member : Members)
+				if (member.Name == name) return &member;
+
+			return nullptr;
+		}
+	};
+
+	struct ShaderSampler
+	{
+		std::string Name;
+		UniformID ID = 0;
+		SamplerType Type = SamplerType::Unknown;
+		int32_t Location = -1;
+		uint32_t Binding = 0; // Texture unit on OpenGL
+		uint32_t Set = 0;
+		uint32_t ArraySize = 1;
+	};
+
+	// Everything a linked shader exposes, built once by the backend and never
+	// changed afterwards. Attributes are sorted by location, so GetLayout()
+	// matches what a vertex buffer for this shader needs.
+	class ShaderReflection
+	{
+	public:
+		ShaderReflection() = default;
+		ShaderReflection(std::vector<ShaderAttribute> attributes, std::vector<ShaderUniform> uniforms, std::vector<ShaderBlock> uniformBlocks,
+			std::vector<ShaderBlock> storageBlocks, std::vector<ShaderSampler> samplers);
+
+		const BufferLayout& GetLayout() const { return m_Layout; }
+
+		const std::vector<ShaderAttribute>& GetAttributes() const { return m_Attributes; }
+		const std::vector<ShaderUniform>& GetUniforms() const { return m_Uniforms; }
+		const std::vector<ShaderBlock>& GetUniformBlocks() const { return m_UniformBlocks; }
+		const std::vector<ShaderBlock>& GetStorageBlocks() const { return m_StorageBlocks; }
+		const std::vector<ShaderSampler>& GetSamplers() const { return m_Samplers; }
+
+		// nullptr when the shader doesn't have it
+		const ShaderAttribute* FindAttribute(std::string_view name) const;
+		const ShaderUniform* FindUniform(UniformID id) const;
+		const ShaderBlock* FindUniformBlock(std::string_view name) const;
+		const ShaderBlock* FindStorageBlock(std::string_view name) const;
+		const ShaderSampler* FindSampler(UniformID id) const;
+	private:
+		std::vector<ShaderAttribute> m_Attributes;
+		std::vector<ShaderUniform> m_Uniforms;
+		std::vector<ShaderBlock> m_UniformBlocks;
+		std::vector<ShaderBlock> m_StorageBlocks;
+		std::vector<ShaderSampler> m_Samplers;
+
+		BufferLayout m_Layout;
+	};
+
+	namespace Utils {
+
+		// Reflects SPIR-V modules, one per stage. Vertex inputs become attributes and
+		// resources used by several stages are merged by set and binding.
+		ShaderReflection ReflectSpirv(const std::vector<std::span<const uint32_t>>& modules);
+
+		// constant_id values a module declares
+		std::vector<uint32_t> GetSpirvSpecializationIDs(std::span<const uint32_t> module);
+
+	};
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ShaderPreprocessor.hpp"
+
+namespace AGI {
+
+	class RenderContext;
+
+	// Recompiles shaders when their file or anything they include changes on disk.
+	// Poll() never blocks: edits are picked up through inotify, the new sources
+	// are handed to Shader::Reload() and the context swaps them in between frames
+	// once they link. Broken edits are logged and the old program keeps running.
+	// Only implemented on Linux, elsewhere shaders load but are never reloaded.
+	class ShaderWatcher
+	{
+	public:
+		ShaderWatcher(RenderContext* context, const std::filesystem::path& root = {});
+		~ShaderWatcher();
+
+		ShaderWatcher(const ShaderWatcher&) = delete;
+		ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+		// Preprocesses and creates the shader, then keeps it up to date
+		Shader Load(std::string_view path, const ShaderDefines& defines = {});
+		void Unwatch(const Shader& shader);
+
+		// Call once per frame, returns the number of reloads started
+		uint32_t Poll();
+
+		bool IsSupported() const { return m_Handle != -1; }
+	private:
+		struct WatchedShader
+		{
+			Shader Handle;
+			std::string Path;
+			ShaderDefines Defines;
+			std::vector<std::string> Dependencies;
+		};
+
+		void WatchFiles(const std::vector<std::string>& files);
+	private:
+		RenderContext* m_Context;
+		std::filesystem::path m_Root;
+		ShaderPreprocessor m_Preprocessor;
+
+		std::vector<WatchedShader> m_Shaders;
+		std::unordered_map<int, std::filesystem::path> m_Directories; // inotify watch -> directory
+		int m_Handle = -1;
+	};
+
+}
@@ -4,7 +4,13 @@ namespace AGI {
 
 	enum class ImageFormat
 	{
-		RED = 0, RG, RGB, RGBA
+		RED = 0, RG, RGB, RGBA,
+
+		// Block compressed, BytesPerChannel is ignored. Only levels uploaded
+		// with SetMipData() exist, the GPU can't generate them.
+		BC1, BC2, BC3, BC4, BC5, BC6H, BC7,
+		ETC2_RGB, ETC2_RGBA,
+		ASTC_4x4, ASTC_8x8
 	};
 
 	enum class WrappingType
@@ -12,26 +18,116 @@ namespace AGI {
 		ClampBorder = 0, ClampEdge, Repeat, MirrorRepeat
 	};
 
+	// Cube faces are +X, -X, +Y, -Y, +Z, -Z
+	enum class TextureType
+	{
+		Texture2D = 0, Texture2DArray, Cube, CubeArray, Texture3D
+	};
+
+	// Fast fits endpoints once, High refines them and is several times slower
+	enum class TextureCompression
+	{
+		None = 0, Fast, High
+	};
+
+	// TextureSpecification::MipLevels value that builds every level down to 1x1
+	constexpr uint32_t FullMipChain = 0;
+
 	namespace Utils {
 
 		ImageFormat ChannelsToImageFormat(uint16_t channels);
 		uint16_t ImageFormatToChannels(ImageFormat format);
 
+		bool IsCompressed(ImageFormat format);
+
+		// 1x1 and the size of a pixel for uncompressed formats
+		glm::uvec2 GetBlockExtent(ImageFormat format);
+		uint32_t GetBlockSize(ImageFormat format);
+
+		uint32_t CalculateMipLevels(const glm::uvec2& size);
+		glm::uvec2 GetMipSize(const glm::uvec2& size, uint32_t mip);
+
+	};
+
+	// Texels of one mip level, in texels of that level
+	struct TextureRegion
+	{
+		uint32_t X = 0;
+		uint32_t Y = 0;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
 	};
 
 	struct TextureSpecification
 	{
+		TextureType Type = TextureType::Texture2D;
 		glm::uvec2 Size;
-		bool LinearFiltering = false;
+
+		// Array layers, cubes of a cube array or the depth of a 3D texture. Cube faces
+		// and layers are addressed together, layer = cube * 6 + face.
+		uint32_t Layers = 1;
+		bool LinearFiltering = false; // Trilinear when there are mip levels
+
+		// Levels past the first are generated on the GPU whenever level 0 changes
+		uint32_t MipLevels = 1;
+		bool GenerateMips = true;
+
+		// Clamped to what the driver supports, 1 disables anisotropic filtering
+		float Anisotropy = 1.0f;
+
+		// Colour channels hold sRGB encoded values, filtering happens in linear space.
+		// 8 bit and BC1/2/3/7, ETC2 and ASTC formats only.
+		bool SRGB = false;
 
 		ImageFormat Format = ImageFormat::RGB;
 		WrappingType Wrapping = WrappingType::Repeat;
 		uint16_t BytesPerChannel = 8;
 
+		// Encodes 8 bit Data to BC1/3/4/5 or ETC2 on the CPU before uploading it, whichever
+		// of them the device samples. Mips are built on the CPU first when requested.
+		TextureCompression Compression = TextureCompression::None;
+
+		// Level 0 of every layer, one after another
 		void* Data = nullptr;
 		uint32_t Datasize = 0;
 	};
 
+	namespace Utils {
+
+		uint32_t GetBytesPerPixel(const TextureSpecification& spec);
+
+		// Layers SetData() can address at level 'mip', 3D textures lose depth with every level
+		uint32_t GetLayerCount(const TextureSpecification& spec, uint32_t mip = 0);
+
+		// Levels the texture has, MipLevels clamped to the full chain
+		uint32_t CalculateMipLevels(const TextureSpecification& spec);
+
+		// Bytes SetData() reads for 'region', rowPitch 0 meaning tightly packed rows.
+		// Compressed rows are rows of blocks.
+		uint32_t GetRegionDatasize(const TextureSpecification& spec, const TextureRegion& region, uint32_t rowPitch = 0);
+
+		// Bytes of every layer of level 'mip', what SetMipData() reads
+		uint32_t GetLevelDatasize(const TextureSpecification& spec, uint32_t mip);
+
+		// Logs why a texture can't be created from 'spec'
+		bool ValidateSpecification(const TextureSpecification& spec);
+
+		// Logs why SetData() can't update 'region' of level 'mip'
+		bool ValidateRegion(const TextureSpecification& spec, uint32_t mipLevels, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t size, uint32_t rowPitch);
+
+	};
+
+	// Staging memory from RenderContext::AllocateUpload(). Data is write-only and
+	// can be filled from any thread until the upload is passed to SetData().
+	struct TextureUpload
+	{
+		void* Data = nullptr;
+		uint32_t Size = 0;
+
+		uint32_t Offset = 0; // Into the backend's staging buffer
+		uint64_t ID = 0;
+	};
+
 	class TextureBase : public RefCounted
 	{
 	public:
@@ -40,9 +136,31 @@ namespace AGI {
 		virtual const glm::uvec2& GetSize() const = 0;
 		virtual const TextureSpecification& GetSpecification() const = 0;
 		virtual uint32_t GetRendererID() const = 0;
+		virtual uint32_t GetMipLevels() const = 0;
 
 		virtual void SetData(void* data, uint32_t size) = 0;
+
+		// Updates part of a level. 'rowPitch' is the distance between rows of
+		// 'data' in bytes, 0 when they are tightly packed. Only what the region
+		// covers is read, so 'size' can be smaller than rowPitch * Height.
+		// Compressed regions start on a block and are tightly packed.
+		virtual void SetData(const void* data, uint32_t size, const TextureRegion& region, uint32_t mip = 0, uint32_t layer = 0, uint32_t rowPitch = 0) = 0;
+
+		// Copies a filled upload into level 0 and returns without waiting for the GPU
+		virtual void SetData(const TextureUpload& upload) = 0;
+
+		// Uploads every layer of a level, for chains built with Utils::GenerateMipChain()
+		virtual void SetMipData(uint32_t mip, void* data, uint32_t size) = 0;
+
+		// Rebuilds every level from level 0
+		virtual void GenerateMips() = 0;
 		virtual void Bind(uint32_t slot = 0) const = 0;
+
+		// Lets shaders sample the texture without binding it, 0 unless the context
+		// IsBindlessSupported(). On OpenGL a GL_ARB_bindless_texture handle that is
+		// made resident here, after which the texture's sampling state is fixed.
+		// On Vulkan the texture's index into the context's bindless descriptor array.
+		virtual uint64_t GetBindlessHandle() const = 0;
 	};
 
 	using Texture = ResourceBarrier<TextureBase>;
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Texture.hpp"
+
+#include <map>
+#include <set>
+#include <unordered_map>
+
+namespace AGI {
+
+	class RenderContext;
+
+	// 0 is never handed out
+	using AtlasHandle = uint32_t;
+
+	struct AtlasSpecification
+	{
+		glm::uvec2 PageSize = { 1024, 1024 };
+		uint32_t MaxPages = 4;
+
+		// Uncompressed formats only, pages have a single mip level
+		ImageFormat Format = ImageFormat::RGBA;
+		uint16_t BytesPerChannel = 8;
+		bool SRGB = false;
+		bool LinearFiltering = true;
+
+		// Texels around every rectangle filled with copies of its edges, so bilinear
+		// filtering never picks up a neighbour. 1 is enough without mips.
+		uint32_t Padding = 1;
+	};
+
+	struct AtlasRegion
+	{
+		uint32_t Page = 0;
+		TextureRegion Region; // Texels of the page, padding excluded
+		glm::vec2 UVMin = {};
+		glm::vec2 UVMax = {};
+	};
+
+	// Packs many small images into a few shared textures, so sprites, glyphs and
+	// icons can be drawn in one batch. Rectangles are placed bottom-left on a
+	// skyline and freed ones are reused by the next image that fits. Removing
+	// leaves holes, Repack() closes them by packing everything again from the
+	// copies the atlas keeps of every image. Not thread safe, like the textures.
+	class TextureAtlas
+	{
+	public:
+		TextureAtlas(RenderContext* context, const AtlasSpecification& spec);
+
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+		// 'data' is size.x * size.y texels of the atlas format, rows 'rowPitch' bytes
+		// apart or tightly packed. Returns 0 when no page has room for it.
+		AtlasHandle Add(const void* data, const glm::uvec2& size, uint32_t rowPitch = 0);
+		void Remove(AtlasHandle handle);
+
+		// nullptr for unknown handles, invalidated by Add(), Remove() and Repack()
+		const AtlasRegion* Get(AtlasHandle handle) const;
+
+		// Packs every image again, tallest first, and uploads the ones that moved.
+		// Handles stay valid. Leaves the atlas untouched and returns false when
+		// the images no longer fit, which can happen with a single page left.
+		bool Repack();
+
+		// Share of the packed texels that belong to removed images
+		float GetFragmentation() const;
+
+		uint32_t GetPageCount() const { return (uint32_t)m_Pages.size(); }
+		const Texture& GetTexture(uint32_t page) const { return m_Pages[page].Image; }
+		const AtlasSpecification& GetSpecification() const { return m_Specification; }
+	private:
+		struct SkylineSegment
+		{
+			uint32_t Y = 0;
+			uint32_t Width = 0;
+		};
+
+		struct Page
+		{
+			Texture Image;
+
+			// Segments keyed by X, and their (Y, X) so the lowest ones are tried first
+			std::map<uint32_t, SkylineSegment> Skyline;
+			std::set<std::pair<uint32_t, uint32_t>> SkylineHeights;
+
+			// Removed rectangles by height then width. FreedWidths is a max tree over
+			// every height of the widest rectangle that tall, it finds the shortest one
+			// wide enough without visiting the rest.
+			std::map<uint32_t, std::multimap<uint32_t, TextureRegion>> Freed;
+			std::vector<uint32_t> FreedWidths;
+			uint64_t FreedArea = 0;
+			uint64_t UsedArea = 0;
+		};
+
+		struct Entry
+		{
+			AtlasRegion Region;
+			glm::uvec2 PaddedSize;
+			std::vector<uint8_t> Pixels; // Padded and extruded, as uploaded
+		};
+
+		Texture CreatePageTexture() const;
+		void ResetPage(Page& page) const;
+		bool Allocate(Page& page, const glm::uvec2& size, TextureRegion& region) const;
+		bool AllocateFreed(Page& page, const glm::uvec2& size, TextureRegion& region) const;
+		bool AllocateSkyline(Page& page, const glm::uvec2& size, TextureRegion& region) const;
+		void AddFreed(Page& page, const TextureRegion& region) const;
+		void UpdateFreedWidth(Page& page, uint32_t height) const;
+
+		TextureRegion GetPaddedRegion(const Entry& entry) const;
+		void Place(Entry& entry, uint32_t page, const TextureRegion& padded);
+		void Upload(const Entry& entry);
+	private:
+		RenderContext* m_Context;
+		AtlasSpecification m_Specification;
+		uint32_t m_BytesPerPixel = 4;
+
+		std::vector<Page> m_Pages;
+		std::unordered_map<AtlasHandle, Entry> m_Entries;
+		AtlasHandle m_NextHandle = 1;
+	};
+
+}
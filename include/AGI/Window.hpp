@@ -32,6 +32,7 @@ namespace AGI {
 
 		void* GetNativeWindow() const;
 		GLFWwindow* GetGlfwWindow() const { return m_Window; }
+		bool IsHeadless() const { return m_Settings.Headless; }
 
 		// Events
 		void SetWindowPosCallback(WindowPosFunc callback)           { m_Events.WindowPosCallback = callback;      InstallCallbacks(); }
@@ -72,6 +73,7 @@ namespace AGI {
 
 		int m_WindowIndex = -1;
 		float m_LastFrameTime = 0.0f;
+		bool m_ShouldClose = false;
 
 		friend class RenderContext;
 	};
@@ -2,10 +2,23 @@
 
 #include "agipch.hpp"
 
+#include "BlockEncoder.hpp"
 #include "Buffer.hpp"
 #include "Framebuffer.hpp"
+#include "FrameStats.hpp"
+#include "GpuProfiler.hpp"
+#include "Ktx2.hpp"
+#include "MipChain.hpp"
+#include "Profiler.hpp"
 #include "RenderContext.hpp"
+#include "ResourceCache.hpp"
+#include "Sampler.hpp"
 #include "Shader.hpp"
+#include "ShaderLibrary.hpp"
+#include "ShaderPack.hpp"
+#include "ShaderPreprocessor.hpp"
+#include "ShaderWatcher.hpp"
 #include "Texture.hpp"
+#include "TextureAtlas.hpp"
 #include "VertexArray.hpp"
 #include "Window.hpp"
\ No newline at end of file
@@ -5,6 +5,10 @@
 #include <cstring>
 #include <array>
 #include <functional>
+#include <chrono>
+#include <mutex>
+#include <filesystem>
+#include <span>
 
 #if defined(AGI_WINDOWS)
 #define AGI_DEBUGBREAK() __debugbreak()
@@ -16,5 +20,6 @@
 #include "AGI/ResourceBarrier.hpp"
 #include "AGI/RenderContext.hpp"
 #include "AGI/Log.hpp"
+#include "AGI/Profiler.hpp"
 
 #include <glm/glm.hpp>
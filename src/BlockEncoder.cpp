@@ -0,0 +1,988 @@
+#include "agipch.hpp"
+#include "AGI/BlockEncoder.hpp"
+
+#include "Simd.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <thread>
+
+namespace AGI {
+
+	namespace Utils {
+
+		// A 4x4 block as 0-255 floats. Texels holds one RGBA register per texel for
+		// sums over the block, Rows one channel of a row per register so per texel
+		// maths runs on four texels at once.
+		struct EncoderBlock
+		{
+			Simd::Float4 Texels[16];
+			Simd::Float4 Rows[4][4]; // [channel][row]
+		};
+
+		// Blocks hanging over the edge repeat the last row and column
+		static void LoadBlock(const uint8_t* data, const glm::uvec2& size, uint32_t channels, uint32_t blockX, uint32_t blockY, EncoderBlock& block)
+		{
+			float rows[4][4][4]; // [channel][row][column]
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				uint32_t sourceY = std::min(blockY * 4 + y, size.y - 1);
+				for (uint32_t x = 0; x < 4; ++x)
+				{
+					uint32_t sourceX = std::min(blockX * 4 + x, size.x - 1);
+					const uint8_t* texel = data + ((size_t)sourceY * size.x + sourceX) * channels;
+
+					float rgba[4] = { 0.0f, 0.0f, 0.0f, 255.0f };
+					for (uint32_t c = 0; c < channels; ++c) rgba[c] = texel[c];
+
+					block.Texels[y * 4 + x] = Simd::Float4::Load(rgba);
+					for (uint32_t c = 0; c < 4; ++c) rows[c][y][x] = rgba[c];
+				}
+			}
+
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				for (uint32_t y = 0; y < 4; ++y)
+					block.Rows[c][y] = Simd::Float4::Load(rows[c][y]);
+			}
+		}
+
+		static void GetRange(const Simd::Float4 rows[4], float& low, float& high)
+		{
+			Simd::Float4 minimum = rows[0], maximum = rows[0];
+			for (uint32_t y = 1; y < 4; ++y)
+			{
+				minimum = Simd::Float4::Min(minimum, rows[y]);
+				maximum = Simd::Float4::Max(maximum, rows[y]);
+			}
+
+			float lows[4], highs[4];
+			minimum.Store(lows);
+			maximum.Store(highs);
+
+			low = std::min({ lows[0], lows[1], lows[2], lows[3] });
+			high = std::max({ highs[0], highs[1], highs[2], highs[3] });
+		}
+
+		// BC1 colour blocks, also the colour half of BC3
+
+		static uint16_t PackColour(const float rgb[3])
+		{
+			auto quantise = [](float value, float maximum) { return (uint32_t)(std::clamp(value, 0.0f, 255.0f) * maximum / 255.0f + 0.5f); };
+			return (uint16_t)(quantise(rgb[0], 31.0f) << 11 | quantise(rgb[1], 63.0f) << 5 | quantise(rgb[2], 31.0f));
+		}
+
+		// Expanded the way the decoder does it
+		static void UnpackColour(uint16_t colour, float rgb[3])
+		{
+			uint32_t r = colour >> 11, g = (colour >> 5) & 63, b = colour & 31;
+
+			rgb[0] = (float)(r << 3 | r >> 2);
+			rgb[1] = (float)(g << 2 | g >> 4);
+			rgb[2] = (float)(b << 3 | b >> 2);
+		}
+
+		// Closest of the four colours for every texel, returns the squared error
+		static float FitColourIndices(const EncoderBlock& block, uint16_t colour0, uint16_t colour1, uint32_t& indices)
+		{
+			float palette[4][3];
+			UnpackColour(colour0, palette[0]);
+			UnpackColour(colour1, palette[1]);
+
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+				palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+			}
+
+			float error = 0.0f;
+			indices = 0;
+
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				float distances[4][4];
+				for (uint32_t i = 0; i < 4; ++i)
+				{
+					Simd::Float4 r = block.Rows[0][y] - Simd::Float4(palette[i][0]);
+					Simd::Float4 g = block.Rows[1][y] - Simd::Float4(palette[i][1]);
+					Simd::Float4 b = block.Rows[2][y] - Simd::Float4(palette[i][2]);
+
+					(r * r + g * g + b * b).Store(distances[i]);
+				}
+
+				for (uint32_t x = 0; x < 4; ++x)
+				{
+					uint32_t best = 0;
+					for (uint32_t i = 1; i < 4; ++i)
+					{
+						if (distances[i][x] < distances[best][x])
+							best = i;
+					}
+
+					indices |= best << ((y * 4 + x) * 2);
+					error += distances[best][x];
+				}
+			}
+
+			return error;
+		}
+
+		// Least squares endpoints for the current indices, false when every texel has the same weight
+		static bool RefineColourEndpoints(const EncoderBlock& block, uint32_t indices, uint16_t& colour0, uint16_t& colour1)
+		{
+			static constexpr float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+			Simd::Float4 sumA, sumB;
+
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				float b = weights[(indices >> (i * 2)) & 3];
+				float a = 1.0f - b;
+
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				sumA += block.Texels[i] * a;
+				sumB += block.Texels[i] * b;
+			}
+
+			float determinant = aa * bb - ab * ab;
+			if (std::abs(determinant) < 1e-6f) return false;
+
+			float endpoint0[4], endpoint1[4];
+			((sumA * bb - sumB * ab) * (1.0f / determinant)).Store(endpoint0);
+			((sumB * aa - sumA * ab) * (1.0f / determinant)).Store(endpoint1);
+
+			colour0 = PackColour(endpoint0);
+			colour1 = PackColour(endpoint1);
+			return true;
+		}
+
+		static void EncodeColourBlock(const EncoderBlock& block, TextureCompression quality, uint8_t* output)
+		{
+			Simd::Float4 sum, low = block.Texels[0], high = block.Texels[0];
+			for (const Simd::Float4& texel : block.Texels)
+			{
+				sum += texel;
+				low = Simd::Float4::Min(low, texel);
+				high = Simd::Float4::Max(high, texel);
+			}
+
+			float mean[4], lows[4], highs[4];
+			(sum * (1.0f / 16.0f)).Store(mean);
+			low.Store(lows);
+			high.Store(highs);
+
+			// Principal axis of the colours, by power iteration on their covariance
+			Simd::Float4 rr, gg, bb, rg, rb, gb;
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				Simd::Float4 r = block.Rows[0][y] - Simd::Float4(mean[0]);
+				Simd::Float4 g = block.Rows[1][y] - Simd::Float4(mean[1]);
+				Simd::Float4 b = block.Rows[2][y] - Simd::Float4(mean[2]);
+
+				rr += r * r; gg += g * g; bb += b * b;
+				rg += r * g; rb += r * b; gb += g * b;
+			}
+
+			float covariance[6] = { rr.Sum(), gg.Sum(), bb.Sum(), rg.Sum(), rb.Sum(), gb.Sum() };
+			float axis[3] = { highs[0] - lows[0], highs[1] - lows[1], highs[2] - lows[2] };
+
+			for (uint32_t i = 0; i < 8; ++i)
+			{
+				float next[3] = {
+					covariance[0] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+					covariance[3] * axis[0] + covariance[1] * axis[1] + covariance[5] * axis[2],
+					covariance[4] * axis[0] + covariance[5] * axis[1] + covariance[2] * axis[2]
+				};
+
+				float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+				if (length < 1e-6f) break;
+
+				for (uint32_t c = 0; c < 3; ++c) axis[c] = next[c] / length;
+			}
+
+			float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			for (uint32_t c = 0; c < 3; ++c) axis[c] = length > 1e-6f ? axis[c] / length : 0.0f;
+
+			// Extent of the texels along the axis
+			Simd::Float4 projections[4];
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				projections[y] = (block.Rows[0][y] - Simd::Float4(mean[0])) * axis[0] +
+					(block.Rows[1][y] - Simd::Float4(mean[1])) * axis[1] +
+					(block.Rows[2][y] - Simd::Float4(mean[2])) * axis[2];
+			}
+
+			float tMin, tMax;
+			GetRange(projections, tMin, tMax);
+
+			auto pack = [&](float t)
+			{
+				float rgb[3] = { mean[0] + axis[0] * t, mean[1] + axis[1] * t, mean[2] + axis[2] * t };
+				return PackColour(rgb);
+			};
+
+			// Insetting the endpoints a little lowers the error of most blocks
+			float inset = (tMax - tMin) / 16.0f;
+			uint16_t colour0 = pack(tMax - inset), colour1 = pack(tMin + inset);
+
+			uint32_t indices;
+			float error = FitColourIndices(block, colour0, colour1, indices);
+
+			if (quality == TextureCompression::High)
+			{
+				auto attempt = [&](uint16_t candidate0, uint16_t candidate1)
+				{
+					uint32_t candidateIndices;
+					float candidateError = FitColourIndices(block, candidate0, candidate1, candidateIndices);
+					if (candidateError >= error) return false;
+
+					colour0 = candidate0;
+					colour1 = candidate1;
+					indices = candidateIndices;
+					error = candidateError;
+					return true;
+				};
+
+				attempt(pack(tMax), pack(tMin));
+
+				for (uint32_t pass = 0; pass < 3; ++pass)
+				{
+					uint16_t refined0, refined1;
+					if (!RefineColourEndpoints(block, indices, refined0, refined1) || !attempt(refined0, refined1))
+						break;
+				}
+			}
+
+			// Four colour mode needs colour0 > colour1, swapping them swaps indices 0/1 and 2/3
+			if (colour0 < colour1)
+			{
+				std::swap(colour0, colour1);
+				indices ^= 0x55555555;
+			}
+			else if (colour0 == colour1)
+				indices = 0;
+
+			output[0] = (uint8_t)colour0; output[1] = (uint8_t)(colour0 >> 8);
+			output[2] = (uint8_t)colour1; output[3] = (uint8_t)(colour1 >> 8);
+			for (uint32_t i = 0; i < 4; ++i) output[4 + i] = (uint8_t)(indices >> (i * 8));
+		}
+
+		// BC4 single channel blocks, also BC3 alpha and both halves of BC5
+
+		static void GetAlphaPalette(uint8_t alpha0, uint8_t alpha1, float palette[8])
+		{
+			palette[0] = alpha0;
+			palette[1] = alpha1;
+
+			if (alpha0 > alpha1)
+			{
+				for (uint32_t i = 2; i < 8; ++i) palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7.0f;
+			}
+			else
+			{
+				for (uint32_t i = 2; i < 6; ++i) palette[i] = ((6 - i) * alpha0 + (i - 1) * alpha1) / 5.0f;
+				palette[6] = 0.0f;
+				palette[7] = 255.0f;
+			}
+		}
+
+		static float FitAlphaIndices(const Simd::Float4 rows[4], uint8_t alpha0, uint8_t alpha1, uint64_t& indices)
+		{
+			float palette[8];
+			GetAlphaPalette(alpha0, alpha1, palette);
+
+			float error = 0.0f;
+			indices = 0;
+
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				float distances[8][4];
+				for (uint32_t i = 0; i < 8; ++i)
+				{
+					Simd::Float4 difference = rows[y] - Simd::Float4(palette[i]);
+					(difference * difference).Store(distances[i]);
+				}
+
+				for (uint32_t x = 0; x < 4; ++x)
+				{
+					uint32_t best = 0;
+					for (uint32_t i = 1; i < 8; ++i)
+					{
+						if (distances[i][x] < distances[best][x])
+							best = i;
+					}
+
+					indices |= (uint64_t)best << ((y * 4 + x) * 3);
+					error += distances[best][x];
+				}
+			}
+
+			return error;
+		}
+
+		static void EncodeAlphaBlock(const Simd::Float4 rows[4], TextureCompression quality, uint8_t* output)
+		{
+			float low, high;
+			GetRange(rows, low, high);
+
+			// Eight values between the extremes
+			uint8_t alpha0 = (uint8_t)(high + 0.5f), alpha1 = (uint8_t)(low + 0.5f);
+
+			uint64_t indices;
+			float error = FitAlphaIndices(rows, alpha0, alpha1, indices);
+
+			if (quality == TextureCompression::High && error > 0.0f)
+			{
+				auto attempt = [&](uint8_t candidate0, uint8_t candidate1)
+				{
+					uint64_t candidateIndices;
+					float candidateError = FitAlphaIndices(rows, candidate0, candidate1, candidateIndices);
+					if (candidateError >= error) return;
+
+					alpha0 = candidate0;
+					alpha1 = candidate1;
+					indices = candidateIndices;
+					error = candidateError;
+				};
+
+				float values[16];
+				for (uint32_t y = 0; y < 4; ++y) rows[y].Store(values + y * 4);
+
+				// Six values with exact 0 and 255 on the side, for blocks that hit both ends
+				float innerLow = 255.0f, innerHigh = 0.0f;
+				for (float value : values)
+				{
+					if (value == 0.0f || value == 255.0f) continue;
+
+					innerLow = std::min(innerLow, value);
+					innerHigh = std::max(innerHigh, value);
+				}
+
+				if (innerLow <= innerHigh)
+					attempt((uint8_t)(innerLow + 0.5f), (uint8_t)(innerHigh + 0.5f));
+
+				// Least squares endpoints for the eight value indices
+				if (alpha0 > alpha1)
+				{
+					float aa = 0.0f, ab = 0.0f, bb = 0.0f, sumA = 0.0f, sumB = 0.0f;
+					for (uint32_t i = 0; i < 16; ++i)
+					{
+						uint32_t index = (indices >> (i * 3)) & 7;
+						float b = index == 0 ? 0.0f : index == 1 ? 1.0f : (index - 1) / 7.0f;
+						float a = 1.0f - b;
+
+						aa += a * a; ab += a * b; bb += b * b;
+						sumA += values[i] * a; sumB += values[i] * b;
+					}
+
+					float determinant = aa * bb - ab * ab;
+					if (std::abs(determinant) > 1e-6f)
+					{
+						float refined0 = std::clamp((sumA * bb - sumB * ab) / determinant, 0.0f, 255.0f);
+						float refined1 = std::clamp((sumB * aa - sumA * ab) / determinant, 0.0f, 255.0f);
+
+						if ((uint8_t)(refined0 + 0.5f) > (uint8_t)(refined1 + 0.5f))
+							attempt((uint8_t)(refined0 + 0.5f), (uint8_t)(refined1 + 0.5f));
+					}
+				}
+			}
+
+			output[0] = alpha0;
+			output[1] = alpha1;
+			for (uint32_t i = 0; i < 6; ++i) output[2 + i] = (uint8_t)(indices >> (i * 8));
+		}
+
+		// ETC2 colour blocks, written in the ETC1 compatible modes
+
+		static constexpr int32_t s_EtcModifiers[8][2] = {
+			{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+		};
+
+		// Eight texels of a half block, one channel of four texels per register
+		using EtcHalf = Simd::Float4[3][2];
+
+		struct EtcHalfFit
+		{
+			uint32_t Table = 0;
+			float Error = FLT_MAX;
+			uint8_t Indices[8] = {};
+		};
+
+		struct EtcFit
+		{
+			bool Differential = false;
+			int32_t Base[2][3] = {}; // 5 bit when differential, 4 bit otherwise
+			EtcHalfFit Halves[2];
+			float Error = FLT_MAX;
+		};
+
+		// Best codeword table for a half block around 'base'. The modifier is added to
+		// every channel and each texel takes whichever of the four lands closest.
+		static EtcHalfFit FitEtcHalf(const EtcHalf& texels, const int32_t base[3])
+		{
+			auto distance = [&](uint32_t group, int32_t modifier)
+			{
+				Simd::Float4 r = texels[0][group] - Simd::Float4((float)std::clamp(base[0] + modifier, 0, 255));
+				Simd::Float4 g = texels[1][group] - Simd::Float4((float)std::clamp(base[1] + modifier, 0, 255));
+				Simd::Float4 b = texels[2][group] - Simd::Float4((float)std::clamp(base[2] + modifier, 0, 255));
+
+				return r * r + g * g + b * b;
+			};
+
+			auto getModifiers = [](uint32_t table, int32_t modifiers[4])
+			{
+				modifiers[0] = s_EtcModifiers[table][0];
+				modifiers[1] = s_EtcModifiers[table][1];
+				modifiers[2] = -s_EtcModifiers[table][0];
+				modifiers[3] = -s_EtcModifiers[table][1];
+			};
+
+			EtcHalfFit best;
+			for (uint32_t table = 0; table < 8; ++table)
+			{
+				int32_t modifiers[4];
+				getModifiers(table, modifiers);
+
+				float error = 0.0f;
+				for (uint32_t group = 0; group < 2; ++group)
+				{
+					Simd::Float4 closest = distance(group, modifiers[0]);
+					for (uint32_t m = 1; m < 4; ++m)
+						closest = Simd::Float4::Min(closest, distance(group, modifiers[m]));
+
+					error += closest.Sum();
+				}
+
+				if (error < best.Error)
+				{
+					best.Table = table;
+					best.Error = error;
+				}
+			}
+
+			// Indices are only worked out for the winning table
+			int32_t modifiers[4];
+			getModifiers(best.Table, modifiers);
+
+			for (uint32_t group = 0; group < 2; ++group)
+			{
+				float distances[4][4];
+				for (uint32_t m = 0; m < 4; ++m)
+					distance(group, modifiers[m]).Store(distances[m]);
+
+				for (uint32_t lane = 0; lane < 4; ++lane)
+				{
+					uint8_t closest = 0;
+					for (uint8_t m = 1; m < 4; ++m)
+					{
+						if (distances[m][lane] < distances[closest][lane])
+							closest = m;
+					}
+
+					best.Indices[group * 4 + lane] = closest;
+				}
+			}
+
+			return best;
+		}
+
+		// The ETC1 bit layout, which ETC2 decodes the same way as long as differential bases don't overflow
+		static void WriteEtcBlock(const EtcFit& fit, bool flip, const uint32_t halves[2][8], uint8_t* output)
+		{
+			uint32_t high = 0, low = 0;
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				if (fit.Differential)
+					high |= fit.Base[0][c] << (27 - c * 8) | ((fit.Base[1][c] - fit.Base[0][c]) & 7) << (24 - c * 8);
+				else
+					high |= fit.Base[0][c] << (28 - c * 8) | fit.Base[1][c] << (24 - c * 8);
+			}
+
+			high |= fit.Halves[0].Table << 5 | fit.Halves[1].Table << 2 | (uint32_t)fit.Differential << 1 | (uint32_t)flip;
+
+			// Texels are numbered down the columns, index bits are split into a high and a low half
+			for (uint32_t half = 0; half < 2; ++half)
+			{
+				for (uint32_t i = 0; i < 8; ++i)
+				{
+					uint32_t x = halves[half][i] % 4, y = halves[half][i] / 4;
+					uint32_t bit = x * 4 + y;
+					uint32_t index = fit.Halves[half].Indices[i];
+
+					low |= (index >> 1) << (bit + 16) | (index & 1) << bit;
+				}
+			}
+
+			for (uint32_t i = 0; i < 4; ++i)
+			{
+				output[i] = (uint8_t)(high >> (24 - i * 8));
+				output[4 + i] = (uint8_t)(low >> (24 - i * 8));
+			}
+		}
+
+		static void EncodeEtcBlock(const EncoderBlock& block, TextureCompression quality, uint8_t* output)
+		{
+			float colours[3][16];
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				for (uint32_t y = 0; y < 4; ++y)
+					block.Rows[c][y].Store(colours[c] + y * 4);
+			}
+
+			// Two 2x4 halves side by side, or two 4x2 halves stacked when flipped
+			uint32_t halves[2][2][8];
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				uint32_t x = i % 4, y = i / 4;
+				halves[0][x / 2][(x % 2) * 4 + y] = i;
+				halves[1][y / 2][(y % 2) * 4 + x] = i;
+			}
+
+			// The average is only a starting point, High also tries one step either side of it
+			int32_t search = quality == TextureCompression::High ? 1 : 0;
+
+			EtcFit best;
+			bool bestFlip = false;
+
+			for (uint32_t flip = 0; flip < 2; ++flip)
+			{
+				EtcHalf texels[2];
+				float average[2][3] = {};
+
+				for (uint32_t half = 0; half < 2; ++half)
+				{
+					for (uint32_t c = 0; c < 3; ++c)
+					{
+						float values[8];
+						for (uint32_t i = 0; i < 8; ++i)
+						{
+							values[i] = colours[c][halves[flip][half][i]];
+							average[half][c] += values[i] / 8.0f;
+						}
+
+						texels[half][c][0] = Simd::Float4::Load(values);
+						texels[half][c][1] = Simd::Float4::Load(values + 4);
+					}
+				}
+
+				auto consider = [&](const EtcFit& fit)
+				{
+					if (fit.Error >= best.Error) return;
+
+					best = fit;
+					bestFlip = flip;
+				};
+
+				// Differential, 555 bases with the second within -4..3 of the first
+				int32_t base5[2][3];
+				for (uint32_t half = 0; half < 2; ++half)
+				{
+					for (uint32_t c = 0; c < 3; ++c)
+						base5[half][c] = (int32_t)(average[half][c] * 31.0f / 255.0f + 0.5f);
+				}
+
+				bool differential = false;
+				for (int32_t offset0 = -search; offset0 <= search; ++offset0)
+				{
+					for (int32_t offset1 = -search; offset1 <= search; ++offset1)
+					{
+						EtcFit fit;
+						fit.Differential = true;
+
+						bool valid = true;
+						int32_t expanded[2][3];
+						for (uint32_t c = 0; c < 3; ++c)
+						{
+							fit.Base[0][c] = std::clamp(base5[0][c] + offset0, 0, 31);
+							fit.Base[1][c] = std::clamp(base5[1][c] + offset1, 0, 31);
+
+							int32_t delta = fit.Base[1][c] - fit.Base[0][c];
+							valid &= delta >= -4 && delta <= 3;
+
+							for (uint32_t half = 0; half < 2; ++half)
+								expanded[half][c] = fit.Base[half][c] << 3 | fit.Base[half][c] >> 2;
+						}
+
+						if (!valid) continue;
+
+						fit.Halves[0] = FitEtcHalf(texels[0], expanded[0]);
+						fit.Halves[1] = FitEtcHalf(texels[1], expanded[1]);
+						fit.Error = fit.Halves[0].Error + fit.Halves[1].Error;
+
+						differential = true;
+						consider(fit);
+					}
+				}
+
+				// Individual, 444 bases fitted to each half on its own
+				if (differential && quality != TextureCompression::High)
+					continue;
+
+				EtcFit fit;
+				fit.Error = 0.0f;
+
+				for (uint32_t half = 0; half < 2; ++half)
+				{
+					for (int32_t offset = -search; offset <= search; ++offset)
+					{
+						int32_t base4[3], expanded[3];
+						for (uint32_t c = 0; c < 3; ++c)
+						{
+							base4[c] = std::clamp((int32_t)(average[half][c] * 15.0f / 255.0f + 0.5f) + offset, 0, 15);
+							expanded[c] = base4[c] << 4 | base4[c];
+						}
+
+						EtcHalfFit halfFit = FitEtcHalf(texels[half], expanded);
+						if (halfFit.Error < fit.Halves[half].Error)
+						{
+							fit.Halves[half] = halfFit;
+							std::copy(std::begin(base4), std::end(base4), fit.Base[half]);
+						}
+					}
+
+					fit.Error += fit.Halves[half].Error;
+				}
+
+				consider(fit);
+			}
+
+			WriteEtcBlock(best, bestFlip, halves[bestFlip], output);
+		}
+
+		// EAC alpha blocks of ETC2_RGBA
+
+		static constexpr int32_t s_EacModifiers[16][8] = {
+			{ -3, -6,  -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+			{ -2, -5,  -8, -13, 1, 4, 7, 12 }, { -2, -4,  -6, -13, 1, 3, 5, 12 },
+			{ -3, -6,  -8, -12, 2, 5, 7, 11 }, { -3, -7,  -9, -11, 2, 6, 8, 10 },
+			{ -4, -7,  -8, -11, 3, 6, 7, 10 }, { -3, -5,  -8, -11, 2, 4, 7, 10 },
+			{ -2, -6,  -8, -10, 1, 5, 7,  9 }, { -2, -5,  -8, -10, 1, 4, 7,  9 },
+			{ -2, -4,  -8, -10, 1, 3, 7,  9 }, { -2, -5,  -7, -10, 1, 4, 6,  9 },
+			{ -3, -4,  -7, -10, 2, 3, 6,  9 }, { -1, -2,  -3, -10, 0, 1, 2,  9 },
+			{ -4, -6,  -8,  -9, 3, 5, 7,  8 }, { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+		};
+
+		// Squared error of the closest modifier for every texel, also the indices when 'indices' is set
+		static float FitEacIndices(const Simd::Float4 rows[4], int32_t base, int32_t multiplier, const int32_t modifiers[8], uint8_t* indices = nullptr)
+		{
+			Simd::Float4 candidates[8];
+			for (uint32_t m = 0; m < 8; ++m)
+				candidates[m] = Simd::Float4((float)std::clamp(base + modifiers[m] * multiplier, 0, 255));
+
+			float error = 0.0f;
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				Simd::Float4 distances[8];
+				for (uint32_t m = 0; m < 8; ++m)
+					distances[m] = (rows[y] - candidates[m]) * (rows[y] - candidates[m]);
+
+				Simd::Float4 closest = distances[0];
+				for (uint32_t m = 1; m < 8; ++m)
+					closest = Simd::Float4::Min(closest, distances[m]);
+
+				error += closest.Sum();
+				if (!indices) continue;
+
+				float lanes[8][4];
+				for (uint32_t m = 0; m < 8; ++m)
+					distances[m].Store(lanes[m]);
+
+				for (uint32_t x = 0; x < 4; ++x)
+				{
+					uint8_t best = 0;
+					for (uint8_t m = 1; m < 8; ++m)
+					{
+						if (lanes[m][x] < lanes[best][x])
+							best = m;
+					}
+
+					indices[y * 4 + x] = best;
+				}
+			}
+
+			return error;
+		}
+
+		static void EncodeEacBlock(const Simd::Float4 rows[4], TextureCompression quality, uint8_t* output)
+		{
+			float low, high;
+			GetRange(rows, low, high);
+
+			int32_t search = quality == TextureCompression::High ? 1 : 0;
+
+			float bestError = FLT_MAX;
+			uint32_t bestTable = 0;
+			int32_t bestBase = 0, bestMultiplier = 1;
+
+			for (uint32_t table = 0; table < 16 && bestError > 0.0f; ++table)
+			{
+				// Stretches the table over the block's range, centred between the extremes
+				const int32_t* modifiers = s_EacModifiers[table];
+				int32_t span = modifiers[7] - modifiers[3];
+				int32_t multiplier = std::clamp((int32_t)((high - low) / span + 0.5f), 1, 15);
+				int32_t base = (int32_t)((low + high - (modifiers[7] + modifiers[3]) * multiplier) / 2.0f + 0.5f);
+
+				for (int32_t multiplierOffset = -search; multiplierOffset <= search; ++multiplierOffset)
+				{
+					for (int32_t baseOffset = -search; baseOffset <= search; ++baseOffset)
+					{
+						int32_t candidateMultiplier = std::clamp(multiplier + multiplierOffset, 1, 15);
+						int32_t candidateBase = std::clamp(base + baseOffset, 0, 255);
+
+						float error = FitEacIndices(rows, candidateBase, candidateMultiplier, modifiers);
+						if (error >= bestError) continue;
+
+						bestError = error;
+						bestTable = table;
+						bestBase = candidateBase;
+						bestMultiplier = candidateMultiplier;
+					}
+				}
+			}
+
+			uint8_t indices[16];
+			FitEacIndices(rows, bestBase, bestMultiplier, s_EacModifiers[bestTable], indices);
+
+			// Indices run down the columns, most significant first
+			uint64_t bits = 0;
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				uint32_t x = i % 4, y = i / 4;
+				bits |= (uint64_t)indices[i] << (45 - (x * 4 + y) * 3);
+			}
+
+			output[0] = (uint8_t)bestBase;
+			output[1] = (uint8_t)(bestMultiplier << 4 | bestTable);
+			for (uint32_t i = 0; i < 6; ++i) output[2 + i] = (uint8_t)(bits >> (40 - i * 8));
+		}
+
+		using EncodeBlockFn = void(*)(const EncoderBlock& block, TextureCompression quality, uint8_t* output);
+
+		static EncodeBlockFn GetBlockEncoder(ImageFormat format)
+		{
+			switch (format)
+			{
+			case ImageFormat::BC1: return EncodeColourBlock;
+			case ImageFormat::BC3: return [](const EncoderBlock& block, TextureCompression quality, uint8_t* output)
+			{
+				EncodeAlphaBlock(block.Rows[3], quality, output);
+				EncodeColourBlock(block, quality, output + 8);
+			};
+			case ImageFormat::BC4: return [](const EncoderBlock& block, TextureCompression quality, uint8_t* output)
+			{
+				EncodeAlphaBlock(block.Rows[0], quality, output);
+			};
+			case ImageFormat::BC5: return [](const EncoderBlock& block, TextureCompression quality, uint8_t* output)
+			{
+				EncodeAlphaBlock(block.Rows[0], quality, output);
+				EncodeAlphaBlock(block.Rows[1], quality, output + 8);
+			};
+			case ImageFormat::ETC2_RGB: return EncodeEtcBlock;
+			case ImageFormat::ETC2_RGBA: return [](const EncoderBlock& block, TextureCompression quality, uint8_t* output)
+			{
+				EncodeEacBlock(block.Rows[3], quality, output);
+				EncodeEtcBlock(block, quality, output + 8);
+			};
+			default: return nullptr;
+			}
+		}
+
+		bool CanEncode(ImageFormat format)
+		{
+			return GetBlockEncoder(format) != nullptr;
+		}
+
+		struct EncodeLevel
+		{
+			const uint8_t* Source;
+			glm::uvec2 Size;
+			uint8_t* Output;
+		};
+
+		// Rows of blocks from every level are handed out from one counter, a whole
+		// chain is encoded by a single set of workers
+		static void EncodeLevels(const std::vector<EncodeLevel>& levels, uint32_t channels, ImageFormat format, TextureCompression quality, uint32_t threads)
+		{
+			EncodeBlockFn encode = GetBlockEncoder(format);
+			uint32_t blockSize = GetBlockSize(format);
+
+			std::vector<uint32_t> firstRows;
+			uint32_t rows = 0;
+			for (const EncodeLevel& level : levels)
+			{
+				firstRows.push_back(rows);
+				rows += (level.Size.y + 3) / 4;
+			}
+
+			// Workers take whole rows of blocks until none are left
+			std::atomic<uint32_t> nextRow = 0;
+			auto work = [&]()
+			{
+				EncoderBlock block;
+				for (uint32_t row = nextRow++; row < rows; row = nextRow++)
+				{
+					size_t index = std::upper_bound(firstRows.begin(), firstRows.end(), row) - firstRows.begin() - 1;
+					const EncodeLevel& level = levels[index];
+					uint32_t y = row - firstRows[index];
+					uint32_t width = (level.Size.x + 3) / 4;
+
+					uint8_t* blockOutput = level.Output + (size_t)y * width * blockSize;
+					for (uint32_t x = 0; x < width; ++x, blockOutput += blockSize)
+					{
+						LoadBlock(level.Source, level.Size, channels, x, y, block);
+						encode(block, quality, blockOutput);
+					}
+				}
+			};
+
+			// At least eight rows each, small images aren't worth starting a thread for
+			if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1u);
+			threads = std::clamp((rows + 7) / 8, 1u, threads);
+
+			std::vector<std::thread> workers;
+			for (uint32_t i = 1; i < threads; ++i)
+				workers.emplace_back(work);
+
+			work();
+			for (std::thread& worker : workers)
+				worker.join();
+		}
+
+		bool EncodeBlocks(const void* data, const glm::uvec2& size, uint32_t channels, ImageFormat format, void* output, TextureCompression quality, uint32_t threads)
+		{
+			AGI_PROFILE_SCOPE("Utils::EncodeBlocks");
+
+			EncodeBlockFn encode = GetBlockEncoder(format);
+			if (!encode)
+			{
+				AGI_ERROR("The block encoder only writes BC1, BC3, BC4, BC5 and ETC2");
+				return false;
+			}
+
+			if (channels == 0 || channels > 4 || size.x == 0 || size.y == 0)
+			{
+				AGI_ERROR("Block encoder input must be 1 to 4 channels of 8 bit data");
+				return false;
+			}
+
+			EncodeLevels({ { (const uint8_t*)data, size, (uint8_t*)output } }, channels, format, quality, threads);
+			return true;
+		}
+
+		MipChain EncodeMipChain(const MipChain& chain, uint32_t channels, ImageFormat format, TextureCompression quality, uint32_t threads)
+		{
+			AGI_PROFILE_SCOPE("Utils::EncodeMipChain");
+
+			if (!CanEncode(format))
+			{
+				AGI_ERROR("The block encoder only writes BC1, BC3, BC4, BC5 and ETC2");
+				return {};
+			}
+
+			if (channels == 0 || channels > 4)
+			{
+				AGI_ERROR("Block encoder input must be 1 to 4 channels of 8 bit data");
+				return {};
+			}
+
+			MipChain result;
+			uint32_t offset = 0;
+			for (const MipLevel& source : chain.Levels)
+			{
+				if (source.Size.x == 0 || source.Size.y == 0 || source.Datasize != source.Size.x * source.Size.y * channels)
+				{
+					AGI_ERROR("Mip level {}x{} isn't tightly packed {} channel 8 bit data", source.Size.x, source.Size.y, channels);
+					return {};
+				}
+
+				MipLevel& level = result.Levels.emplace_back();
+				level.Size = source.Size;
+				level.Offset = offset;
+				level.Datasize = ((source.Size.x + 3) / 4) * ((source.Size.y + 3) / 4) * GetBlockSize(format);
+
+				offset += level.Datasize;
+			}
+
+			result.Data.resize(offset);
+
+			std::vector<EncodeLevel> levels;
+			for (uint32_t mip = 0; mip < result.Levels.size(); ++mip)
+				levels.push_back({ (const uint8_t*)chain.GetData(mip), chain.Levels[mip].Size, (uint8_t*)result.GetData(mip) });
+
+			EncodeLevels(levels, channels, format, quality, threads);
+			return result;
+		}
+
+	}
+
+	Texture RenderContext::CreateCompressedTexture(const TextureSpecification& spec)
+	{
+		AGI_PROFILE_SCOPE("RenderContext::CreateCompressedTexture");
+
+		TextureSpecification uncompressed = spec;
+		uncompressed.Compression = TextureCompression::None;
+
+		if (!spec.Data || spec.BytesPerChannel != 8 || Utils::IsCompressed(spec.Format))
+		{
+			AGI_WARN("Only textures created with 8 bit Data can be compressed, creating it uncompressed");
+			return CreateTexture(uncompressed);
+		}
+
+		// Mip chains are built for single images, layered textures are encoded offline
+		if (spec.Type != TextureType::Texture2D)
+		{
+			AGI_WARN("Only 2D textures can be compressed on creation, load layered ones from KTX2 files instead");
+			return CreateTexture(uncompressed);
+		}
+
+		ImageFormat format = ImageFormat::RGBA;
+		switch (spec.Format)
+		{
+		case ImageFormat::RED:  format = ChooseFormat({ ImageFormat::BC4 }); break;
+		case ImageFormat::RG:   format = ChooseFormat({ ImageFormat::BC5 }); break;
+		case ImageFormat::RGB:  format = ChooseFormat({ ImageFormat::BC1, ImageFormat::ETC2_RGB }); break;
+		case ImageFormat::RGBA: format = ChooseFormat({ ImageFormat::BC3, ImageFormat::ETC2_RGBA }); break;
+		default: break;
+		}
+
+		if (!Utils::IsCompressed(format))
+		{
+			AGI_WARN("This device can't sample any format {} channel textures compress to, creating it uncompressed", Utils::ImageFormatToChannels(spec.Format));
+			return CreateTexture(uncompressed);
+		}
+
+		auto create = [&]() -> Texture
+		{
+			// Compressed textures can't generate mips on the GPU, they're built here before encoding
+			TextureSpecification source = uncompressed;
+			if (!spec.GenerateMips) source.MipLevels = 1;
+
+			uint32_t channels = Utils::ImageFormatToChannels(spec.Format);
+			MipChain chain = Utils::EncodeMipChain(Utils::GenerateMipChain(source), channels, format, spec.Compression);
+			if (chain.Levels.empty()) return nullptr;
+
+			TextureSpecification compressed = uncompressed;
+			compressed.Format = format;
+			compressed.GenerateMips = false;
+			compressed.MipLevels = (uint32_t)chain.Levels.size();
+			compressed.Data = nullptr;
+			compressed.Datasize = 0;
+
+			Texture texture = CreateTexture(compressed);
+			if (!texture) return nullptr;
+
+			for (uint32_t mip = 0; mip < chain.Levels.size(); ++mip)
+				texture->SetMipData(mip, chain.GetData(mip), chain.Levels[mip].Datasize);
+
+			return texture;
+		};
+
+		// Keyed by the uncompressed data, equal sources are only encoded once
+		if (!m_ResourceCache->IsEnabled()) return create();
+		return m_ResourceCache->GetOrCreate<TextureBase>(ResourceCache::Kind::Texture, ResourceCache::GetKey(spec), spec.Datasize, create);
+	}
+
+}
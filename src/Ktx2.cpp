@@ -0,0 +1,343 @@
+#include "agipch.hpp"
+#include "AGI/Ktx2.hpp"
+#include "AGI/RenderContext.hpp"
+
+#include <fstream>
+#include <zstd.h>
+
+#ifdef AGI_ZLIB
+	#include <zlib.h>
+#endif
+
+namespace AGI {
+
+	namespace Utils {
+
+		struct Ktx2Header
+		{
+			uint8_t Identifier[12];
+			uint32_t VkFormat;
+			uint32_t TypeSize;
+			uint32_t PixelWidth;
+			uint32_t PixelHeight;
+			uint32_t PixelDepth;
+			uint32_t LayerCount;
+			uint32_t FaceCount;
+			uint32_t LevelCount;
+			uint32_t SupercompressionScheme;
+
+			uint32_t DfdByteOffset;
+			uint32_t DfdByteLength;
+			uint32_t KvdByteOffset;
+			uint32_t KvdByteLength;
+			uint64_t SgdByteOffset;
+			uint64_t SgdByteLength;
+		};
+
+		struct Ktx2Level
+		{
+			uint64_t ByteOffset;
+			uint64_t ByteLength;
+			uint64_t UncompressedByteLength;
+		};
+
+		static_assert(sizeof(Ktx2Header) == 80 && sizeof(Ktx2Level) == 24, "KTX2 structures must match the file layout");
+
+		enum class Ktx2Supercompression : uint32_t
+		{
+			None = 0, BasisLZ, Zstandard, ZLIB
+		};
+
+		struct Ktx2Format
+		{
+			uint32_t VkFormat; // Numeric VkFormat, so the loader doesn't depend on the Vulkan headers
+			ImageFormat Format;
+			uint16_t BytesPerChannel;
+			bool SRGB;
+		};
+
+		static constexpr Ktx2Format s_Ktx2Formats[] = {
+			{ 9,   ImageFormat::RED,       8,  false }, // R8_UNORM
+			{ 16,  ImageFormat::RG,        8,  false }, // R8G8_UNORM
+			{ 23,  ImageFormat::RGB,       8,  false }, // R8G8B8_UNORM
+			{ 29,  ImageFormat::RGB,       8,  true  }, // R8G8B8_SRGB
+			{ 37,  ImageFormat::RGBA,      8,  false }, // R8G8B8A8_UNORM
+			{ 43,  ImageFormat::RGBA,      8,  true  }, // R8G8B8A8_SRGB
+			{ 76,  ImageFormat::RED,       16, false }, // R16_SFLOAT
+			{ 83,  ImageFormat::RG,        16, false }, // R16G16_SFLOAT
+			{ 90,  ImageFormat::RGB,       16, false }, // R16G16B16_SFLOAT
+			{ 97,  ImageFormat::RGBA,      16, false }, // R16G16B16A16_SFLOAT
+			{ 100, ImageFormat::RED,       32, false }, // R32_SFLOAT
+			{ 103, ImageFormat::RG,        32, false }, // R32G32_SFLOAT
+			{ 106, ImageFormat::RGB,       32, false }, // R32G32B32_SFLOAT
+			{ 109, ImageFormat::RGBA,      32, false }, // R32G32B32A32_SFLOAT
+			{ 131, ImageFormat::BC1,       8,  false }, // BC1_RGB_UNORM_BLOCK
+			{ 132, ImageFormat::BC1,       8,  true  }, // BC1_RGB_SRGB_BLOCK
+			{ 135, ImageFormat::BC2,       8,  false }, // BC2_UNORM_BLOCK
+			{ 136, ImageFormat::BC2,       8,  true  }, // BC2_SRGB_BLOCK
+			{ 137, ImageFormat::BC3,       8,  false }, // BC3_UNORM_BLOCK
+			{ 138, ImageFormat::BC3,       8,  true  }, // BC3_SRGB_BLOCK
+			{ 139, ImageFormat::BC4,       8,  false }, // BC4_UNORM_BLOCK
+			{ 141, ImageFormat::BC5,       8,  false }, // BC5_UNORM_BLOCK
+			{ 143, ImageFormat::BC6H,      8,  false }, // BC6H_UFLOAT_BLOCK
+			{ 145, ImageFormat::BC7,       8,  false }, // BC7_UNORM_BLOCK
+			{ 146, ImageFormat::BC7,       8,  true  }, // BC7_SRGB_BLOCK
+			{ 147, ImageFormat::ETC2_RGB,  8,  false }, // ETC2_R8G8B8_UNORM_BLOCK
+			{ 148, ImageFormat::ETC2_RGB,  8,  true  }, // ETC2_R8G8B8_SRGB_BLOCK
+			{ 151, ImageFormat::ETC2_RGBA, 8,  false }, // ETC2_R8G8B8A8_UNORM_BLOCK
+			{ 152, ImageFormat::ETC2_RGBA, 8,  true  }, // ETC2_R8G8B8A8_SRGB_BLOCK
+			{ 157, ImageFormat::ASTC_4x4,  8,  false }, // ASTC_4x4_UNORM_BLOCK
+			{ 158, ImageFormat::ASTC_4x4,  8,  true  }, // ASTC_4x4_SRGB_BLOCK
+			{ 171, ImageFormat::ASTC_8x8,  8,  false }, // ASTC_8x8_UNORM_BLOCK
+			{ 172, ImageFormat::ASTC_8x8,  8,  true  }, // ASTC_8x8_SRGB_BLOCK
+		};
+
+		// The sizes current GPUs sample, anything larger is treated as a corrupt header
+		static constexpr uint32_t s_Ktx2MaxSize = 16384;
+		static constexpr uint32_t s_Ktx2MaxLayers = 2048;
+
+		// Level offsets and sizes are 32 bit, this also stops a small supercompressed
+		// file from claiming gigabytes
+		static constexpr uint64_t s_Ktx2MaxBytes = UINT32_MAX;
+
+		// GetLevelDatasize() in 64 bits, the header's sizes aren't trusted yet
+		static uint64_t GetKtx2LevelSize(const TextureSpecification& spec, uint32_t mip)
+		{
+			glm::uvec2 size = GetMipSize(spec.Size, mip);
+			uint64_t rowSize = (uint64_t)size.x * GetBytesPerPixel(spec);
+			uint64_t rows = size.y;
+
+			if (IsCompressed(spec.Format))
+			{
+				glm::uvec2 block = GetBlockExtent(spec.Format);
+				rowSize = (uint64_t)(size.x + block.x - 1) / block.x * GetBlockSize(spec.Format);
+				rows = (size.y + block.y - 1) / block.y;
+			}
+
+			return rowSize * rows * GetLayerCount(spec, mip);
+		}
+
+		static bool InflateKtx2Level(Ktx2Supercompression scheme, std::span<const uint8_t> source, void* destination, uint32_t size)
+		{
+			switch (scheme)
+			{
+			case Ktx2Supercompression::None:
+			{
+				if (source.size() != size) return false;
+
+				std::memcpy(destination, source.data(), size);
+				return true;
+			}
+			case Ktx2Supercompression::Zstandard:
+			{
+				size_t written = ZSTD_decompress(destination, size, source.data(), source.size());
+				if (ZSTD_isError(written))
+				{
+					AGI_ERROR("Zstandard: {}", ZSTD_getErrorName(written));
+					return false;
+				}
+
+				return written == size;
+			}
+			case Ktx2Supercompression::ZLIB:
+			{
+#ifdef AGI_ZLIB
+				uLongf written = size;
+				return uncompress((Bytef*)destination, &written, source.data(), source.size()) == Z_OK && written == size;
+#else
+				AGI_ERROR("AGI was built without zlib, ZLIB supercompressed KTX2 files can't be read");
+				return false;
+#endif
+			}
+			default:
+				AGI_ERROR("Unknown KTX2 supercompression scheme {}", (uint32_t)scheme);
+				return false;
+			}
+		}
+
+		bool LoadKtx2(std::span<const uint8_t> data, Ktx2Image& image)
+		{
+			AGI_PROFILE_SCOPE("Utils::LoadKtx2");
+
+			static constexpr uint8_t identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+			Ktx2Header header;
+			if (data.size() < sizeof(header) || std::memcmp(data.data(), identifier, sizeof(identifier)) != 0)
+			{
+				AGI_ERROR("Data isn't a KTX2 file");
+				return false;
+			}
+
+			std::memcpy(&header, data.data(), sizeof(header));
+
+			auto scheme = (Ktx2Supercompression)header.SupercompressionScheme;
+			if (scheme == Ktx2Supercompression::BasisLZ || header.VkFormat == 0)
+			{
+				AGI_ERROR("Basis Universal KTX2 files have to be transcoded first");
+				return false;
+			}
+
+			if (header.PixelWidth > s_Ktx2MaxSize || header.PixelHeight > s_Ktx2MaxSize ||
+				header.PixelDepth > s_Ktx2MaxLayers || header.LayerCount > s_Ktx2MaxLayers)
+			{
+				AGI_ERROR("KTX2 size {}x{}x{} with {} layers is larger than any supported texture", header.PixelWidth, header.PixelHeight, header.PixelDepth, header.LayerCount);
+				return false;
+			}
+
+			// Counts of 0 mean the file isn't an array or a volume
+			if (header.PixelWidth == 0 || header.PixelHeight == 0 || (header.FaceCount != 1 && header.FaceCount != 6) || (header.PixelDepth > 0 && (header.LayerCount > 0 || header.FaceCount != 1)))
+			{
+				AGI_ERROR("KTX2 file isn't a 2D, array, cube or 3D texture");
+				return false;
+			}
+
+			const Ktx2Format* format = std::find_if(std::begin(s_Ktx2Formats), std::end(s_Ktx2Formats), [&](const Ktx2Format& f) { return f.VkFormat == header.VkFormat; });
+			if (format == std::end(s_Ktx2Formats))
+			{
+				AGI_ERROR("KTX2 vkFormat {} has no matching ImageFormat", header.VkFormat);
+				return false;
+			}
+
+			// 0 levels asks the loader to generate them
+			uint32_t levelCount = std::max(header.LevelCount, 1u);
+
+			TextureSpecification& spec = image.Specification;
+			spec = {};
+			spec.Size = { header.PixelWidth, header.PixelHeight };
+
+			if (header.PixelDepth > 0)
+			{
+				spec.Type = TextureType::Texture3D;
+				spec.Layers = header.PixelDepth;
+			}
+			else if (header.FaceCount == 6)
+			{
+				spec.Type = header.LayerCount > 0 ? TextureType::CubeArray : TextureType::Cube;
+				spec.Layers = std::max(header.LayerCount, 1u);
+			}
+			else if (header.LayerCount > 0)
+			{
+				spec.Type = TextureType::Texture2DArray;
+				spec.Layers = header.LayerCount;
+			}
+
+			spec.Format = format->Format;
+			spec.BytesPerChannel = format->BytesPerChannel;
+			spec.SRGB = format->SRGB;
+
+			// 3D textures count their depth too
+			spec.MipLevels = FullMipChain;
+			uint32_t maxLevels = CalculateMipLevels(spec);
+			if (levelCount > maxLevels)
+			{
+				AGI_ERROR("KTX2 file has {} levels, the texture can have at most {}", levelCount, maxLevels);
+				return false;
+			}
+
+			spec.MipLevels = levelCount;
+			spec.GenerateMips = header.LevelCount == 0 && !IsCompressed(spec.Format);
+			if (spec.GenerateMips) spec.MipLevels = FullMipChain;
+
+			if (sizeof(Ktx2Header) + (uint64_t)levelCount * sizeof(Ktx2Level) > data.size())
+			{
+				AGI_ERROR("KTX2 level index is truncated");
+				return false;
+			}
+
+			MipChain& chain = image.Chain;
+			chain = {};
+
+			// Everything is checked against the file before allocating
+			const Ktx2Level* levels = (const Ktx2Level*)(data.data() + sizeof(Ktx2Header));
+			uint64_t offset = 0;
+			for (uint32_t mip = 0; mip < levelCount; ++mip)
+			{
+				Ktx2Level entry;
+				std::memcpy(&entry, &levels[mip], sizeof(entry));
+
+				uint64_t datasize = GetKtx2LevelSize(spec, mip); // Layers, then faces, then depth slices, as in the file
+				if (offset + datasize > s_Ktx2MaxBytes)
+				{
+					AGI_ERROR("KTX2 levels need more than {} bytes", s_Ktx2MaxBytes);
+					return false;
+				}
+
+				if (entry.ByteOffset > data.size() || entry.ByteLength > data.size() - entry.ByteOffset)
+				{
+					AGI_ERROR("KTX2 level {} is outside the file", mip);
+					return false;
+				}
+
+				if (scheme == Ktx2Supercompression::None && entry.ByteLength != datasize)
+				{
+					AGI_ERROR("KTX2 level {} holds {} bytes, a {}x{} level needs {}", mip, entry.ByteLength, GetMipSize(spec.Size, mip).x, GetMipSize(spec.Size, mip).y, datasize);
+					return false;
+				}
+
+				MipLevel& level = chain.Levels.emplace_back();
+				level.Size = GetMipSize(spec.Size, mip);
+				level.Offset = (uint32_t)offset;
+				level.Datasize = (uint32_t)datasize;
+
+				offset += datasize;
+			}
+
+			chain.Data.resize(offset);
+
+			for (uint32_t mip = 0; mip < levelCount; ++mip)
+			{
+				Ktx2Level level;
+				std::memcpy(&level, &levels[mip], sizeof(level));
+
+				std::span<const uint8_t> source = data.subspan(level.ByteOffset, level.ByteLength);
+				if (!InflateKtx2Level(scheme, source, chain.GetData(mip), chain.Levels[mip].Datasize))
+				{
+					AGI_ERROR("KTX2 level {} doesn't hold the {} bytes a {}x{} level needs", mip, chain.Levels[mip].Datasize, chain.Levels[mip].Size.x, chain.Levels[mip].Size.y);
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool LoadKtx2(const std::filesystem::path& path, Ktx2Image& image)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file)
+			{
+				AGI_ERROR("Could not open KTX2 file \"{}\"", path.string());
+				return false;
+			}
+
+			std::vector<uint8_t> data(file.tellg());
+			file.seekg(0);
+			file.read((char*)data.data(), data.size());
+
+			return LoadKtx2(data, image);
+		}
+
+	}
+
+	Texture RenderContext::CreateTexture(const Ktx2Image& image)
+	{
+		AGI_PROFILE_SCOPE("RenderContext::CreateTexture");
+
+		if (!IsFormatSupported(image.Specification.Format))
+		{
+			AGI_ERROR("This device can't sample the KTX2 texture's format, load a variant picked with ChooseFormat()");
+			return nullptr;
+		}
+
+		Texture texture = CreateTexture(image.Specification);
+		if (!texture) return nullptr;
+
+		for (uint32_t mip = 0; mip < image.Chain.Levels.size(); ++mip)
+			texture->SetMipData(mip, (void*)image.Chain.GetData(mip), image.Chain.Levels[mip].Datasize);
+
+		if (image.Specification.GenerateMips)
+			texture->GenerateMips();
+
+		return texture;
+	}
+
+}
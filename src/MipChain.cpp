@@ -0,0 +1,366 @@
+#include "agipch.hpp"
+#include "AGI/MipChain.hpp"
+
+#include "Simd.hpp"
+
+#include <cmath>
+#include <numbers>
+
+namespace AGI {
+
+	namespace Utils {
+
+		// Every level is filtered as linear RGBA floats, one SIMD register per pixel
+		struct MipImage
+		{
+			glm::uvec2 Size;
+			std::vector<Simd::Float4> Pixels;
+		};
+
+		struct MipPixelFormat
+		{
+			uint32_t Channels = 4;
+			bool Float = false;
+			bool SRGB = false;
+
+			// Alpha is always linear
+			bool IsColour(uint32_t channel) const { return SRGB && (Channels < 4 || channel < 3); }
+		};
+
+		static float SrgbToLinear(float value)
+		{
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		// Decoding is a lookup, encoding searches the linear values halfway between
+		// two codes, so a round trip never shifts a value by even one step
+		struct SrgbTables
+		{
+			float Decode[256];
+			float Encode[255];
+
+			SrgbTables()
+			{
+				for (uint32_t i = 0; i < 256; ++i) Decode[i] = SrgbToLinear(i / 255.0f);
+				for (uint32_t i = 0; i < 255; ++i) Encode[i] = SrgbToLinear((i + 0.5f) / 255.0f);
+			}
+		};
+
+		static const SrgbTables& GetSrgbTables()
+		{
+			static SrgbTables tables;
+			return tables;
+		}
+
+		static MipImage Decode(const void* data, const glm::uvec2& size, const MipPixelFormat& format)
+		{
+			const SrgbTables& srgb = GetSrgbTables();
+
+			MipImage image;
+			image.Size = size;
+			image.Pixels.resize((size_t)size.x * size.y);
+
+			const uint8_t* bytes = (const uint8_t*)data;
+			const float* floats = (const float*)data;
+
+			for (size_t i = 0; i < image.Pixels.size(); ++i)
+			{
+				float pixel[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+				for (uint32_t c = 0; c < format.Channels; ++c)
+				{
+					size_t index = i * format.Channels + c;
+
+					if (format.Float)              pixel[c] = floats[index];
+					else if (format.IsColour(c))   pixel[c] = srgb.Decode[bytes[index]];
+					else                           pixel[c] = bytes[index] / 255.0f;
+				}
+
+				image.Pixels[i] = Simd::Float4::Load(pixel);
+			}
+
+			return image;
+		}
+
+		static void Encode(const MipImage& image, void* data, const MipPixelFormat& format)
+		{
+			const SrgbTables& srgb = GetSrgbTables();
+
+			uint8_t* bytes = (uint8_t*)data;
+			float* floats = (float*)data;
+
+			for (size_t i = 0; i < image.Pixels.size(); ++i)
+			{
+				float pixel[4];
+				image.Pixels[i].Store(pixel);
+
+				for (uint32_t c = 0; c < format.Channels; ++c)
+				{
+					size_t index = i * format.Channels + c;
+
+					if (format.Float)
+						floats[index] = pixel[c];
+					else if (format.IsColour(c))
+						bytes[index] = std::upper_bound(std::begin(srgb.Encode), std::end(srgb.Encode), pixel[c]) - std::begin(srgb.Encode);
+					else
+						bytes[index] = (uint8_t)std::clamp(pixel[c] * 255.0f + 0.5f, 0.0f, 255.0f);
+				}
+			}
+		}
+
+		struct FilterTaps
+		{
+			std::vector<uint32_t> Index;
+			std::vector<float> Weight;
+		};
+
+		static double BesselI0(double x)
+		{
+			double sum = 1.0, term = 1.0;
+			for (uint32_t k = 1; term > sum * 1e-12; ++k)
+			{
+				term *= (x / (2.0 * k)) * (x / (2.0 * k));
+				sum += term;
+			}
+
+			return sum;
+		}
+
+		// Kaiser windowed sinc, three lobes either side measured in output pixels
+		static std::vector<FilterTaps> GetKaiserTaps(uint32_t sourceSize, uint32_t resultSize)
+		{
+			constexpr double radius = 3.0, alpha = 4.0;
+			double scale = (double)sourceSize / resultSize;
+			double normalise = 1.0 / BesselI0(alpha);
+
+			std::vector<FilterTaps> taps(resultSize);
+			for (uint32_t x = 0; x < resultSize; ++x)
+			{
+				double centre = (x + 0.5) * scale;
+				int32_t first = (int32_t)std::floor(centre - radius * scale);
+				int32_t last = (int32_t)std::ceil(centre + radius * scale);
+
+				double total = 0.0;
+				std::vector<double> weights;
+				for (int32_t i = first; i <= last; ++i)
+				{
+					double t = (i + 0.5 - centre) / scale;
+					if (std::abs(t) >= radius) continue;
+
+					double sinc = t == 0.0 ? 1.0 : std::sin(std::numbers::pi * t) / (std::numbers::pi * t);
+					double window = BesselI0(alpha * std::sqrt(1.0 - (t / radius) * (t / radius))) * normalise;
+
+					// Edges are clamped, samples past them count towards the border pixel
+					taps[x].Index.push_back(std::clamp(i, 0, (int32_t)sourceSize - 1));
+					weights.push_back(sinc * window);
+					total += sinc * window;
+				}
+
+				for (double weight : weights)
+					taps[x].Weight.push_back((float)(weight / total));
+			}
+
+			return taps;
+		}
+
+		// Box filter for odd sizes, where 2x2 blocks don't line up. Every output pixel
+		// averages the source pixels it overlaps, weighted by how much of them it covers.
+		static std::vector<FilterTaps> GetBoxTaps(uint32_t sourceSize, uint32_t resultSize)
+		{
+			double scale = (double)sourceSize / resultSize;
+
+			std::vector<FilterTaps> taps(resultSize);
+			for (uint32_t x = 0; x < resultSize; ++x)
+			{
+				double start = x * scale, end = (x + 1) * scale;
+				for (uint32_t i = (uint32_t)start; i < sourceSize && i < end; ++i)
+				{
+					double coverage = std::min<double>(end, i + 1) - std::max<double>(start, i);
+					if (coverage <= 0.0) continue;
+
+					taps[x].Index.push_back(i);
+					taps[x].Weight.push_back((float)(coverage / scale));
+				}
+			}
+
+			return taps;
+		}
+
+		static std::vector<FilterTaps> GetTaps(MipFilter filter, uint32_t sourceSize, uint32_t resultSize)
+		{
+			return filter == MipFilter::Kaiser ? GetKaiserTaps(sourceSize, resultSize) : GetBoxTaps(sourceSize, resultSize);
+		}
+
+		static MipImage DownsampleSeparable(const MipImage& source, const glm::uvec2& size, const std::vector<FilterTaps>& horizontal, const std::vector<FilterTaps>& vertical)
+		{
+			// Rows first into a half width image, then columns
+			std::vector<Simd::Float4> rows((size_t)size.x * source.Size.y);
+			for (uint32_t y = 0; y < source.Size.y; ++y)
+			{
+				const Simd::Float4* input = &source.Pixels[(size_t)y * source.Size.x];
+				Simd::Float4* output = &rows[(size_t)y * size.x];
+
+				for (uint32_t x = 0; x < size.x; ++x)
+				{
+					const FilterTaps& taps = horizontal[x];
+
+					Simd::Float4 sum;
+					for (size_t i = 0; i < taps.Index.size(); ++i)
+						sum += input[taps.Index[i]] * taps.Weight[i];
+
+					output[x] = sum;
+				}
+			}
+
+			MipImage result;
+			result.Size = size;
+			result.Pixels.resize((size_t)size.x * size.y);
+
+			for (uint32_t y = 0; y < size.y; ++y)
+			{
+				const FilterTaps& taps = vertical[y];
+				Simd::Float4* output = &result.Pixels[(size_t)y * size.x];
+
+				for (uint32_t x = 0; x < size.x; ++x)
+				{
+					Simd::Float4 sum;
+					for (size_t i = 0; i < taps.Index.size(); ++i)
+						sum += rows[(size_t)taps.Index[i] * size.x + x] * taps.Weight[i];
+
+					output[x] = sum;
+				}
+			}
+
+			return result;
+		}
+
+		static MipImage DownsampleBox(const MipImage& source)
+		{
+			MipImage result;
+			result.Size = glm::max(source.Size / 2u, glm::uvec2(1));
+
+			bool oddX = source.Size.x > 1 && source.Size.x % 2;
+			bool oddY = source.Size.y > 1 && source.Size.y % 2;
+			if (oddX || oddY)
+				return DownsampleSeparable(source, result.Size, GetBoxTaps(source.Size.x, result.Size.x), GetBoxTaps(source.Size.y, result.Size.y));
+
+			result.Pixels.resize((size_t)result.Size.x * result.Size.y);
+
+			// Even sizes average 2x2 blocks, a side of 1 is clamped and averages with itself
+			for (uint32_t y = 0; y < result.Size.y; ++y)
+			{
+				const Simd::Float4* row0 = &source.Pixels[(size_t)std::min(y * 2, source.Size.y - 1) * source.Size.x];
+				const Simd::Float4* row1 = &source.Pixels[(size_t)std::min(y * 2 + 1, source.Size.y - 1) * source.Size.x];
+				Simd::Float4* output = &result.Pixels[(size_t)y * result.Size.x];
+
+				for (uint32_t x = 0; x < result.Size.x; ++x)
+				{
+					uint32_t x0 = std::min(x * 2, source.Size.x - 1);
+					uint32_t x1 = std::min(x * 2 + 1, source.Size.x - 1);
+
+					output[x] = (row0[x0] + row0[x1] + row1[x0] + row1[x1]) * 0.25f;
+				}
+			}
+
+			return result;
+		}
+
+		static MipImage DownsampleKaiser(const MipImage& source)
+		{
+			glm::uvec2 size = glm::max(source.Size / 2u, glm::uvec2(1));
+			return DownsampleSeparable(source, size, GetKaiserTaps(source.Size.x, size.x), GetKaiserTaps(source.Size.y, size.y));
+		}
+
+		// 3D textures lose depth too, each output slice blends the slices below it
+		static std::vector<MipImage> DownsampleDepth(const std::vector<MipImage>& slices, uint32_t depth, MipFilter filter)
+		{
+			std::vector<FilterTaps> taps = GetTaps(filter, (uint32_t)slices.size(), depth);
+
+			std::vector<MipImage> result(depth);
+			for (uint32_t z = 0; z < depth; ++z)
+			{
+				result[z].Size = slices[0].Size;
+				result[z].Pixels.resize(slices[0].Pixels.size());
+
+				for (size_t p = 0; p < result[z].Pixels.size(); ++p)
+				{
+					Simd::Float4 sum;
+					for (size_t i = 0; i < taps[z].Index.size(); ++i)
+						sum += slices[taps[z].Index[i]].Pixels[p] * taps[z].Weight[i];
+
+					result[z].Pixels[p] = sum;
+				}
+			}
+
+			return result;
+		}
+
+		MipChain GenerateMipChain(const TextureSpecification& spec, MipFilter filter)
+		{
+			AGI_PROFILE_SCOPE("Utils::GenerateMipChain");
+
+			if (Utils::IsCompressed(spec.Format) || (spec.BytesPerChannel != 8 && spec.BytesPerChannel != 32))
+			{
+				AGI_ERROR("Mip chains can only be built from 8 bit or 32 bit float data");
+				return {};
+			}
+
+			MipPixelFormat format;
+			format.Channels = ImageFormatToChannels(spec.Format);
+			format.Float = spec.BytesPerChannel == 32;
+			format.SRGB = spec.SRGB && !format.Float;
+
+			uint64_t expected = GetLevelDatasize(spec, 0);
+			if (!spec.Data || spec.Datasize != expected)
+			{
+				AGI_ERROR("Mip chain source must be every layer of level 0, expected {} bytes but got {}", expected, spec.Datasize);
+				return {};
+			}
+
+			uint32_t levels = CalculateMipLevels(spec);
+
+			MipChain chain;
+			uint32_t offset = 0;
+			for (uint32_t mip = 0; mip < levels; ++mip)
+			{
+				MipLevel& level = chain.Levels.emplace_back();
+				level.Size = GetMipSize(spec.Size, mip);
+				level.Offset = offset;
+				level.Datasize = GetLevelDatasize(spec, mip); // Layers and faces back to back, like SetMipData() reads them
+
+				offset += level.Datasize;
+			}
+
+			chain.Data.resize(offset);
+			std::memcpy(chain.Data.data(), spec.Data, spec.Datasize);
+			if (levels == 1) return chain;
+
+			// Array layers and cube faces are filtered on their own, 3D slices are blended
+			uint32_t layers = GetLayerCount(spec, 0);
+			uint32_t layerSize = chain.Levels[0].Datasize / layers;
+
+			std::vector<MipImage> images(layers);
+			for (uint32_t layer = 0; layer < layers; ++layer)
+				images[layer] = Decode((const uint8_t*)spec.Data + (size_t)layer * layerSize, spec.Size, format);
+
+			// Each level is filtered from the previous one before it was quantised
+			for (uint32_t mip = 1; mip < levels; ++mip)
+			{
+				for (MipImage& image : images)
+					image = filter == MipFilter::Kaiser ? DownsampleKaiser(image) : DownsampleBox(image);
+
+				uint32_t depth = GetLayerCount(spec, mip);
+				if (spec.Type == TextureType::Texture3D && depth != images.size())
+					images = DownsampleDepth(images, depth, filter);
+
+				uint8_t* data = (uint8_t*)chain.GetData(mip);
+				layerSize = chain.Levels[mip].Datasize / (uint32_t)images.size();
+				for (size_t layer = 0; layer < images.size(); ++layer)
+					Encode(images[layer], data + layer * layerSize, format);
+			}
+
+			return chain;
+		}
+
+	}
+
+}
@@ -17,6 +17,8 @@
 
 void* AGI::Window::GetNativeWindow() const
 {
+	if (!m_Window) return nullptr;
+
 #if defined(AGI_WINDOWS)
 	return glfwGetWin32Window(m_Window);
 
@@ -1,5 +1,6 @@
 #include "agipch.hpp"
 #include "OpenGLBuffer.hpp"
+#include "OpenGLRenderContext.hpp"
 
 #include <glad/glad.h>
 
@@ -7,17 +8,21 @@ namespace AGI {
 
 	// VertexBuffer
 
-	OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size)
-		: m_BufferSize(size)
+	OpenGLVertexBuffer::OpenGLVertexBuffer(OpenGLContext* context, uint32_t size)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_BufferSize(size)
 	{
+		m_Stats->ResourcesCreated++;
+
 		glGenBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, m_BufferSize, nullptr, GL_DYNAMIC_DRAW);
 	}
 
-    OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t vertices, const BufferLayout& layout)
-		: m_BufferSize(vertices * layout.GetStride())
+    OpenGLVertexBuffer::OpenGLVertexBuffer(OpenGLContext* context, uint32_t vertices, const BufferLayout& layout)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_BufferSize(vertices * layout.GetStride())
     {
+		m_Stats->ResourcesCreated++;
+
 		SetLayout(layout);
 		
 		glGenBuffers(1, &m_RendererID);
@@ -25,9 +30,13 @@ namespace AGI {
 		glBufferData(GL_ARRAY_BUFFER, m_BufferSize, nullptr, GL_DYNAMIC_DRAW);
     }
 
-    OpenGLVertexBuffer::OpenGLVertexBuffer(float* vertices, uint32_t size)
-		: m_BufferSize(size)
+    OpenGLVertexBuffer::OpenGLVertexBuffer(OpenGLContext* context, const void* vertices, uint32_t size, const BufferLayout& layout)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_BufferSize(size)
 	{
+		m_Stats->ResourcesCreated++;
+
+		SetLayout(layout);
+
 		glGenBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, m_BufferSize, vertices, GL_STATIC_DRAW);
@@ -35,6 +44,7 @@ namespace AGI {
 
 	OpenGLVertexBuffer::~OpenGLVertexBuffer()
 	{
+		m_Stats->ResourcesDestroyed++;
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
@@ -50,15 +60,22 @@ namespace AGI {
 
 	void OpenGLVertexBuffer::SetData(void* data, uint32_t size)
 	{
+		FrameStats& stats = *m_Stats;
+		FrameStatsTimer timer(stats);
+		stats.BytesUploaded += size;
+		DetachFromCache();
+
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
 	}
 
 	// IndexBuffer 
 
-	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t count)
-		: m_Count(count)
+	OpenGLIndexBuffer::OpenGLIndexBuffer(OpenGLContext* context, uint32_t* indices, uint32_t count)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_Count(count)
 	{
+		m_Stats->ResourcesCreated++;
+
 		glGenBuffers(1, &m_RendererID);
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
@@ -66,6 +83,7 @@ namespace AGI {
 
 	OpenGLIndexBuffer::~OpenGLIndexBuffer()
 	{
+		m_Stats->ResourcesDestroyed++;
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
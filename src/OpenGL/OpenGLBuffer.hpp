@@ -4,12 +4,14 @@
 
 namespace AGI {
 
+	class OpenGLContext;
+
 	class OpenGLVertexBuffer : public VertexBufferBase
 	{
 	public:
-		OpenGLVertexBuffer(uint32_t size);
-		OpenGLVertexBuffer(uint32_t vertices, const BufferLayout& layout);
-		OpenGLVertexBuffer(float* vertices, uint32_t size);
+		OpenGLVertexBuffer(OpenGLContext* context, uint32_t size);
+		OpenGLVertexBuffer(OpenGLContext* context, uint32_t vertices, const BufferLayout& layout);
+		OpenGLVertexBuffer(OpenGLContext* context, const void* vertices, uint32_t size, const BufferLayout& layout);
 		virtual ~OpenGLVertexBuffer();
 
 		virtual void Bind() const override;
@@ -21,6 +23,9 @@ namespace AGI {
 		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
 		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
 	private:
+		OpenGLContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
 		uint32_t m_BufferSize;
 		uint32_t m_RendererID;
 		BufferLayout m_Layout;
@@ -29,7 +34,7 @@ namespace AGI {
 	class OpenGLIndexBuffer : public IndexBufferBase
 	{
 	public:
-		OpenGLIndexBuffer(uint32_t* indices, uint32_t count);
+		OpenGLIndexBuffer(OpenGLContext* context, uint32_t* indices, uint32_t count);
 		virtual ~OpenGLIndexBuffer();
 
 		virtual void Bind() const;
@@ -37,6 +42,9 @@ namespace AGI {
 
 		virtual uint32_t GetCount() const { return m_Count; }
 	private:
+		OpenGLContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
 		uint32_t m_RendererID;
 		uint32_t m_Count;
 	};
@@ -0,0 +1,74 @@
+#include "agipch.hpp"
+#include "OpenGLExtensions.hpp"
+
+namespace AGI {
+
+	void OpenGLExtensions::Load(GLADloadproc loader)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+		s_Extensions.clear();
+		for (GLint i = 0; i < count; ++i)
+			s_Extensions.emplace_back((const char*)glGetStringi(GL_EXTENSIONS, i));
+
+		// The KHR and ARB versions share tokens, only the entry point name differs
+		if (IsSupported("GL_KHR_parallel_shader_compile"))
+			MaxShaderCompilerThreads = (decltype(MaxShaderCompilerThreads))loader("glMaxShaderCompilerThreadsKHR");
+		else if (IsSupported("GL_ARB_parallel_shader_compile"))
+			MaxShaderCompilerThreads = (decltype(MaxShaderCompilerThreads))loader("glMaxShaderCompilerThreadsARB");
+
+		ParallelShaderCompile = MaxShaderCompilerThreads != nullptr;
+
+		if (GLAD_GL_VERSION_4_6)
+			SpecializeShader = glad_glSpecializeShader;
+		else if (IsSupported("GL_ARB_gl_spirv"))
+			SpecializeShader = (decltype(SpecializeShader))loader("glSpecializeShaderARB");
+
+		GlSpirv = SpecializeShader != nullptr;
+
+		// The ARB entry points have the core names
+		TexStorage2D = nullptr;
+		TexStorage3D = nullptr;
+		if (GLAD_GL_VERSION_4_2)
+		{
+			TexStorage2D = glad_glTexStorage2D;
+			TexStorage3D = glad_glTexStorage3D;
+		}
+		else if (IsSupported("GL_ARB_texture_storage"))
+		{
+			TexStorage2D = (decltype(TexStorage2D))loader("glTexStorage2D");
+			TexStorage3D = (decltype(TexStorage3D))loader("glTexStorage3D");
+		}
+
+		TextureStorage = TexStorage2D && TexStorage3D;
+
+		// All three share the same tokens
+		MaxAnisotropy = 1.0f;
+		if (GLAD_GL_VERSION_4_6 || IsSupported("GL_ARB_texture_filter_anisotropic") || IsSupported("GL_EXT_texture_filter_anisotropic"))
+			glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &MaxAnisotropy);
+
+		TextureCompressionS3TC = IsSupported("GL_EXT_texture_compression_s3tc");
+		TextureCompressionBPTC = GLAD_GL_VERSION_4_2 || IsSupported("GL_ARB_texture_compression_bptc");
+		TextureCompressionETC2 = GLAD_GL_VERSION_4_3 || IsSupported("GL_ARB_ES3_compatibility");
+		TextureCompressionASTC = IsSupported("GL_KHR_texture_compression_astc_ldr");
+
+		GetTextureHandle = nullptr;
+		MakeTextureHandleResident = nullptr;
+		MakeTextureHandleNonResident = nullptr;
+		if (IsSupported("GL_ARB_bindless_texture"))
+		{
+			GetTextureHandle = (decltype(GetTextureHandle))loader("glGetTextureHandleARB");
+			MakeTextureHandleResident = (decltype(MakeTextureHandleResident))loader("glMakeTextureHandleResidentARB");
+			MakeTextureHandleNonResident = (decltype(MakeTextureHandleNonResident))loader("glMakeTextureHandleNonResidentARB");
+		}
+
+		BindlessTexture = GetTextureHandle && MakeTextureHandleResident && MakeTextureHandleNonResident;
+	}
+
+	bool OpenGLExtensions::IsSupported(std::string_view name)
+	{
+		return std::find(s_Extensions.begin(), s_Extensions.end(), name) != s_Extensions.end();
+	}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Tokens from extensions the generated glad loader doesn't include
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR           0x91B1
+
+// GL_EXT_texture_compression_s3tc, the sRGB versions come from GL_EXT_texture_sRGB
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT           0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT          0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT          0x83F3
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT          0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT    0x8C4E
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT    0x8C4F
+
+// GL_KHR_texture_compression_astc_ldr
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR           0x93B0
+#define GL_COMPRESSED_RGBA_ASTC_8x8_KHR           0x93B7
+#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR   0x93D0
+#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR   0x93D7
+
+namespace AGI {
+
+	// Extensions outside the glad profile, loaded by hand after gladLoadGLLoader()
+	class OpenGLExtensions
+	{
+	public:
+		static void Load(GLADloadproc loader);
+		static bool IsSupported(std::string_view name);
+
+		// GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile
+		static inline bool ParallelShaderCompile = false;
+		static inline void (APIENTRYP MaxShaderCompilerThreads)(GLuint count) = nullptr;
+
+		// Core in 4.6, otherwise GL_ARB_gl_spirv
+		static inline bool GlSpirv = false;
+		static inline PFNGLSPECIALIZESHADERPROC SpecializeShader = nullptr;
+
+		// Core in 4.2, otherwise GL_ARB_texture_storage
+		static inline bool TextureStorage = false;
+		static inline PFNGLTEXSTORAGE2DPROC TexStorage2D = nullptr;
+		static inline PFNGLTEXSTORAGE3DPROC TexStorage3D = nullptr;
+
+		// Core in 4.6, otherwise GL_ARB_texture_filter_anisotropic or GL_EXT_texture_filter_anisotropic
+		static inline float MaxAnisotropy = 1.0f;
+
+		// BC4/BC5 (RGTC) are core, BC6H/BC7 (BPTC) since 4.2 and ETC2 since 4.3
+		static inline bool TextureCompressionS3TC = false;
+		static inline bool TextureCompressionBPTC = false;
+		static inline bool TextureCompressionETC2 = false;
+		static inline bool TextureCompressionASTC = false;
+
+		// GL_ARB_bindless_texture
+		static inline bool BindlessTexture = false;
+		static inline GLuint64 (APIENTRYP GetTextureHandle)(GLuint texture) = nullptr;
+		static inline void (APIENTRYP MakeTextureHandleResident)(GLuint64 handle) = nullptr;
+		static inline void (APIENTRYP MakeTextureHandleNonResident)(GLuint64 handle) = nullptr;
+	private:
+		static inline std::vector<std::string> s_Extensions;
+	};
+
+}
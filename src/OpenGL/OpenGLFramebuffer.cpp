@@ -1,5 +1,7 @@
 #include "agipch.hpp"
 #include "OpenGLFramebuffer.hpp"
+#include "OpenGLRenderContext.hpp"
+#include "OpenGLExtensions.hpp"
 
 #include <glad/glad.h>
 
@@ -63,9 +65,11 @@ namespace AGI {
 
 	static const uint32_t s_MaxFramebufferSize = 8192;
 
-	OpenGLFramebuffer::OpenGLFramebuffer(const FramebufferSpecification& spec)
-		: m_Specifation(spec)
+	OpenGLFramebuffer::OpenGLFramebuffer(OpenGLContext* context, const FramebufferSpecification& spec)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_Specifation(spec)
 	{
+		m_Stats->ResourcesCreated++;
+
 		if (spec.Attachments.size() == 0)
 		{
 			AGI_ERROR("Cannot create Framebuffer with no attachments");
@@ -76,6 +80,8 @@ namespace AGI {
 
 	OpenGLFramebuffer::~OpenGLFramebuffer()
 	{
+		m_Stats->ResourcesDestroyed++;
+
 		if (m_ReadPixel)
 			free(m_ReadPixel);
 
@@ -101,19 +107,32 @@ namespace AGI {
 		{
 			glBindTexture(GL_TEXTURE_2D, m_ColourAttachments[i]);
 
-			glTexImage2D(GL_TEXTURE_2D, 0,
-				Utils::AGITextureTypeToOpenGLInternalType(m_Specifation.Attachments[i]),
-				m_Specifation.Width,
-				m_Specifation.Height,
-				0,
-				Utils::AGITextureTypeToOpenGLType(m_Specifation.Attachments[i]),
-				Utils::AGITextureTypeToOpenGLDataFormat(m_Specifation.Attachments[i]),
-				nullptr
-			);
+			// Resizing recreates the attachments, so they never need mutable storage
+			if (OpenGLExtensions::TextureStorage)
+			{
+				OpenGLExtensions::TexStorage2D(GL_TEXTURE_2D, 1,
+					Utils::AGITextureTypeToOpenGLInternalType(m_Specifation.Attachments[i]),
+					m_Specifation.Width,
+					m_Specifation.Height
+				);
+			}
+			else
+			{
+				glTexImage2D(GL_TEXTURE_2D, 0,
+					Utils::AGITextureTypeToOpenGLInternalType(m_Specifation.Attachments[i]),
+					m_Specifation.Width,
+					m_Specifation.Height,
+					0,
+					Utils::AGITextureTypeToOpenGLType(m_Specifation.Attachments[i]),
+					Utils::AGITextureTypeToOpenGLDataFormat(m_Specifation.Attachments[i]),
+					nullptr
+				);
+			}
 
+			// Attachments are sampled through their raw IDs, so they keep state of their
+			// own. A Sampler bound to the same slot replaces it.
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
@@ -135,18 +154,20 @@ namespace AGI {
 			AGI_ERROR("Framebuffer is incomplete!");
 		}
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_BoundContext->GetDefaultFramebuffer());
 	}
 
 	void OpenGLFramebuffer::Bind()
 	{
+		m_Stats->FramebufferSwitches++;
 		glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
 		glViewport(0, 0, m_Specifation.Width, m_Specifation.Height);
 	}
 
 	void OpenGLFramebuffer::Unbind()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		m_Stats->FramebufferSwitches++;
+		glBindFramebuffer(GL_FRAMEBUFFER, m_BoundContext->GetDefaultFramebuffer());
 	}
 
 	void OpenGLFramebuffer::Resize(uint32_t width, uint32_t height)
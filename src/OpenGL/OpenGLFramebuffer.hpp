@@ -4,10 +4,12 @@
 
 namespace AGI {
 
+	class OpenGLContext;
+
 	class OpenGLFramebuffer : public FramebufferBase
 	{
 	public:
-		OpenGLFramebuffer(const FramebufferSpecification& spec);
+		OpenGLFramebuffer(OpenGLContext* context, const FramebufferSpecification& spec);
 		virtual ~OpenGLFramebuffer();
 		
 		virtual void Bind() override;
@@ -25,6 +27,9 @@ namespace AGI {
 	private:
 		void Invalidate();
 	private:
+		OpenGLContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
 		uint32_t m_RendererID = 0;
 		void* m_ReadPixel = nullptr;
 		uint32_t m_PixelSize = 0;
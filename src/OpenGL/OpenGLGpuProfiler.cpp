@@ -0,0 +1,133 @@
+#include "agipch.hpp"
+#include "OpenGLGpuProfiler.hpp"
+
+#include <glad/glad.h>
+
+namespace AGI {
+
+	void OpenGLGpuProfiler::Init()
+	{
+		m_Enabled = true;
+	}
+
+	void OpenGLGpuProfiler::Shutdown()
+	{
+		for (auto& frame : m_Frames)
+		{
+			glDeleteQueries(frame.Queries.size(), frame.Queries.data());
+			frame = Frame();
+		}
+
+		m_Enabled = false;
+	}
+
+	bool OpenGLGpuProfiler::BeginFrame(GpuFrameTimings& timings)
+	{
+		bool collected = false;
+
+		// Oldest frames first, so 'timings' ends up with the newest finished frame
+		for (uint32_t i = 0; i < s_FrameLatency; ++i)
+		{
+			Frame& frame = m_Frames[(m_FrameIndex + i) % s_FrameLatency];
+			if (frame.Submitted && Collect(frame, timings))
+			{
+				frame.Submitted = false;
+				collected = true;
+			}
+		}
+
+		// Still not finished after a full trip around the ring, drop it rather than stall
+		Frame& current = m_Frames[m_FrameIndex % s_FrameLatency];
+		current.Submitted = false;
+		current.UsedQueries = 0;
+		current.Zones.clear();
+		current.Index = m_FrameIndex;
+
+		m_ZoneStack.clear();
+		return collected;
+	}
+
+	void OpenGLGpuProfiler::EndFrame()
+	{
+		if (!m_ZoneStack.empty())
+		{
+			AGI_WARN("{} GPU zone(s) still open at the end of the frame", m_ZoneStack.size());
+			while (!m_ZoneStack.empty()) EndZone();
+		}
+
+		Frame& current = m_Frames[m_FrameIndex % s_FrameLatency];
+		current.Submitted = !current.Zones.empty();
+
+		++m_FrameIndex;
+	}
+
+	void OpenGLGpuProfiler::BeginZone(std::string_view name)
+	{
+		if (!m_Enabled) return;
+		Frame& frame = m_Frames[m_FrameIndex % s_FrameLatency];
+
+		PendingZone& zone = frame.Zones.emplace_back();
+		zone.Name = name;
+		zone.Depth = m_ZoneStack.size();
+		zone.Parent = m_ZoneStack.empty() ? -1 : m_ZoneStack.back();
+		zone.BeginQuery = NextQuery(frame);
+		zone.EndQuery = 0;
+
+		glQueryCounter(zone.BeginQuery, GL_TIMESTAMP);
+		m_ZoneStack.push_back(frame.Zones.size() - 1);
+	}
+
+	void OpenGLGpuProfiler::EndZone()
+	{
+		if (!m_Enabled) return;
+		if (m_ZoneStack.empty())
+		{
+			AGI_WARN("EndGpuZone() called without a matching BeginGpuZone()");
+			return;
+		}
+
+		Frame& frame = m_Frames[m_FrameIndex % s_FrameLatency];
+		PendingZone& zone = frame.Zones[m_ZoneStack.back()];
+		m_ZoneStack.pop_back();
+
+		zone.EndQuery = NextQuery(frame);
+		glQueryCounter(zone.EndQuery, GL_TIMESTAMP);
+	}
+
+	uint32_t OpenGLGpuProfiler::NextQuery(Frame& frame)
+	{
+		if (frame.UsedQueries == frame.Queries.size())
+			glGenQueries(1, &frame.Queries.emplace_back());
+
+		return frame.Queries[frame.UsedQueries++];
+	}
+
+	bool OpenGLGpuProfiler::Collect(Frame& frame, GpuFrameTimings& timings)
+	{
+		// Queries complete in submission order, so the last one tells us about all of them
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(frame.Queries[frame.UsedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) return false;
+
+		timings.Frame = frame.Index;
+		timings.Zones.resize(frame.Zones.size());
+
+		for (size_t i = 0; i < frame.Zones.size(); ++i)
+		{
+			const PendingZone& pending = frame.Zones[i];
+
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(pending.BeginQuery, GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(pending.EndQuery, GL_QUERY_RESULT, &end);
+
+			GpuZone& zone = timings.Zones[i];
+			zone.Name = pending.Name;
+			zone.Depth = pending.Depth;
+			zone.Parent = pending.Parent;
+			zone.Duration = end > begin ? end - begin : 0;
+		}
+
+		return true;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "AGI/GpuProfiler.hpp"
+
+namespace AGI {
+
+	// Records nested GPU zones with GL_TIMESTAMP queries. Every frame owns
+	// a slot in a small ring so results can be read back once the GPU has
+	// caught up, without ever waiting on a query.
+	class OpenGLGpuProfiler
+	{
+	public:
+		OpenGLGpuProfiler() = default;
+
+		void Init();
+		void Shutdown();
+
+		// Returns true when a previous frame finished and was written to 'timings'
+		bool BeginFrame(GpuFrameTimings& timings);
+		void EndFrame();
+
+		void BeginZone(std::string_view name);
+		void EndZone();
+
+		bool IsEnabled() const { return m_Enabled; }
+	private:
+		struct PendingZone
+		{
+			std::string Name;
+			uint32_t Depth;
+			int32_t Parent;
+			uint32_t BeginQuery;
+			uint32_t EndQuery;
+		};
+
+		struct Frame
+		{
+			std::vector<uint32_t> Queries;
+			uint32_t UsedQueries = 0;
+
+			std::vector<PendingZone> Zones;
+			uint64_t Index = 0;
+			bool Submitted = false;
+		};
+
+		uint32_t NextQuery(Frame& frame);
+		bool Collect(Frame& frame, GpuFrameTimings& timings);
+	private:
+		static constexpr uint32_t s_FrameLatency = 4;
+
+		std::array<Frame, s_FrameLatency> m_Frames;
+		std::vector<int32_t> m_ZoneStack;
+
+		uint64_t m_FrameIndex = 0;
+		bool m_Enabled = false;
+	};
+
+}
\ No newline at end of file
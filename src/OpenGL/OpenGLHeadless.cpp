@@ -0,0 +1,229 @@
+#include "agipch.hpp"
+#include "OpenGLHeadless.hpp"
+
+#include <glad/glad.h>
+
+#ifdef AGI_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace AGI {
+
+#ifdef AGI_EGL
+
+	namespace Utils {
+
+		static bool HasExtension(const char* extensions, std::string_view name)
+		{
+			if (!extensions) return false;
+
+			std::string_view list = extensions;
+			for (size_t pos = list.find(name); pos != std::string_view::npos; pos = list.find(name, pos + 1))
+			{
+				size_t end = pos + name.size();
+				if ((pos == 0 || list[pos - 1] == ' ') && (end == list.size() || list[end] == ' '))
+					return true;
+			}
+
+			return false;
+		}
+
+		static EGLDisplay GetHeadlessDisplay()
+		{
+			// Mesa's surfaceless platform needs neither X11, Wayland nor a GPU (llvmpipe)
+			const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+			if (HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+			{
+				auto eglGetPlatformDisplayEXT = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+				if (eglGetPlatformDisplayEXT)
+					return eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+			}
+
+			return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+
+	}
+
+	// EGL 1.4 doesn't reference count eglInitialize(), so share one display between contexts
+	static std::mutex s_DisplayMutex;
+	static EGLDisplay s_Display = EGL_NO_DISPLAY;
+	static uint32_t s_DisplayRefs = 0;
+	static std::atomic<EGLContext> s_LastContext = EGL_NO_CONTEXT;
+
+	bool OpenGLHeadlessSurface::Init(uint32_t width, uint32_t height, bool shareResources)
+	{
+		m_Width = width;
+		m_Height = height;
+
+		{
+			std::scoped_lock lock(s_DisplayMutex);
+			if (s_DisplayRefs == 0)
+			{
+				s_Display = Utils::GetHeadlessDisplay();
+				if (s_Display == EGL_NO_DISPLAY || !eglInitialize(s_Display, nullptr, nullptr))
+				{
+					AGI_ERROR("Failed to initialize EGL display (0x{:x})", eglGetError());
+					return false;
+				}
+			}
+
+			++s_DisplayRefs;
+			m_Display = s_Display;
+		}
+
+		const char* displayExtensions = eglQueryString(m_Display, EGL_EXTENSIONS);
+		bool surfaceless = Utils::HasExtension(displayExtensions, "EGL_KHR_surfaceless_context");
+
+		EGLint configAttribs[] = {
+			EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_NONE
+		};
+
+		EGLConfig config;
+		EGLint configCount = 0;
+		if (!eglChooseConfig(m_Display, configAttribs, &config, 1, &configCount) || configCount == 0)
+		{
+			AGI_ERROR("No EGL config supports desktop OpenGL");
+			Shutdown();
+			return false;
+		}
+
+		eglBindAPI(EGL_OPENGL_API);
+
+		// llvmpipe tops out at 4.5, so walk down until the driver accepts a version
+		const std::pair<EGLint, EGLint> versions[] = { { 4, 6 }, { 4, 5 }, { 4, 3 }, { 3, 3 } };
+		for (auto [major, minor] : versions)
+		{
+			EGLint contextAttribs[] = {
+				EGL_CONTEXT_MAJOR_VERSION, major,
+				EGL_CONTEXT_MINOR_VERSION, minor,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+				EGL_NONE
+			};
+
+			m_Context = eglCreateContext(m_Display, config, shareResources ? s_LastContext.load() : EGL_NO_CONTEXT, contextAttribs);
+			if (m_Context != EGL_NO_CONTEXT) break;
+		}
+
+		if (m_Context == EGL_NO_CONTEXT)
+		{
+			AGI_ERROR("Failed to create EGL context (0x{:x})", eglGetError());
+			Shutdown();
+			return false;
+		}
+
+		// Without surfaceless support a pbuffer is needed to make the context current,
+		// everything still renders into our own framebuffer
+		if (!surfaceless)
+		{
+			EGLint pbufferAttribs[] = {
+				EGL_WIDTH, (EGLint)width,
+				EGL_HEIGHT, (EGLint)height,
+				EGL_NONE
+			};
+
+			m_Surface = eglCreatePbufferSurface(m_Display, config, pbufferAttribs);
+		}
+
+		if (!eglMakeCurrent(m_Display, m_Surface ? m_Surface : EGL_NO_SURFACE, m_Surface ? m_Surface : EGL_NO_SURFACE, m_Context))
+		{
+			AGI_ERROR("Failed to make EGL context current (0x{:x})", eglGetError());
+			Shutdown();
+			return false;
+		}
+
+		s_LastContext = m_Context;
+		return true;
+	}
+
+	void OpenGLHeadlessSurface::Shutdown()
+	{
+		if (m_Framebuffer)
+		{
+			glDeleteFramebuffers(1, &m_Framebuffer);
+			glDeleteRenderbuffers(1, &m_ColourAttachment);
+			glDeleteRenderbuffers(1, &m_DepthAttachment);
+			m_Framebuffer = 0;
+		}
+
+		if (!m_Display) return;
+		eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+		if (m_Surface)
+			eglDestroySurface(m_Display, m_Surface);
+
+		if (m_Context)
+		{
+			EGLContext expected = m_Context;
+			s_LastContext.compare_exchange_strong(expected, EGL_NO_CONTEXT);
+			eglDestroyContext(m_Display, m_Context);
+		}
+
+		m_Surface = nullptr;
+		m_Context = nullptr;
+		m_Display = nullptr;
+
+		std::scoped_lock lock(s_DisplayMutex);
+		if (--s_DisplayRefs == 0)
+		{
+			eglTerminate(s_Display);
+			s_Display = EGL_NO_DISPLAY;
+		}
+	}
+
+	void* OpenGLHeadlessSurface::GetProcAddress(const char* name)
+	{
+		return (void*)eglGetProcAddress(name);
+	}
+
+#else
+
+	bool OpenGLHeadlessSurface::Init(uint32_t, uint32_t, bool)
+	{
+		AGI_ERROR("Headless rendering needs EGL, which wasn't found when AGI was built");
+		return false;
+	}
+
+	void OpenGLHeadlessSurface::Shutdown()
+	{
+	}
+
+	void* OpenGLHeadlessSurface::GetProcAddress(const char*)
+	{
+		return nullptr;
+	}
+
+#endif
+
+	void OpenGLHeadlessSurface::CreateFramebuffer()
+	{
+		// Bind to edit, Init() may have fallen back to a context without DSA
+		glGenFramebuffers(1, &m_Framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+
+		glGenRenderbuffers(1, &m_ColourAttachment);
+		glBindRenderbuffer(GL_RENDERBUFFER, m_ColourAttachment);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColourAttachment);
+
+		glGenRenderbuffers(1, &m_DepthAttachment);
+		glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment);
+
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		AGI_VERIFY(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Headless framebuffer is incomplete!");
+
+		glViewport(0, 0, m_Width, m_Height);
+	}
+
+	void OpenGLHeadlessSurface::Present()
+	{
+		// Nothing to swap, just make sure the frame actually gets executed
+		glFlush();
+	}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+namespace AGI {
+
+	// EGL context without a window or display server. Rendering goes
+	// into an offscreen framebuffer that stands in for the default one.
+	class OpenGLHeadlessSurface
+	{
+	public:
+		OpenGLHeadlessSurface() = default;
+
+		// Creates the EGL context and makes it current
+		bool Init(uint32_t width, uint32_t height, bool shareResources);
+		void Shutdown();
+
+		// Needs loaded GL functions, so call after gladLoadGLLoader()
+		void CreateFramebuffer();
+		void Present();
+
+		uint32_t GetFramebuffer() const { return m_Framebuffer; }
+
+		static void* GetProcAddress(const char* name);
+	private:
+		// EGLDisplay, EGLContext and EGLSurface are all opaque pointers
+		void* m_Display = nullptr;
+		void* m_Context = nullptr;
+		void* m_Surface = nullptr;
+
+		uint32_t m_Framebuffer = 0;
+		uint32_t m_ColourAttachment = 0;
+		uint32_t m_DepthAttachment = 0;
+
+		uint32_t m_Width = 0, m_Height = 0;
+	};
+
+}
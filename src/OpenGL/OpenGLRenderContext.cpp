@@ -1,5 +1,6 @@
 #include "agipch.hpp"
 #include "OpenGLRenderContext.hpp"
+#include "OpenGLExtensions.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -10,8 +11,27 @@ namespace AGI {
 	{
 		m_BoundWindow->Init();
 
-		int	status = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+		if (m_Settings.Headless)
+		{
+			glm::uvec2 size = m_BoundWindow->GetSize();
+			if (!m_Headless.Init(size.x, size.y, m_Settings.ShareResources)) return false;
+		}
+
+		GLADloadproc loader = m_Settings.Headless ? (GLADloadproc)OpenGLHeadlessSurface::GetProcAddress : (GLADloadproc)glfwGetProcAddress;
+		int	status = gladLoadGLLoader(loader);
 		if (status == 0) return false;
+
+		if (m_Settings.Headless)
+			m_Headless.CreateFramebuffer();
+
+		OpenGLExtensions::Load(loader);
+
+		// Let the driver pick how many threads compile shaders in the background
+		if (OpenGLExtensions::ParallelShaderCompile)
+			OpenGLExtensions::MaxShaderCompilerThreads(0xFFFFFFFF);
+
+		if (m_Settings.BindlessTextures && !OpenGLExtensions::BindlessTexture)
+			AGI_WARN("GL_ARB_bindless_texture isn't supported, textures have to be bound");
 		
 		m_Properties.Renderer = (char*)glGetString(GL_RENDERER);
 		m_Properties.Version = (char*)glGetString(GL_VERSION);
@@ -23,25 +43,199 @@ namespace AGI {
 			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		}
 
+		if (m_Settings.GpuProfiling)
+			m_GpuProfiler.Init();
+
+		if (!m_Settings.ShaderCacheDirectory.empty())
+			m_ShaderCache.Init(m_Settings.ShaderCacheDirectory, m_Properties, &m_ShaderCacheStats);
+
 		PrintProperties();
 		return true;
 	}
 
 	void OpenGLContext::Shutdown()
 	{
+		// Shaders released after this must not reach back into the context
+		for (OpenGLShader* shader : m_ReloadingShaders)
+			shader->CancelReload();
+
+		m_ReloadingShaders.clear();
+		m_UploadRing.Shutdown();
+
+		if (m_GpuProfiler.IsEnabled())
+			m_GpuProfiler.Shutdown();
+
+		if (m_Settings.Headless)
+			m_Headless.Shutdown();
+
 		m_BoundWindow->Shutdown();
 	}
 
 	void OpenGLContext::BeginFrame()
 	{
+		AGI_PROFILE_SCOPE("OpenGLContext::BeginFrame");
+		SubmitFrameStats();
+		FrameStatsTimer timer(*m_CurrentStats);
+
+		if (m_GpuProfiler.IsEnabled())
+			m_GpuProfiler.BeginFrame(m_GpuTimings);
+
+		// Only ever swapped here, so a frame never mixes the old and new program
+		std::erase_if(m_ReloadingShaders, [](OpenGLShader* shader) { return shader->FinishReload(); });
+
+		m_UploadRing.Retire();
+
 		glClear(GL_COLOR_BUFFER_BIT);
 	}
 
+	void OpenGLContext::QueueShaderReload(OpenGLShader* shader)
+	{
+		if (std::find(m_ReloadingShaders.begin(), m_ReloadingShaders.end(), shader) == m_ReloadingShaders.end())
+			m_ReloadingShaders.push_back(shader);
+	}
+
+	void OpenGLContext::DequeueShaderReload(OpenGLShader* shader)
+	{
+		std::erase(m_ReloadingShaders, shader);
+	}
+
 	void OpenGLContext::EndFrame()
 	{
+		AGI_PROFILE_SCOPE("OpenGLContext::EndFrame");
+		FrameStatsTimer timer(*m_CurrentStats);
+
+		if (m_GpuProfiler.IsEnabled())
+			m_GpuProfiler.EndFrame();
+
+		if (m_Settings.Headless)
+		{
+			m_Headless.Present();
+			return;
+		}
+
+		AGI_PROFILE_SCOPE("glfwSwapBuffers");
 		glfwSwapBuffers(m_BoundWindow->GetGlfwWindow());
 	}
 
+	VertexBuffer OpenGLContext::CreateVertexBuffer(const void* vertices, uint32_t size, const BufferLayout& layout)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() { return ResourceBarrier<OpenGLVertexBuffer>::Create(this, vertices, size, layout); };
+
+		if (!m_ResourceCache->IsEnabled()) return create();
+		return m_ResourceCache->GetOrCreate<VertexBufferBase>(ResourceCache::Kind::Buffer, ResourceCache::GetKey(vertices, size, layout), size, create);
+	}
+
+	IndexBuffer OpenGLContext::CreateIndexBuffer(uint32_t* indices, uint32_t size)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() { return ResourceBarrier<OpenGLIndexBuffer>::Create(this, indices, size); };
+
+		if (!m_ResourceCache->IsEnabled()) return create();
+		return m_ResourceCache->GetOrCreate<IndexBufferBase>(ResourceCache::Kind::Buffer, ResourceCache::GetKey(indices, size), size * sizeof(uint32_t), create);
+	}
+
+	Shader OpenGLContext::CreateShader(const ShaderSources& shaderSources)
+	{
+		return CreateShader(shaderSources, false);
+	}
+
+	Shader OpenGLContext::CreateShaderAsync(const ShaderSources& shaderSources)
+	{
+		return CreateShader(shaderSources, true);
+	}
+
+	Shader OpenGLContext::CreateShader(const ShaderSources& shaderSources, bool async)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() { return ResourceBarrier<OpenGLShader>::Create(this, shaderSources, async); };
+
+		if (!m_ResourceCache->IsEnabled()) return create();
+
+		uint64_t bytes = 0;
+		for (const auto& [type, source] : shaderSources)
+			bytes += source.size();
+
+		return m_ResourceCache->GetOrCreate<ShaderBase>(ResourceCache::Kind::Shader, ResourceCache::GetKey(shaderSources), bytes, create);
+	}
+
+	Shader OpenGLContext::CreateShader(const ShaderBinaries& binaries, const SpecializationConstants& constants)
+	{
+		if (!OpenGLExtensions::GlSpirv)
+		{
+			AGI_ERROR("SPIR-V shaders need OpenGL 4.6 or GL_ARB_gl_spirv");
+			return nullptr;
+		}
+
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() { return ResourceBarrier<OpenGLShader>::Create(this, binaries, constants); };
+
+		if (!m_ResourceCache->IsEnabled()) return create();
+
+		uint64_t bytes = 0;
+		for (const auto& [type, code] : binaries)
+			bytes += code.size() * sizeof(uint32_t);
+
+		return m_ResourceCache->GetOrCreate<ShaderBase>(ResourceCache::Kind::Shader, ResourceCache::GetKey(binaries, constants), bytes, create);
+	}
+
+	Texture OpenGLContext::CreateTexture(const TextureSpecification& spec)
+	{
+		// Comes back here with the encoded format and no Compression
+		if (spec.Compression != TextureCompression::None) return CreateCompressedTexture(spec);
+		if (!Utils::ValidateSpecification(spec)) return nullptr;
+
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() { return ResourceBarrier<OpenGLTexture>::Create(this, spec); };
+
+		// Empty textures get filled in later, their contents aren't known yet
+		if (!m_ResourceCache->IsEnabled() || !spec.Data || spec.Datasize == 0) return create();
+		return m_ResourceCache->GetOrCreate<TextureBase>(ResourceCache::Kind::Texture, ResourceCache::GetKey(spec), spec.Datasize, create);
+	}
+
+	Sampler OpenGLContext::CreateSampler(const SamplerSpecification& spec)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() { return ResourceBarrier<OpenGLSampler>::Create(this, spec); };
+
+		auto matches = [&](const SamplerBase& sampler) { return sampler.GetSpecification() == spec; };
+
+		return m_ResourceCache->GetOrCreate<SamplerBase>(ResourceCache::Kind::Sampler, ResourceCache::GetKey(spec), 0, create, matches);
+	}
+
+	TextureUpload OpenGLContext::AllocateUpload(uint32_t size)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+
+		// Mapped on first use, most applications never upload asynchronously
+		if (!m_UploadRing.IsInitialized() && !m_UploadRingFailed)
+			m_UploadRingFailed = !m_UploadRing.Init(m_Settings.UploadRingSize);
+
+		return m_UploadRing.Allocate(size);
+	}
+
+	bool OpenGLContext::IsFormatSupported(ImageFormat format) const
+	{
+		switch (format)
+		{
+		case ImageFormat::BC1:
+		case ImageFormat::BC2:
+		case ImageFormat::BC3:       return OpenGLExtensions::TextureCompressionS3TC;
+		case ImageFormat::BC6H:
+		case ImageFormat::BC7:       return OpenGLExtensions::TextureCompressionBPTC;
+		case ImageFormat::ETC2_RGB:
+		case ImageFormat::ETC2_RGBA: return OpenGLExtensions::TextureCompressionETC2;
+		case ImageFormat::ASTC_4x4:
+		case ImageFormat::ASTC_8x8:  return OpenGLExtensions::TextureCompressionASTC;
+		default:                     return true;
+		}
+	}
+
+	bool OpenGLContext::IsBindlessSupported() const
+	{
+		return m_Settings.BindlessTextures && OpenGLExtensions::BindlessTexture;
+	}
+
 	void OpenGLContext::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
 	{
 		glViewport(x, y, width, height);
@@ -52,10 +246,27 @@ namespace AGI {
 		glClearColor(colour.r, colour.g, colour.b, colour.a);
 	}
 
+	void OpenGLContext::ReadPixels(uint32_t x, uint32_t y, uint32_t width, uint32_t height, void* data)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, GetDefaultFramebuffer());
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	}
+
 	void OpenGLContext::DrawIndexed(const VertexArray& vertexArray, uint32_t indexCount)
 	{
+		AGI_PROFILE_SCOPE("OpenGLContext::DrawIndexed");
+		FrameStatsTimer timer(*m_CurrentStats);
+
 		vertexArray->Bind();
 		uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
+
+		m_CurrentStats->DrawCalls++;
+		m_CurrentStats->Instances++;
+		m_CurrentStats->Triangles += count / 3;
+
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
 	}
 
@@ -5,8 +5,13 @@
 #include "OpenGLBuffer.hpp"
 #include "OpenGLShader.hpp"
 #include "OpenGLTexture.hpp"
+#include "OpenGLSampler.hpp"
 #include "OpenGLVertexArray.hpp"
 #include "OpenGLFramebuffer.hpp"
+#include "OpenGLGpuProfiler.hpp"
+#include "OpenGLHeadless.hpp"
+#include "OpenGLShaderCache.hpp"
+#include "OpenGLUploadRing.hpp"
 
 namespace AGI {
 
@@ -22,13 +27,49 @@ namespace AGI {
 		virtual void DrawIndexed(const VertexArray& vertexArray, uint32_t indexCount = 0) override;
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 		virtual void SetClearColour(const glm::vec4& colour) override;
+		virtual void ReadPixels(uint32_t x, uint32_t y, uint32_t width, uint32_t height, void* data) override;
 
-		virtual VertexBuffer CreateVertexBuffer(uint32_t vertices, const BufferLayout& layout) override { return ResourceBarrier<OpenGLVertexBuffer>::Create(vertices, layout); }
-		virtual IndexBuffer CreateIndexBuffer(uint32_t* indices, uint32_t size) override                { return ResourceBarrier<OpenGLIndexBuffer>::Create(indices, size); }
-		virtual Framebuffer CreateFramebuffer(const FramebufferSpecification& spec) override            { return ResourceBarrier<OpenGLFramebuffer>::Create(spec); }
-		virtual Shader CreateShader(const ShaderSources& shaderSources) override                        { return ResourceBarrier<OpenGLShader>::Create(shaderSources); }
-		virtual Texture CreateTexture(const TextureSpecification& spec) override                        { return ResourceBarrier<OpenGLTexture>::Create(spec); }
-		virtual VertexArray CreateVertexArray() override                                                { return ResourceBarrier<OpenGLVertexArray>::Create(); }
+		// Offscreen framebuffer when headless, otherwise the window's (0)
+		uint32_t GetDefaultFramebuffer() const { return m_Headless.GetFramebuffer(); }
+		OpenGLShaderCache& GetShaderCache() { return m_ShaderCache; }
+		OpenGLUploadRing& GetUploadRing() { return m_UploadRing; }
+
+		// Reloading shaders are polled at the start of every frame until they swap in or fail
+		void QueueShaderReload(OpenGLShader* shader);
+		void DequeueShaderReload(OpenGLShader* shader);
+
+		virtual void BeginGpuZone(std::string_view name) override { m_GpuProfiler.BeginZone(name); }
+		virtual void EndGpuZone() override                       { m_GpuProfiler.EndZone(); }
+
+		virtual VertexBuffer CreateVertexBuffer(uint32_t vertices, const BufferLayout& layout) override { FrameStatsTimer timer(*m_CurrentStats); return ResourceBarrier<OpenGLVertexBuffer>::Create(this, vertices, layout); }
+		virtual Framebuffer CreateFramebuffer(const FramebufferSpecification& spec) override            { FrameStatsTimer timer(*m_CurrentStats); return ResourceBarrier<OpenGLFramebuffer>::Create(this, spec); }
+		virtual VertexArray CreateVertexArray() override                                                { FrameStatsTimer timer(*m_CurrentStats); return ResourceBarrier<OpenGLVertexArray>::Create(this); }
+
+		// These go through the resource cache when Settings::DeduplicateResources is set
+		virtual VertexBuffer CreateVertexBuffer(const void* vertices, uint32_t size, const BufferLayout& layout) override;
+		virtual IndexBuffer CreateIndexBuffer(uint32_t* indices, uint32_t size) override;
+		virtual Shader CreateShader(const ShaderSources& shaderSources) override;
+		virtual Shader CreateShaderAsync(const ShaderSources& shaderSources) override;
+		virtual Shader CreateShader(const ShaderBinaries& binaries, const SpecializationConstants& constants = {}) override;
+		virtual Texture CreateTexture(const TextureSpecification& spec) override;
+		virtual Sampler CreateSampler(const SamplerSpecification& spec) override;
+		using RenderContext::CreateTexture;
+
+		virtual TextureUpload AllocateUpload(uint32_t size) override;
+		virtual bool IsUploadComplete(const TextureUpload& upload) override { return m_UploadRing.IsComplete(upload); }
+		virtual void DiscardUpload(const TextureUpload& upload) override { m_UploadRing.Discard(upload); }
+
+		virtual bool IsFormatSupported(ImageFormat format) const override;
+		virtual bool IsBindlessSupported() const override;
+	private:
+		Shader CreateShader(const ShaderSources& shaderSources, bool async);
+	private:
+		OpenGLGpuProfiler m_GpuProfiler;
+		OpenGLHeadlessSurface m_Headless;
+		OpenGLShaderCache m_ShaderCache;
+		OpenGLUploadRing m_UploadRing;
+		bool m_UploadRingFailed = false;
+		std::vector<OpenGLShader*> m_ReloadingShaders;
 	};
 
 	static Register<OpenGLContext, APIType::OpenGL> s_OpenGLRegister;
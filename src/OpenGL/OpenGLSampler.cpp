@@ -0,0 +1,109 @@
+#include "agipch.hpp"
+#include "OpenGLSampler.hpp"
+#include "OpenGLRenderContext.hpp"
+#include "OpenGLExtensions.hpp"
+
+#include <glad/glad.h>
+
+namespace AGI {
+
+	namespace Utils {
+
+		static GLenum GetMinFilter(const SamplerSpecification& spec)
+		{
+			bool linear = spec.MinFilter == FilterMode::Linear;
+			switch (spec.MipMode)
+			{
+			case MipmapMode::None:    return linear ? GL_LINEAR : GL_NEAREST;
+			case MipmapMode::Nearest: return linear ? GL_LINEAR_MIPMAP_NEAREST : GL_NEAREST_MIPMAP_NEAREST;
+			case MipmapMode::Linear:  return linear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
+			}
+
+			AGI_VERIFY(false, "Unsupported MipmapMode");
+			return GL_LINEAR;
+		}
+
+		static GLenum GetWrapMode(WrappingType wrapping)
+		{
+			switch (wrapping)
+			{
+			case WrappingType::ClampBorder:  return GL_CLAMP_TO_BORDER;
+			case WrappingType::ClampEdge:    return GL_CLAMP_TO_EDGE;
+			case WrappingType::Repeat:       return GL_REPEAT;
+			case WrappingType::MirrorRepeat: return GL_MIRRORED_REPEAT;
+			}
+
+			AGI_VERIFY(false, "Unsupported WrappingType");
+			return GL_REPEAT;
+		}
+
+		static GLenum GetCompareFunc(CompareFunction compare)
+		{
+			switch (compare)
+			{
+			case CompareFunction::Never:        return GL_NEVER;
+			case CompareFunction::Less:         return GL_LESS;
+			case CompareFunction::Equal:        return GL_EQUAL;
+			case CompareFunction::LessEqual:    return GL_LEQUAL;
+			case CompareFunction::Greater:      return GL_GREATER;
+			case CompareFunction::NotEqual:     return GL_NOTEQUAL;
+			case CompareFunction::GreaterEqual: return GL_GEQUAL;
+			case CompareFunction::Always:       return GL_ALWAYS;
+			case CompareFunction::None:         break; // Comparison is disabled instead
+			}
+
+			AGI_VERIFY(false, "Unsupported CompareFunction");
+			return GL_LEQUAL;
+		}
+
+	}
+
+	OpenGLSampler::OpenGLSampler(OpenGLContext* context, const SamplerSpecification& spec)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_Specification(spec)
+	{
+		m_Stats->ResourcesCreated++;
+
+		// Samplers don't need binding to be set up
+		glGenSamplers(1, &m_RendererID);
+
+		glSamplerParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, Utils::GetMinFilter(m_Specification));
+		glSamplerParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, m_Specification.MagFilter == FilterMode::Linear ? GL_LINEAR : GL_NEAREST);
+
+		if (m_Specification.Anisotropy > 1.0f && OpenGLExtensions::MaxAnisotropy > 1.0f)
+			glSamplerParameterf(m_RendererID, GL_TEXTURE_MAX_ANISOTROPY, std::min(m_Specification.Anisotropy, OpenGLExtensions::MaxAnisotropy));
+
+		glSamplerParameteri(m_RendererID, GL_TEXTURE_WRAP_S, Utils::GetWrapMode(m_Specification.WrapU));
+		glSamplerParameteri(m_RendererID, GL_TEXTURE_WRAP_T, Utils::GetWrapMode(m_Specification.WrapV));
+		glSamplerParameteri(m_RendererID, GL_TEXTURE_WRAP_R, Utils::GetWrapMode(m_Specification.WrapW));
+		glSamplerParameterfv(m_RendererID, GL_TEXTURE_BORDER_COLOR, &m_Specification.BorderColour.r);
+
+		if (m_Specification.Compare != CompareFunction::None)
+		{
+			glSamplerParameteri(m_RendererID, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+			glSamplerParameteri(m_RendererID, GL_TEXTURE_COMPARE_FUNC, Utils::GetCompareFunc(m_Specification.Compare));
+		}
+
+		glSamplerParameterf(m_RendererID, GL_TEXTURE_MIN_LOD, m_Specification.MinLod);
+		glSamplerParameterf(m_RendererID, GL_TEXTURE_MAX_LOD, m_Specification.MaxLod);
+		glSamplerParameterf(m_RendererID, GL_TEXTURE_LOD_BIAS, m_Specification.LodBias);
+	}
+
+	OpenGLSampler::~OpenGLSampler()
+	{
+		m_Stats->ResourcesDestroyed++;
+
+		glDeleteSamplers(1, &m_RendererID);
+	}
+
+	void OpenGLSampler::Bind(uint32_t slot) const
+	{
+		m_Stats->SamplerBinds++;
+		glBindSampler(slot, m_RendererID);
+	}
+
+	void OpenGLSampler::Unbind(uint32_t slot) const
+	{
+		glBindSampler(slot, 0);
+	}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "AGI/Sampler.hpp"
+
+namespace AGI {
+
+	class OpenGLContext;
+
+	class OpenGLSampler : public SamplerBase
+	{
+	public:
+		OpenGLSampler(OpenGLContext* context, const SamplerSpecification& spec);
+		virtual ~OpenGLSampler();
+
+		virtual const SamplerSpecification& GetSpecification() const override { return m_Specification; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+
+		virtual void Bind(uint32_t slot = 0) const override;
+		virtual void Unbind(uint32_t slot = 0) const override;
+	private:
+		OpenGLContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
+		SamplerSpecification m_Specification;
+		uint32_t m_RendererID = 0;
+	};
+
+}
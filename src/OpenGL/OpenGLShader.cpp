@@ -1,5 +1,7 @@
 #include "agipch.hpp"
 #include "OpenGLShader.hpp"
+#include "OpenGLRenderContext.hpp"
+#include "OpenGLExtensions.hpp"
 
 #include <fstream>
 #include <array>
@@ -25,29 +27,52 @@ namespace AGI {
 			return glGetUniformLocation(id, attr);
 		}
 
+		// Only submits the compile, querying the status here would wait for it
 		GLuint Compile(GLenum type, const std::string& source)
 		{
+			AGI_PROFILE_SCOPE("Utils::Compile");
+
 			GLuint shader = glCreateShader(type);
 			const GLchar* src = source.c_str();
 			glShaderSource(shader, 1, &src, nullptr);
 			glCompileShader(shader);
 
+			return shader;
+		}
+
+		static std::string GetShaderInfoLog(GLuint shader)
+		{
+			GLint maxLength = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+
+			std::string infoLog(std::max(maxLength, 1), '\0');
+			glGetShaderInfoLog(shader, maxLength, &maxLength, infoLog.data());
+			infoLog.resize(maxLength);
+			return infoLog;
+		}
+
+		static std::string GetProgramInfoLog(GLuint program)
+		{
+			GLint maxLength = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
+
+			std::string infoLog(std::max(maxLength, 1), '\0');
+			glGetProgramInfoLog(program, maxLength, &maxLength, infoLog.data());
+			infoLog.resize(maxLength);
+			return infoLog;
+		}
+
+		bool CheckCompileStatus(GLuint shader)
+		{
 			GLint isCompiled = 0;
 			glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
 			if (!isCompiled) 
 			{
-				GLint maxLength = 0;
-				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
-
-				std::vector<GLchar> infoLog(maxLength);
-				glGetShaderInfoLog(shader, maxLength, &maxLength, infoLog.data());
-				glDeleteShader(shader);
-
-				AGI_ERROR("{}", infoLog.data());
+				AGI_ERROR("{}", GetShaderInfoLog(shader));
 				AGI_VERIFY(false, "Shader compilation failure!");
 			}
 
-			return shader;
+			return isCompiled;
 		}
 
 		ShaderDataType OpenGLShaderTypeToAgiShaderType(GLenum type)
@@ -67,33 +92,143 @@ namespace AGI {
 			case GL_BOOL:           return ShaderDataType::Bool;
 			}
 
-			AGI_VERIFY(false, "Unknown ShaderDataType");
-			return (ShaderDataType)0;
+			return ShaderDataType::Unknown;
+		}
+
+		static SamplerType OpenGLSamplerTypeToAgiSamplerType(GLenum type)
+		{
+			switch (type)
+			{
+			case GL_SAMPLER_1D: case GL_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_1D: case GL_SAMPLER_1D_SHADOW:
+				return SamplerType::Sampler1D;
+			case GL_SAMPLER_2D: case GL_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_2D: case GL_SAMPLER_2D_SHADOW:
+				return SamplerType::Sampler2D;
+			case GL_SAMPLER_3D: case GL_INT_SAMPLER_3D: case GL_UNSIGNED_INT_SAMPLER_3D:
+				return SamplerType::Sampler3D;
+			case GL_SAMPLER_CUBE: case GL_INT_SAMPLER_CUBE: case GL_UNSIGNED_INT_SAMPLER_CUBE: case GL_SAMPLER_CUBE_SHADOW:
+				return SamplerType::SamplerCube;
+			case GL_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY: case GL_SAMPLER_2D_ARRAY_SHADOW:
+				return SamplerType::Sampler2DArray;
+			case GL_SAMPLER_CUBE_MAP_ARRAY: case GL_INT_SAMPLER_CUBE_MAP_ARRAY: case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY: case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+				return SamplerType::SamplerCubeArray;
+			case GL_SAMPLER_BUFFER: case GL_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+				return SamplerType::SamplerBuffer;
+			}
+
+			return SamplerType::Unknown;
+		}
+
+		static uint32_t BlockMemberSize(ShaderDataType type, GLint arraySize, GLint arrayStride, GLint matrixStride)
+		{
+			if (arrayStride) return arrayStride * arraySize;
+
+			// Matrix columns are padded out to the matrix stride (std140 pads mat3 to vec4 columns)
+			if (matrixStride && (type == ShaderDataType::Mat3 || type == ShaderDataType::Mat4))
+				return matrixStride * (type == ShaderDataType::Mat3 ? 3 : 4);
+
+			return ShaderDataTypeSize(type);
 		}
 
 	}
 
-	OpenGLShader::OpenGLShader(const ShaderSources& shaderSources)
+	OpenGLShader::OpenGLShader(OpenGLContext* context, const ShaderSources& shaderSources, bool async)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats())
 	{
+		AGI_PROFILE_SCOPE("OpenGLShader::OpenGLShader");
+		m_Stats->ResourcesCreated++;
+
 		m_RendererID = glCreateProgram();
 
-		std::vector<GLuint> shaderIDs(shaderSources.size());
-		int shaderIndex = 0;
+		OpenGLShaderCache& cache = m_BoundContext->GetShaderCache();
+		if (cache.IsEnabled())
+		{
+			m_CacheKey = cache.GetKey(shaderSources);
+			if (cache.Load(m_RendererID, m_CacheKey))
+			{
+				Reflect();
+				m_Ready = true;
+				return;
+			}
+
+			glProgramParameteri(m_RendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
 
 		for (const auto& [type, source] : shaderSources)
 		{
 			GLuint shader = Utils::Compile(Utils::ShaderTypeToGLType(type), source);
 			glAttachShader(m_RendererID, shader);
-			shaderIDs[shaderIndex++] = shader;
+			m_PendingShaders.push_back(shader);
 		}
 
 		glLinkProgram(m_RendererID);
 
+		// Status checks happen on first use, letting the driver compile in the background
+		if (!async) Finalize();
+	}
+
+	OpenGLShader::OpenGLShader(OpenGLContext* context, const ShaderBinaries& binaries, const SpecializationConstants& constants)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_Spirv(true)
+	{
+		AGI_PROFILE_SCOPE("OpenGLShader::OpenGLShader");
+		m_Stats->ResourcesCreated++;
+
+		AGI_VERIFY(OpenGLExtensions::GlSpirv, "SPIR-V shaders need OpenGL 4.6 or GL_ARB_gl_spirv");
+
+		m_RendererID = glCreateProgram();
+		ReflectSpirv(binaries);
+
+		OpenGLShaderCache& cache = m_BoundContext->GetShaderCache();
+		if (cache.IsEnabled())
+		{
+			m_CacheKey = cache.GetKey(binaries, constants);
+			if (cache.Load(m_RendererID, m_CacheKey))
+			{
+				m_Ready = true;
+				return;
+			}
+
+			glProgramParameteri(m_RendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		// No GLSL front-end involved, the driver goes straight from SPIR-V to its own IR
+		for (const auto& [type, code] : binaries)
+		{
+			// Unlike Vulkan, GL rejects constants the stage doesn't declare
+			std::vector<uint32_t> declared = Utils::GetSpirvSpecializationIDs(code);
+			std::vector<GLuint> constantIDs, constantValues;
+			for (const SpecializationConstant& constant : constants)
+			{
+				if (std::find(declared.begin(), declared.end(), constant.ID) == declared.end()) continue;
+
+				constantIDs.push_back(constant.ID);
+				constantValues.push_back(constant.Value);
+			}
+
+			GLuint shader = glCreateShader(Utils::ShaderTypeToGLType(type));
+			glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, code.data(), code.size() * sizeof(uint32_t));
+			OpenGLExtensions::SpecializeShader(shader, "main", constantIDs.size(), constantIDs.data(), constantValues.data());
+
+			glAttachShader(m_RendererID, shader);
+			m_PendingShaders.push_back(shader);
+		}
+
+		glLinkProgram(m_RendererID);
+		Finalize();
+	}
+
+	void OpenGLShader::Finalize()
+	{
+		AGI_PROFILE_SCOPE("OpenGLShader::Finalize");
+		m_Ready = true;
+
 		GLint isLinked = 0;
 		glGetProgramiv(m_RendererID, GL_LINK_STATUS, &isLinked);
 
 		if (!isLinked)
 		{
+			for (GLuint id : m_PendingShaders)
+				Utils::CheckCompileStatus(id);
+
 			GLint maxLength = 0;
 			glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &maxLength);
 
@@ -102,23 +237,247 @@ namespace AGI {
 
 			AGI_ERROR("{0}", infoLog.data());
 			AGI_VERIFY(false, "Shader link failure!");
-			return;
 		}
 
-		for (GLuint id : shaderIDs)
+		for (GLuint id : m_PendingShaders)
 		{
 			glDetachShader(m_RendererID, id);
 			glDeleteShader(id);
 		}
+
+		m_PendingShaders.clear();
+		if (!isLinked) return;
+
+		OpenGLShaderCache& cache = m_BoundContext->GetShaderCache();
+		if (cache.IsEnabled())
+			cache.Store(m_RendererID, m_CacheKey);
+
+		if (!m_Spirv) Reflect();
+	}
+
+	bool OpenGLShader::IsReady()
+	{
+		if (m_Ready) return true;
+
+		// Without the extension any status query waits, so just finish here
+		if (OpenGLExtensions::ParallelShaderCompile)
+		{
+			GLint completed = GL_FALSE;
+			glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &completed);
+			if (!completed) return false;
+		}
+
+		Finalize();
+		return true;
 	}
 
 	OpenGLShader::~OpenGLShader()
 	{
+		m_Stats->ResourcesDestroyed++;
+
+		// Only queued while reloading, the context cancels every reload when it shuts down
+		if (IsReloading())
+			m_BoundContext->DequeueShaderReload(this);
+
+		CancelReload();
+
+		for (GLuint id : m_PendingShaders)
+			glDeleteShader(id);
+
 		glDeleteProgram(m_RendererID);
 	}
 
+	bool OpenGLShader::Reload(const ShaderSources& sources)
+	{
+		AGI_PROFILE_SCOPE("OpenGLShader::Reload");
+
+		if (sources.empty())
+		{
+			AGI_ERROR("Shader reload has no sources, keeping the previous program");
+			return false;
+		}
+
+		DetachFromCache();
+
+		// A newer edit replaces a reload that hasn't finished yet
+		CancelReload();
+		m_ReloadProgram = glCreateProgram();
+
+		OpenGLShaderCache& cache = m_BoundContext->GetShaderCache();
+		if (cache.IsEnabled())
+		{
+			// Undoing an edit usually lands here
+			m_ReloadCacheKey = cache.GetKey(sources);
+			if (cache.Load(m_ReloadProgram, m_ReloadCacheKey))
+			{
+				m_BoundContext->QueueShaderReload(this);
+				return true;
+			}
+
+			glProgramParameteri(m_ReloadProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		for (const auto& [type, source] : sources)
+		{
+			GLuint shader = Utils::Compile(Utils::ShaderTypeToGLType(type), source);
+			glAttachShader(m_ReloadProgram, shader);
+			m_ReloadShaders.push_back(shader);
+		}
+
+		glLinkProgram(m_ReloadProgram);
+		m_BoundContext->QueueShaderReload(this);
+		return true;
+	}
+
+	bool OpenGLShader::FinishReload()
+	{
+		if (!m_ReloadProgram) return true;
+
+		// Without the extension this is where the link gets waited on, still between frames
+		if (OpenGLExtensions::ParallelShaderCompile)
+		{
+			GLint completed = GL_FALSE;
+			glGetProgramiv(m_ReloadProgram, GL_COMPLETION_STATUS_KHR, &completed);
+			if (!completed) return false;
+		}
+
+		AGI_PROFILE_SCOPE("OpenGLShader::FinishReload");
+
+		GLint isLinked = 0;
+		glGetProgramiv(m_ReloadProgram, GL_LINK_STATUS, &isLinked);
+
+		if (!isLinked)
+		{
+			for (GLuint id : m_ReloadShaders)
+			{
+				GLint isCompiled = 0;
+				glGetShaderiv(id, GL_COMPILE_STATUS, &isCompiled);
+				if (!isCompiled) AGI_ERROR("{}", Utils::GetShaderInfoLog(id));
+			}
+
+			AGI_ERROR("Shader reload failed, keeping the previous program\n{}", Utils::GetProgramInfoLog(m_ReloadProgram));
+			CancelReload();
+			return true;
+		}
+
+		bool compiled = !m_ReloadShaders.empty();
+		for (GLuint id : m_ReloadShaders)
+		{
+			glDetachShader(m_ReloadProgram, id);
+			glDeleteShader(id);
+		}
+
+		m_ReloadShaders.clear();
+
+		OpenGLShaderCache& cache = m_BoundContext->GetShaderCache();
+		if (cache.IsEnabled() && compiled)
+			cache.Store(m_ReloadProgram, m_ReloadCacheKey);
+
+		if (!m_Ready) Finalize();
+
+		GLint current = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+
+		uint32_t oldProgram = m_RendererID;
+		ShaderReflection oldReflection = std::move(m_Reflection);
+
+		m_RendererID = m_ReloadProgram;
+		m_CacheKey = m_ReloadCacheKey;
+		m_ReloadProgram = 0;
+		m_Spirv = false;
+
+		Reflect();
+		CopyUniforms(oldProgram, oldReflection);
+
+		// Sampler units are part of the reflection and just changed
+		if (!m_Reflection.GetSamplers().empty()) Reflect();
+
+		glUseProgram((GLuint)current == oldProgram ? m_RendererID : current);
+		glDeleteProgram(oldProgram);
+		return true;
+	}
+
+	void OpenGLShader::CancelReload()
+	{
+		if (!m_ReloadProgram) return;
+
+		for (GLuint id : m_ReloadShaders)
+			glDeleteShader(id);
+
+		m_ReloadShaders.clear();
+		glDeleteProgram(m_ReloadProgram);
+		m_ReloadProgram = 0;
+	}
+
+	void OpenGLShader::CopyUniforms(uint32_t from, const ShaderReflection& fromReflection)
+	{
+		AGI_PROFILE_SCOPE("OpenGLShader::CopyUniforms");
+
+		// Values set once at startup (sampler units, constants) would otherwise reset to 0
+		glUseProgram(m_RendererID);
+
+		auto copy = [&](const std::string& name, ShaderDataType type, int32_t location, uint32_t arraySize, bool sampler)
+		{
+			for (uint32_t element = 0; element < arraySize; ++element)
+			{
+				std::string elementName = arraySize > 1 ? std::format("{}[{}]", name, element) : name;
+				GLint oldLocation = element == 0 ? location : glGetUniformLocation(from, elementName.c_str());
+				GLint newLocation = GetUniformLocation(GetUniformID(elementName));
+				if (oldLocation == -1 || newLocation == -1) continue;
+
+				float floats[16] = {};
+				GLint ints[4] = {};
+
+				if (sampler)
+				{
+					glGetUniformiv(from, oldLocation, ints);
+					glUniform1i(newLocation, ints[0]);
+					continue;
+				}
+
+				switch (type)
+				{
+				case ShaderDataType::Float:  glGetUniformfv(from, oldLocation, floats); glUniform1fv(newLocation, 1, floats); break;
+				case ShaderDataType::Float2: glGetUniformfv(from, oldLocation, floats); glUniform2fv(newLocation, 1, floats); break;
+				case ShaderDataType::Float3: glGetUniformfv(from, oldLocation, floats); glUniform3fv(newLocation, 1, floats); break;
+				case ShaderDataType::Float4: glGetUniformfv(from, oldLocation, floats); glUniform4fv(newLocation, 1, floats); break;
+				case ShaderDataType::Mat3:   glGetUniformfv(from, oldLocation, floats); glUniformMatrix3fv(newLocation, 1, GL_FALSE, floats); break;
+				case ShaderDataType::Mat4:   glGetUniformfv(from, oldLocation, floats); glUniformMatrix4fv(newLocation, 1, GL_FALSE, floats); break;
+				case ShaderDataType::Int:
+				case ShaderDataType::Bool:   glGetUniformiv(from, oldLocation, ints); glUniform1iv(newLocation, 1, ints); break;
+				case ShaderDataType::Int2:   glGetUniformiv(from, oldLocation, ints); glUniform2iv(newLocation, 1, ints); break;
+				case ShaderDataType::Int3:   glGetUniformiv(from, oldLocation, ints); glUniform3iv(newLocation, 1, ints); break;
+				case ShaderDataType::Int4:   glGetUniformiv(from, oldLocation, ints); glUniform4iv(newLocation, 1, ints); break;
+				default: break;
+				}
+			}
+		};
+
+		for (const ShaderUniform& uniform : fromReflection.GetUniforms())
+		{
+			const ShaderUniform* current = m_Reflection.FindUniform(uniform.ID);
+			if (current && current->Type == uniform.Type)
+				copy(uniform.Name, uniform.Type, uniform.Location, std::min(uniform.ArraySize, current->ArraySize), false);
+		}
+
+		for (const ShaderSampler& sampler : fromReflection.GetSamplers())
+		{
+			const ShaderSampler* current = m_Reflection.FindSampler(sampler.ID);
+			if (current)
+				copy(sampler.Name, ShaderDataType::Int, sampler.Location, std::min(sampler.ArraySize, current->ArraySize), true);
+		}
+	}
+
 	void OpenGLShader::Bind()
 	{
+		m_Stats->ShaderBinds++;
+		Use();
+	}
+
+	void OpenGLShader::Use()
+	{
+		if (!m_Ready) Finalize();
+
 		glUseProgram(m_RendererID);
 	}
 
@@ -127,86 +486,349 @@ namespace AGI {
 		glUseProgram(0);
 	}
 
-	BufferLayout OpenGLShader::GetLayout() const
+	const BufferLayout& OpenGLShader::GetLayout() const
+	{
+		return GetReflection().GetLayout();
+	}
+
+	const ShaderReflection& OpenGLShader::GetReflection() const
 	{
+		// Reflection is filled in lazily for async shaders, logically still const
+		if (!m_Ready) const_cast<OpenGLShader*>(this)->Finalize();
+		return m_Reflection;
+	}
+
+	void OpenGLShader::Reflect()
+	{
+		AGI_PROFILE_SCOPE("OpenGLShader::Reflect");
+
+		std::vector<ShaderAttribute> attributes;
+		std::vector<ShaderUniform> uniforms;
+		std::vector<ShaderBlock> uniformBlocks;
+		std::vector<ShaderBlock> storageBlocks;
+		std::vector<ShaderSampler> samplers;
+
 		GLint maxNameLen = 0;
-		GLint numAttribs = 0;
-		glGetProgramiv(m_RendererID, GL_ACTIVE_ATTRIBUTES, &numAttribs);
-		glGetProgramiv(m_RendererID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLen);
+		GLint count = 0;
+		std::vector<char> nameData;
 
-		BufferLayout layout;
-		layout.Resize(numAttribs);
+		// Vertex attributes
+		glGetProgramiv(m_RendererID, GL_ACTIVE_ATTRIBUTES, &count);
+		glGetProgramiv(m_RendererID, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxNameLen);
+		nameData.resize(std::max(maxNameLen, 1));
 
-		for (int i = 0; i < numAttribs; ++i)
+		for (int i = 0; i < count; ++i)
 		{
 			GLint size = 0;
 			GLenum type = 0;
 			GLsizei length = 0;
 
-			std::vector<char> nameData(maxNameLen);
 			glGetActiveAttrib(m_RendererID, i, maxNameLen, &length, &size, &type, nameData.data());
 			GLint location = glGetAttribLocation(m_RendererID, nameData.data());
+			if (location == -1) continue; // Built-in like gl_VertexID
+
+			ShaderAttribute& attribute = attributes.emplace_back();
+			attribute.Name = std::string(nameData.data(), length);
+			attribute.Type = Utils::OpenGLShaderTypeToAgiShaderType(type);
+			attribute.Location = location;
+		}
+
+		// Uniform blocks, members are filled in with the uniforms below
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLen);
+		nameData.resize(std::max(maxNameLen, 1));
+
+		for (int i = 0; i < count; ++i)
+		{
+			GLsizei length = 0;
+			GLint binding = 0, size = 0;
+
+			glGetActiveUniformBlockName(m_RendererID, i, maxNameLen, &length, nameData.data());
+			glGetActiveUniformBlockiv(m_RendererID, i, GL_UNIFORM_BLOCK_BINDING, &binding);
+			glGetActiveUniformBlockiv(m_RendererID, i, GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+
+			ShaderBlock& block = uniformBlocks.emplace_back();
+			block.Name = std::string(nameData.data(), length);
+			block.Binding = binding;
+			block.Size = size;
+		}
+
+		// Uniforms, samplers and uniform block members
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLen);
+		nameData.resize(std::max(maxNameLen, 1));
+
+		// At most half full so probes stay short, array elements get their own slots
+		size_t capacity = 8;
+		while (capacity < (size_t)count * 4) capacity *= 2;
+		m_Uniforms.assign(capacity, UniformSlot());
+		m_UniformCount = 0;
+
+		for (GLuint i = 0; i < (GLuint)count; ++i)
+		{
+			GLint size = 0;
+			GLenum type = 0;
+			GLsizei length = 0;
+			glGetActiveUniform(m_RendererID, i, maxNameLen, &length, &size, &type, nameData.data());
 
-			layout[location].Name = std::string(nameData.data(), length);
-			layout[location].Type = Utils::OpenGLShaderTypeToAgiShaderType(type);
-			layout[location].Size = Utils::ShaderDataTypeSize(layout[location].Type);
+			GLint blockIndex = -1, offset = 0, arrayStride = 0, matrixStride = 0;
+			glGetActiveUniformsiv(m_RendererID, 1, &i, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+
+			// Arrays report as "u_Name[0]", accept both that and "u_Name"
+			std::string_view name(nameData.data(), length);
+			bool isArray = name.ends_with("[0]");
+			if (isArray) name.remove_suffix(3);
+
+			if (blockIndex != -1)
+			{
+				glGetActiveUniformsiv(m_RendererID, 1, &i, GL_UNIFORM_OFFSET, &offset);
+				glGetActiveUniformsiv(m_RendererID, 1, &i, GL_UNIFORM_ARRAY_STRIDE, &arrayStride);
+				glGetActiveUniformsiv(m_RendererID, 1, &i, GL_UNIFORM_MATRIX_STRIDE, &matrixStride);
+
+				ShaderBlockMember& member = uniformBlocks[blockIndex].Members.emplace_back();
+				member.Name = name;
+				member.Type = Utils::OpenGLShaderTypeToAgiShaderType(type);
+				member.Offset = offset;
+				member.ArraySize = size;
+				member.ArrayStride = arrayStride;
+				member.Size = Utils::BlockMemberSize(member.Type, size, arrayStride, matrixStride);
+				continue;
+			}
+
+			GLint location = glGetUniformLocation(m_RendererID, nameData.data());
+			if (location == -1) continue;
+
+			SamplerType samplerType = Utils::OpenGLSamplerTypeToAgiSamplerType(type);
+			if (samplerType != SamplerType::Unknown)
+			{
+				GLint unit = 0;
+				glGetUniformiv(m_RendererID, location, &unit);
+
+				ShaderSampler& sampler = samplers.emplace_back();
+				sampler.Name = name;
+				sampler.ID = GetUniformID(name);
+				sampler.Type = samplerType;
+				sampler.Location = location;
+				sampler.Binding = unit;
+				sampler.ArraySize = size;
+			}
+			else
+			{
+				ShaderUniform& uniform = uniforms.emplace_back();
+				uniform.Name = name;
+				uniform.ID = GetUniformID(name);
+				uniform.Type = Utils::OpenGLShaderTypeToAgiShaderType(type);
+				uniform.Location = location;
+				uniform.ArraySize = size;
+			}
+
+			if (isArray)
+				AddUniform(std::string(name) + "[0]", location);
+
+			AddUniform(name, location);
+
+			for (GLint element = 1; element < size; ++element)
+			{
+				std::string elementName = std::format("{}[{}]", name, element);
+				AddUniform(elementName, glGetUniformLocation(m_RendererID, elementName.c_str()));
+			}
 		}
 
-		layout.SetOffsets();
-		return layout;
+		// Storage blocks need program interface queries (4.3)
+		if (GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 3))
+		{
+			glGetProgramInterfaceiv(m_RendererID, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &count);
+			glGetProgramInterfaceiv(m_RendererID, GL_SHADER_STORAGE_BLOCK, GL_MAX_NAME_LENGTH, &maxNameLen);
+			nameData.resize(std::max(maxNameLen, 1));
+
+			GLint maxVariableNameLen = 0;
+			glGetProgramInterfaceiv(m_RendererID, GL_BUFFER_VARIABLE, GL_MAX_NAME_LENGTH, &maxVariableNameLen);
+			std::vector<char> variableName(std::max(maxVariableNameLen, 1));
+
+			for (GLuint i = 0; i < (GLuint)count; ++i)
+			{
+				const GLenum blockProps[] = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES };
+				GLint blockValues[3] = {};
+				glGetProgramResourceiv(m_RendererID, GL_SHADER_STORAGE_BLOCK, i, 3, blockProps, 3, nullptr, blockValues);
+
+				GLsizei length = 0;
+				glGetProgramResourceName(m_RendererID, GL_SHADER_STORAGE_BLOCK, i, maxNameLen, &length, nameData.data());
+
+				ShaderBlock& block = storageBlocks.emplace_back();
+				block.Name = std::string(nameData.data(), length);
+				block.Binding = blockValues[0];
+				block.Size = blockValues[1];
+
+				std::vector<GLint> variables(blockValues[2]);
+				const GLenum activeVariables = GL_ACTIVE_VARIABLES;
+				glGetProgramResourceiv(m_RendererID, GL_SHADER_STORAGE_BLOCK, i, 1, &activeVariables, variables.size(), nullptr, variables.data());
+
+				for (GLint variable : variables)
+				{
+					const GLenum props[] = { GL_TYPE, GL_OFFSET, GL_ARRAY_SIZE, GL_ARRAY_STRIDE, GL_MATRIX_STRIDE };
+					GLint values[5] = {};
+					glGetProgramResourceiv(m_RendererID, GL_BUFFER_VARIABLE, variable, 5, props, 5, nullptr, values);
+					glGetProgramResourceName(m_RendererID, GL_BUFFER_VARIABLE, variable, maxVariableNameLen, &length, variableName.data());
+
+					std::string_view name(variableName.data(), length);
+					if (name.ends_with("[0]")) name.remove_suffix(3);
+
+					ShaderBlockMember& member = block.Members.emplace_back();
+					member.Name = name;
+					member.Type = Utils::OpenGLShaderTypeToAgiShaderType(values[0]);
+					member.Offset = values[1];
+					member.ArraySize = values[2]; // 0 for runtime sized arrays
+					member.ArrayStride = values[3];
+					member.Size = Utils::BlockMemberSize(member.Type, values[2], values[3], values[4]);
+				}
+			}
+		}
+
+		m_Reflection = ShaderReflection(std::move(attributes), std::move(uniforms), std::move(uniformBlocks), std::move(storageBlocks), std::move(samplers));
+	}
+
+	void OpenGLShader::ReflectSpirv(const ShaderBinaries& binaries)
+	{
+		AGI_PROFILE_SCOPE("OpenGLShader::ReflectSpirv");
+
+		std::vector<std::span<const uint32_t>> modules;
+		for (const auto& [type, code] : binaries)
+			modules.emplace_back(code);
+
+		m_Reflection = Utils::ReflectSpirv(modules);
+
+		// glGetUniformLocation doesn't work on SPIR-V, locations are explicit and arrays are contiguous
+		size_t capacity = 8;
+		while (capacity < (m_Reflection.GetUniforms().size() + m_Reflection.GetSamplers().size()) * 4) capacity *= 2;
+		m_Uniforms.assign(capacity, UniformSlot());
+		m_UniformCount = 0;
+
+		auto addUniform = [this](const std::string& name, int32_t location, uint32_t arraySize)
+		{
+			if (name.empty() || location == -1) return;
+
+			AddUniform(name, location);
+			if (arraySize == 1) return;
+
+			for (uint32_t element = 0; element < arraySize; ++element)
+				AddUniform(std::format("{}[{}]", name, element), location + element);
+		};
+
+		for (const ShaderUniform& uniform : m_Reflection.GetUniforms())
+			addUniform(uniform.Name, uniform.Location, uniform.ArraySize);
+
+		for (const ShaderSampler& sampler : m_Reflection.GetSamplers())
+			addUniform(sampler.Name, sampler.Location, sampler.ArraySize);
+	}
+
+	void OpenGLShader::AddUniform(std::string_view name, int32_t location)
+	{
+		if (location == -1) return;
+
+		// Grow when over half full, only happens with large uniform arrays
+		if ((m_UniformCount + 1) * 2 > m_Uniforms.size())
+		{
+			std::vector<UniformSlot> old = std::move(m_Uniforms);
+			m_Uniforms.assign(old.size() * 2, UniformSlot());
+
+			for (const UniformSlot& slot : old)
+			{
+				if (slot.Location == -1) continue;
+
+				size_t mask = m_Uniforms.size() - 1;
+				size_t index = slot.ID & mask;
+				while (m_Uniforms[index].Location != -1) index = (index + 1) & mask;
+				m_Uniforms[index] = slot;
+			}
+		}
+
+		UniformID id = GetUniformID(name);
+		size_t mask = m_Uniforms.size() - 1;
+
+		for (size_t index = id & mask;; index = (index + 1) & mask)
+		{
+			UniformSlot& slot = m_Uniforms[index];
+			if (slot.Location == -1)
+			{
+				slot.ID = id;
+				slot.Location = location;
+				m_UniformCount++;
+				return;
+			}
+
+			if (slot.ID == id)
+			{
+				AGI_WARN("Uniform \"{}\" has the same ID as another uniform and can't be set", name);
+				return;
+			}
+		}
+	}
+
+	int32_t OpenGLShader::GetUniformLocation(UniformID id) const
+	{
+		if (m_Uniforms.empty()) return -1;
+		size_t mask = m_Uniforms.size() - 1;
+
+		for (size_t index = id & mask;; index = (index + 1) & mask)
+		{
+			const UniformSlot& slot = m_Uniforms[index];
+			if (slot.Location == -1) return -1;
+			if (slot.ID == id) return slot.Location;
+		}
 	}
 
 	bool OpenGLShader::AttributeExists(const std::string& name) const
 	{
-		return Utils::GetLocation(m_RendererID, name.c_str()) == -1 ? false : true;
+		const ShaderReflection& reflection = GetReflection();
+		return reflection.FindUniform(GetUniformID(name)) || reflection.FindSampler(GetUniformID(name));
 	}
 
-	void OpenGLShader::SetInt(const std::string& name, int value)
+	void OpenGLShader::SetInt(UniformID id, int value)
 	{
-		Bind();
-		glUniform1i(Utils::GetLocation(m_RendererID, name.c_str()), value);
+		Use();
+		glUniform1i(GetUniformLocation(id), value);
 	}
 
-	void OpenGLShader::SetIntArray(const std::string& name, int* values, uint32_t count)
+	void OpenGLShader::SetIntArray(UniformID id, int* values, uint32_t count)
 	{
-		Bind();
-		glUniform1iv(Utils::GetLocation(m_RendererID, name.c_str()), count, values);
+		Use();
+		glUniform1iv(GetUniformLocation(id), count, values);
 	}
 
-	void OpenGLShader::SetFloat(const std::string& name, float value)
+	void OpenGLShader::SetFloat(UniformID id, float value)
 	{
-		Bind();
-		glUniform1f(Utils::GetLocation(m_RendererID, name.c_str()), value);
+		Use();
+		glUniform1f(GetUniformLocation(id), value);
 	}
 
-	void OpenGLShader::SetFloat2(const std::string& name, const glm::vec2& value)
+	void OpenGLShader::SetFloat2(UniformID id, const glm::vec2& value)
 	{
-		Bind();
-		glUniform2f(Utils::GetLocation(m_RendererID, name.c_str()), value.x, value.y);
+		Use();
+		glUniform2f(GetUniformLocation(id), value.x, value.y);
 	}
 
-	void OpenGLShader::SetFloat3(const std::string& name, const glm::vec3& value)
+	void OpenGLShader::SetFloat3(UniformID id, const glm::vec3& value)
 	{
-		Bind();
-		glUniform3f(Utils::GetLocation(m_RendererID, name.c_str()), value.x, value.y, value.z);
+		Use();
+		glUniform3f(GetUniformLocation(id), value.x, value.y, value.z);
 	}
 
-	void OpenGLShader::SetFloat4(const std::string& name, const glm::vec4& value)
+	void OpenGLShader::SetFloat4(UniformID id, const glm::vec4& value)
 	{
-		Bind();
-		glUniform4f(Utils::GetLocation(m_RendererID, name.c_str()), value.x, value.y, value.z, value.w);
+		Use();
+		glUniform4f(GetUniformLocation(id), value.x, value.y, value.z, value.w);
 	}
 
-	void OpenGLShader::SetMat3(const std::string& name, const glm::mat3& matrix)
+	void OpenGLShader::SetMat3(UniformID id, const glm::mat3& matrix)
 	{
-		Bind();
-		glUniformMatrix3fv(Utils::GetLocation(m_RendererID, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+		Use();
+		glUniformMatrix3fv(GetUniformLocation(id), 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
-	void OpenGLShader::SetMat4(const std::string& name, const glm::mat4& matrix)
+	void OpenGLShader::SetMat4(UniformID id, const glm::mat4& matrix)
 	{
-		Bind();
-		glUniformMatrix4fv(Utils::GetLocation(m_RendererID, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+		Use();
+		glUniformMatrix4fv(GetUniformLocation(id), 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
 }
\ No newline at end of file
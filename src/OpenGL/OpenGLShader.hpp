@@ -6,29 +6,76 @@
 
 namespace AGI {
 
+	class OpenGLContext;
+
 	class OpenGLShader : public ShaderBase
 	{
 	public:
-		OpenGLShader(const ShaderSources& shaderSources);
+		OpenGLShader(OpenGLContext* context, const ShaderSources& shaderSources, bool async = false);
+		OpenGLShader(OpenGLContext* context, const ShaderBinaries& binaries, const SpecializationConstants& constants);
 		virtual ~OpenGLShader();
 
 		virtual void Bind() override;
 		virtual void Unbind() override;
+		virtual bool IsReady() override;
+
+		virtual bool Reload(const ShaderSources& sources) override;
+		virtual bool IsReloading() const override { return m_ReloadProgram != 0; }
+
+		// Called by the context between frames, true once the reload was swapped in or failed
+		bool FinishReload();
+		void CancelReload();
 		
-		virtual BufferLayout GetLayout() const override;
+		virtual const BufferLayout& GetLayout() const override;
+		virtual const ShaderReflection& GetReflection() const override;
 		virtual bool AttributeExists(const std::string& name) const override;
 
-		virtual void SetInt(const std::string& name, int value) override;
-		virtual void SetIntArray(const std::string& name, int* values, uint32_t count) override;
-		virtual void SetFloat(const std::string& name, float value) override;
-		virtual void SetFloat2(const std::string& name, const glm::vec2& value) override;
-		virtual void SetFloat3(const std::string& name, const glm::vec3& value) override;
-		virtual void SetFloat4(const std::string& name, const glm::vec4& value) override;
-		virtual void SetMat3(const std::string& name, const glm::mat3& matrix) override;
-		virtual void SetMat4(const std::string& name, const glm::mat4& value) override;
+		using ShaderBase::SetInt, ShaderBase::SetIntArray, ShaderBase::SetFloat, ShaderBase::SetFloat2;
+		using ShaderBase::SetFloat3, ShaderBase::SetFloat4, ShaderBase::SetMat3, ShaderBase::SetMat4;
+
+		virtual void SetInt(UniformID id, int value) override;
+		virtual void SetIntArray(UniformID id, int* values, uint32_t count) override;
+		virtual void SetFloat(UniformID id, float value) override;
+		virtual void SetFloat2(UniformID id, const glm::vec2& value) override;
+		virtual void SetFloat3(UniformID id, const glm::vec3& value) override;
+		virtual void SetFloat4(UniformID id, const glm::vec4& value) override;
+		virtual void SetMat3(UniformID id, const glm::mat3& matrix) override;
+		virtual void SetMat4(UniformID id, const glm::mat4& value) override;
+	private:
+		// Checks compile and link status, blocks if the driver is still working
+		void Finalize();
+		// Bind() for uniform writes, which don't count as a shader bind
+		void Use();
+		void Reflect();
+		void ReflectSpirv(const ShaderBinaries& binaries);
+		void AddUniform(std::string_view name, int32_t location);
+		int32_t GetUniformLocation(UniformID id) const;
+		void CopyUniforms(uint32_t from, const ShaderReflection& fromReflection);
 	private:
+		OpenGLContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
 		uint32_t m_RendererID;
 
+		std::vector<uint32_t> m_PendingShaders;
+		uint64_t m_CacheKey = 0;
+		bool m_Ready = false;
+		bool m_Spirv = false; // Reflected from the modules, GL introspection needs names SPIR-V may not have
+
+		uint32_t m_ReloadProgram = 0;
+		std::vector<uint32_t> m_ReloadShaders;
+		uint64_t m_ReloadCacheKey = 0;
+
+		// Open addressing keyed by UniformID, the ID already is a hash so it's used directly
+		struct UniformSlot
+		{
+			UniformID ID = 0;
+			int32_t Location = -1; // -1 marks an empty slot
+		};
+
+		std::vector<UniformSlot> m_Uniforms;
+		size_t m_UniformCount = 0; // Used slots
+		ShaderReflection m_Reflection;
+
 		friend class Reflection;
 	};
 
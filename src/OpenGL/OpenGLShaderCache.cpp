@@ -0,0 +1,163 @@
+#include "agipch.hpp"
+#include "OpenGLShaderCache.hpp"
+
+#include <fstream>
+#include <glad/glad.h>
+
+namespace AGI {
+
+	struct ShaderCacheHeader
+	{
+		uint32_t Magic = 0x42494741; // "AGIB"
+		uint32_t Format = 0;
+		uint64_t Key = 0;
+	};
+
+	void OpenGLShaderCache::Init(const std::filesystem::path& directory, const ContextProperties& properties, ShaderCacheStats* stats)
+	{
+		GLint formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		if (formats == 0)
+		{
+			AGI_WARN("Driver has no program binary formats, shader cache disabled");
+			return;
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error)
+		{
+			AGI_WARN("Could not create shader cache directory \"{}\" ({})", directory.string(), error.message());
+			return;
+		}
+
+		m_Directory = directory;
+		m_DriverHash = Utils::HashShaderSource(properties.Vendor);
+		m_DriverHash = Utils::HashShaderSource(properties.Renderer, m_DriverHash);
+		m_DriverHash = Utils::HashShaderSource(properties.Version, m_DriverHash);
+
+		m_Stats = stats;
+		m_Enabled = true;
+	}
+
+	uint64_t OpenGLShaderCache::GetKey(const ShaderSources& sources) const
+	{
+		// ShaderSources is unordered, so visit the stages in a fixed order
+		uint64_t key = m_DriverHash;
+		for (ShaderType type : { ShaderType::Vertex, ShaderType::Fragment })
+		{
+			auto it = sources.find(type);
+			if (it == sources.end()) continue;
+
+			key = Utils::HashShaderSource(std::string_view((const char*)&type, sizeof(type)), key);
+			key = Utils::HashShaderSource(it->second, key);
+		}
+
+		return key;
+	}
+
+	uint64_t OpenGLShaderCache::GetKey(const ShaderBinaries& binaries, const SpecializationConstants& constants) const
+	{
+		// Tagged so a module can never collide with GLSL that happens to have the same bytes
+		uint64_t key = Utils::HashShaderSource("SPIR-V", m_DriverHash);
+		for (ShaderType type : { ShaderType::Vertex, ShaderType::Fragment })
+		{
+			auto it = binaries.find(type);
+			if (it == binaries.end()) continue;
+
+			key = Utils::HashShaderSource(std::string_view((const char*)&type, sizeof(type)), key);
+			key = Utils::HashShaderSource(std::string_view((const char*)it->second.data(), it->second.size() * sizeof(uint32_t)), key);
+		}
+
+		for (const SpecializationConstant& constant : constants)
+			key = Utils::HashShaderSource(std::string_view((const char*)&constant, sizeof(constant)), key);
+
+		return key;
+	}
+
+	bool OpenGLShaderCache::Load(uint32_t program, uint64_t key)
+	{
+		AGI_PROFILE_SCOPE("OpenGLShaderCache::Load");
+
+		std::ifstream file(GetPath(key), std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			m_Stats->Misses++;
+			return false;
+		}
+
+		size_t size = file.tellg();
+		file.seekg(0);
+
+		ShaderCacheHeader header;
+		ShaderCacheHeader expected;
+		std::vector<char> binary(size > sizeof(header) ? size - sizeof(header) : 0);
+
+		file.read((char*)&header, sizeof(header));
+		file.read(binary.data(), binary.size());
+
+		GLint isLinked = 0;
+		if (file && header.Magic == expected.Magic && header.Key == key)
+		{
+			glProgramBinary(program, header.Format, binary.data(), binary.size());
+			glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+		}
+
+		if (!isLinked)
+		{
+			// Stale or corrupt, it gets rewritten after the fresh compile
+			file.close();
+			std::error_code error;
+			std::filesystem::remove(GetPath(key), error);
+
+			m_Stats->Rejected++;
+			m_Stats->Misses++;
+			return false;
+		}
+
+		m_Stats->Hits++;
+		return true;
+	}
+
+	void OpenGLShaderCache::Store(uint32_t program, uint64_t key)
+	{
+		AGI_PROFILE_SCOPE("OpenGLShaderCache::Store");
+
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length == 0) return;
+
+		ShaderCacheHeader header;
+		header.Key = key;
+
+		std::vector<char> binary(length);
+		glGetProgramBinary(program, length, &length, (GLenum*)&header.Format, binary.data());
+
+		// Write next to the final file and rename, so other processes never see half a file
+		std::filesystem::path path = GetPath(key);
+		std::filesystem::path temp = path;
+		temp += std::format(".{}.tmp", (uintptr_t)this);
+
+		{
+			std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+			file.write((const char*)&header, sizeof(header));
+			file.write(binary.data(), length);
+
+			if (!file)
+			{
+				AGI_WARN("Failed to write shader cache entry \"{}\"", temp.string());
+				return;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp, path, error);
+		if (error) std::filesystem::remove(temp, error);
+	}
+
+	std::filesystem::path OpenGLShaderCache::GetPath(uint64_t key) const
+	{
+		return m_Directory / std::format("{:016x}.bin", key);
+	}
+
+}
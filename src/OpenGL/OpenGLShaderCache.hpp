@@ -0,0 +1,35 @@
+#pragma once
+
+#include "AGI/Shader.hpp"
+#include "AGI/Settings.hpp"
+
+namespace AGI {
+
+	// Stores linked programs with glGetProgramBinary, one file per program. The key
+	// covers the sources and the driver, so a driver update simply misses.
+	class OpenGLShaderCache
+	{
+	public:
+		OpenGLShaderCache() = default;
+
+		void Init(const std::filesystem::path& directory, const ContextProperties& properties, ShaderCacheStats* stats);
+
+		uint64_t GetKey(const ShaderSources& sources) const;
+		uint64_t GetKey(const ShaderBinaries& binaries, const SpecializationConstants& constants) const;
+
+		// Returns true when 'program' was linked from the cache
+		bool Load(uint32_t program, uint64_t key);
+		void Store(uint32_t program, uint64_t key);
+
+		bool IsEnabled() const { return m_Enabled; }
+	private:
+		std::filesystem::path GetPath(uint64_t key) const;
+	private:
+		std::filesystem::path m_Directory;
+		uint64_t m_DriverHash = 0;
+
+		ShaderCacheStats* m_Stats = nullptr;
+		bool m_Enabled = false;
+	};
+
+}
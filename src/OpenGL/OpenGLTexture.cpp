@@ -1,5 +1,7 @@
 #include "agipch.hpp"
 #include "OpenGLTexture.hpp"
+#include "OpenGLRenderContext.hpp"
+#include "OpenGLExtensions.hpp"
 
 #include <glad/glad.h>
 
@@ -15,6 +17,13 @@ namespace AGI {
                 case ImageFormat::RG: return GL_RG;
                 case ImageFormat::RGB: return GL_RGB;
                 case ImageFormat::RGBA: return GL_RGBA;
+
+                // Compressed data goes through glCompressedTexSubImage*, which takes no format
+                case ImageFormat::BC1: case ImageFormat::BC2: case ImageFormat::BC3:
+                case ImageFormat::BC4: case ImageFormat::BC5: case ImageFormat::BC6H: case ImageFormat::BC7:
+                case ImageFormat::ETC2_RGB: case ImageFormat::ETC2_RGBA:
+                case ImageFormat::ASTC_4x4: case ImageFormat::ASTC_8x8:
+                    break;
             }
 
             AGI_VERIFY(false, "Unsupported OpenGL format");
@@ -57,7 +66,7 @@ namespace AGI {
             case ImageFormat::RGB:
                 switch (spec.BytesPerChannel)
                 {
-                case 8:  return GL_RGB8;
+                case 8:  return spec.SRGB ? GL_SRGB8 : GL_RGB8;
                 case 16: return GL_RGB16F;
                 case 32: return GL_RGB32F;
                 }
@@ -65,11 +74,22 @@ namespace AGI {
             case ImageFormat::RGBA:
                 switch (spec.BytesPerChannel)
                 {
-                case 8:  return GL_RGBA8;
+                case 8:  return spec.SRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
                 case 16: return GL_RGBA16F;
                 case 32: return GL_RGBA32F;
                 }
                 break;
+            case ImageFormat::BC1:       return spec.SRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case ImageFormat::BC2:       return spec.SRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT : GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+            case ImageFormat::BC3:       return spec.SRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case ImageFormat::BC4:       return GL_COMPRESSED_RED_RGTC1;
+            case ImageFormat::BC5:       return GL_COMPRESSED_RG_RGTC2;
+            case ImageFormat::BC6H:      return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+            case ImageFormat::BC7:       return spec.SRGB ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+            case ImageFormat::ETC2_RGB:  return spec.SRGB ? GL_COMPRESSED_SRGB8_ETC2 : GL_COMPRESSED_RGB8_ETC2;
+            case ImageFormat::ETC2_RGBA: return spec.SRGB ? GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC : GL_COMPRESSED_RGBA8_ETC2_EAC;
+            case ImageFormat::ASTC_4x4:  return spec.SRGB ? GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR : GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+            case ImageFormat::ASTC_8x8:  return spec.SRGB ? GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR : GL_COMPRESSED_RGBA_ASTC_8x8_KHR;
             }
 
             AGI_VERIFY(false, "Unsupported OpenGL format");
@@ -83,80 +103,314 @@ namespace AGI {
                 case WrappingType::ClampBorder: return GL_CLAMP_TO_BORDER;
                 case WrappingType::ClampEdge: return GL_CLAMP_TO_EDGE;
                 case WrappingType::Repeat: return GL_REPEAT;
-                case WrappingType::MirrorRepeat: GL_MIRRORED_REPEAT;
+                case WrappingType::MirrorRepeat: return GL_MIRRORED_REPEAT;
             }
 
             AGI_VERIFY(false, "Unsupported WrappingType");
             return 0;
         }
 
+        static GLenum GetTarget(TextureSpecification spec)
+        {
+            switch (spec.Type)
+            {
+                case TextureType::Texture2D: return GL_TEXTURE_2D;
+                case TextureType::Texture2DArray: return GL_TEXTURE_2D_ARRAY;
+                case TextureType::Cube: return GL_TEXTURE_CUBE_MAP;
+                case TextureType::CubeArray: return GL_TEXTURE_CUBE_MAP_ARRAY;
+                case TextureType::Texture3D: return GL_TEXTURE_3D;
+            }
+
+            AGI_VERIFY(false, "Unsupported TextureType");
+            return 0;
+        }
+
+        static GLenum GetMinFilter(TextureSpecification spec, uint32_t mipLevels)
+        {
+            if (mipLevels == 1) return spec.LinearFiltering ? GL_LINEAR : GL_NEAREST;
+
+            return spec.LinearFiltering ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+        }
+
     }
 
-    OpenGLTexture::OpenGLTexture(TextureSpecification spec)
-        : m_Specification(spec)
+    OpenGLTexture::OpenGLTexture(OpenGLContext* context, TextureSpecification spec)
+        : m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_Specification(spec)
     {
+        m_Stats->ResourcesCreated++;
+
         int channels = Utils::ImageFormatToChannels(m_Specification.Format);
         int bytesPerPixel = channels * (m_Specification.BytesPerChannel / 8);
 
-        GLint alignment = 1;
-        if (bytesPerPixel % 8 == 0) alignment = 8;
-        else if (bytesPerPixel % 4 == 0) alignment = 4;
-        else if (bytesPerPixel % 2 == 0) alignment = 2;
+        // Rows are tightly packed, the default of 4 breaks odd sized RGB levels
+        m_UnpackAlignment = 1;
+        if (bytesPerPixel % 8 == 0) m_UnpackAlignment = 8;
+        else if (bytesPerPixel % 4 == 0) m_UnpackAlignment = 4;
+        else if (bytesPerPixel % 2 == 0) m_UnpackAlignment = 2;
+
+        bool compressed = Utils::IsCompressed(m_Specification.Format);
+        bool srgbFormat = compressed ? channels >= 3 && m_Specification.Format != ImageFormat::BC6H : m_Specification.BytesPerChannel == 8 && channels >= 3;
+        if (m_Specification.SRGB && !srgbFormat)
+            AGI_WARN("sRGB textures need 8 bit RGB or RGBA data, the texture will be linear");
+
+        m_MipLevels = Utils::CalculateMipLevels(m_Specification);
+        m_Target = Utils::GetTarget(m_Specification);
 
         glGenTextures(1, &m_RendererID);
-        glBindTexture(GL_TEXTURE_2D, m_RendererID);
+        glBindTexture(m_Target, m_RendererID);
+
+        if (compressed && m_MipLevels > 1 && m_Specification.GenerateMips)
+            AGI_WARN("Compressed textures can't generate mips, upload every level with SetMipData()");
 
-        glTexImage2D(
-            GL_TEXTURE_2D, 
-            0, 
-            Utils::GetInternalFormat(m_Specification), 
-            m_Specification.Size.x, 
-            m_Specification.Size.y,
-            0, 
-            Utils::GetFormat(m_Specification), 
-            Utils::GetDataType(m_Specification), 
-            nullptr
-        );
+        // Immutable storage allocates every level at once with the format fixed, so the
+        // driver never has to check the texture is complete again
+        GLenum internalFormat = Utils::GetInternalFormat(m_Specification);
+        if (!OpenGLExtensions::TextureStorage)
+            AllocateLevels(internalFormat);
+        else if (m_Specification.Type == TextureType::Texture2D || m_Specification.Type == TextureType::Cube)
+            OpenGLExtensions::TexStorage2D(m_Target, m_MipLevels, internalFormat, m_Specification.Size.x, m_Specification.Size.y);
+        else
+            OpenGLExtensions::TexStorage3D(m_Target, m_MipLevels, internalFormat, m_Specification.Size.x, m_Specification.Size.y, Utils::GetLayerCount(m_Specification));
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_Specification.LinearFiltering ? GL_LINEAR : GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_Specification.LinearFiltering ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(m_Target, GL_TEXTURE_MIN_FILTER, Utils::GetMinFilter(m_Specification, m_MipLevels));
+        glTexParameteri(m_Target, GL_TEXTURE_MAG_FILTER, m_Specification.LinearFiltering ? GL_LINEAR : GL_NEAREST);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, Utils::GetWrappingType(m_Specification));
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, Utils::GetWrappingType(m_Specification));
+        if (m_Specification.Anisotropy > 1.0f && OpenGLExtensions::MaxAnisotropy > 1.0f)
+            glTexParameterf(m_Target, GL_TEXTURE_MAX_ANISOTROPY, std::min(m_Specification.Anisotropy, OpenGLExtensions::MaxAnisotropy));
 
-        if (m_Specification.Format == ImageFormat::RED)
+        glTexParameteri(m_Target, GL_TEXTURE_WRAP_S, Utils::GetWrappingType(m_Specification));
+        glTexParameteri(m_Target, GL_TEXTURE_WRAP_T, Utils::GetWrappingType(m_Specification));
+        glTexParameteri(m_Target, GL_TEXTURE_WRAP_R, Utils::GetWrappingType(m_Specification));
+
+        if (channels == 1)
         {
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_RED);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+            glTexParameteri(m_Target, GL_TEXTURE_SWIZZLE_R, GL_RED);
+            glTexParameteri(m_Target, GL_TEXTURE_SWIZZLE_G, GL_RED);
+            glTexParameteri(m_Target, GL_TEXTURE_SWIZZLE_B, GL_RED);
         }
 
-        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindTexture(m_Target, 0);
         if (spec.Datasize != 0) SetData(spec.Data, spec.Datasize);
     }
     
+    void OpenGLTexture::AllocateLevels(uint32_t internalFormat)
+    {
+        bool compressed = Utils::IsCompressed(m_Specification.Format);
+        for (uint32_t mip = 0; mip < m_MipLevels; ++mip)
+        {
+            glm::uvec2 size = Utils::GetMipSize(m_Specification.Size, mip);
+            uint32_t layers = Utils::GetLayerCount(m_Specification, mip);
+            uint32_t layerSize = Utils::GetRegionDatasize(m_Specification, { 0, 0, size.x, size.y });
+
+            switch (m_Specification.Type)
+            {
+            case TextureType::Texture2D:
+                if (compressed) glCompressedTexImage2D(m_Target, mip, internalFormat, size.x, size.y, 0, layerSize, nullptr);
+                else glTexImage2D(m_Target, mip, internalFormat, size.x, size.y, 0, Utils::GetFormat(m_Specification), Utils::GetDataType(m_Specification), nullptr);
+                break;
+            case TextureType::Cube:
+                // Every face is its own 2D image
+                for (uint32_t face = 0; face < 6; ++face)
+                {
+                    if (compressed) glCompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, internalFormat, size.x, size.y, 0, layerSize, nullptr);
+                    else glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, mip, internalFormat, size.x, size.y, 0, Utils::GetFormat(m_Specification), Utils::GetDataType(m_Specification), nullptr);
+                }
+                break;
+            default:
+                // Layers are the depth of arrays, cube arrays count faces
+                if (compressed) glCompressedTexImage3D(m_Target, mip, internalFormat, size.x, size.y, layers, 0, layerSize * layers, nullptr);
+                else glTexImage3D(m_Target, mip, internalFormat, size.x, size.y, layers, 0, Utils::GetFormat(m_Specification), Utils::GetDataType(m_Specification), nullptr);
+                break;
+            }
+        }
+
+        // Otherwise the texture is incomplete until all 1 + log2(size) levels exist
+        glTexParameteri(m_Target, GL_TEXTURE_MAX_LEVEL, m_MipLevels - 1);
+    }
+
     OpenGLTexture::~OpenGLTexture()
     {
+        m_Stats->ResourcesDestroyed++;
+
+        if (m_BindlessHandle)
+            OpenGLExtensions::MakeTextureHandleNonResident(m_BindlessHandle);
+
         glDeleteTextures(1, &m_RendererID);
     }
 
     void OpenGLTexture::SetData(void* data, uint32_t size)
     {
-        if (size != m_Specification.Size.x * m_Specification.Size.y * Utils::ImageFormatToChannels(m_Specification.Format))
+        AGI_PROFILE_SCOPE("OpenGLTexture::SetData");
+        FrameStatsTimer timer(*m_Stats);
+
+        uint32_t expected = Utils::GetLevelDatasize(m_Specification, 0);
+        if (size != expected)
+        {
+            AGI_ERROR("Data must be entire texture, expected {} bytes but got {}", expected, size);
+            return;
+        }
+
+        TextureRegion region = { 0, 0, m_Specification.Size.x, m_Specification.Size.y };
+        Upload(data, region, 0, 0, Utils::GetLayerCount(m_Specification), 0, m_Specification.GenerateMips);
+    }
+
+    void OpenGLTexture::SetData(const void* data, uint32_t size, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t rowPitch)
+    {
+        AGI_PROFILE_SCOPE("OpenGLTexture::SetData");
+        FrameStatsTimer timer(*m_Stats);
+
+        if (!Utils::ValidateRegion(m_Specification, m_MipLevels, region, mip, layer, size, rowPitch))
+            return;
+
+        // Compressed regions are always tightly packed
+        uint32_t rowLength = Utils::IsCompressed(m_Specification.Format) ? 0 : rowPitch / Utils::GetBytesPerPixel(m_Specification);
+        Upload(data, region, mip, layer, 1, rowLength, mip == 0 && m_Specification.GenerateMips);
+    }
+
+    void OpenGLTexture::Upload(const void* data, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t layerCount, uint32_t rowLength, bool generateMips)
+    {
+        uint32_t layerSize = Utils::GetRegionDatasize(m_Specification, region, rowLength * Utils::GetBytesPerPixel(m_Specification));
+        m_Stats->BytesUploaded += layerSize * layerCount;
+        DetachFromCache();
+
+        bool compressed = Utils::IsCompressed(m_Specification.Format);
+        if (compressed)
+            generateMips = false;
+
+        glBindTexture(m_Target, m_RendererID);
+        if (!compressed)
+        {
+            // Every row pitch is a whole number of pixels, so the alignment never pads it
+            glPixelStorei(GL_UNPACK_ALIGNMENT, m_UnpackAlignment);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+        }
+
+        // Compressed data has no pixel format or type, only the internal format
+        GLenum internalFormat = Utils::GetInternalFormat(m_Specification);
+        GLenum format = compressed ? 0 : Utils::GetFormat(m_Specification);
+        GLenum type = compressed ? 0 : Utils::GetDataType(m_Specification);
+
+        switch (m_Specification.Type)
+        {
+        case TextureType::Texture2D:
+        case TextureType::Cube:
+        {
+            // Cube faces are separate targets, 'data' may be an offset into the unpack buffer
+            for (uint32_t i = 0; i < layerCount; ++i)
+            {
+                GLenum target = m_Specification.Type == TextureType::Cube ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + layer + i : GL_TEXTURE_2D;
+                const void* pixels = (const uint8_t*)data + (size_t)layerSize * i;
+
+                if (compressed) glCompressedTexSubImage2D(target, mip, region.X, region.Y, region.Width, region.Height, internalFormat, layerSize, pixels);
+                else glTexSubImage2D(target, mip, region.X, region.Y, region.Width, region.Height, format, type, pixels);
+            }
+            break;
+        }
+        default:
+            if (compressed) glCompressedTexSubImage3D(m_Target, mip, region.X, region.Y, layer, region.Width, region.Height, layerCount, internalFormat, layerSize * layerCount, data);
+            else glTexSubImage3D(m_Target, mip, region.X, region.Y, layer, region.Width, region.Height, layerCount, format, type, data);
+            break;
+        }
+
+        if (!compressed)
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+        if (generateMips && m_MipLevels > 1)
+            glGenerateMipmap(m_Target);
+
+        glBindTexture(m_Target, 0);
+    }
+
+    void OpenGLTexture::SetData(const TextureUpload& upload)
+    {
+        AGI_PROFILE_SCOPE("OpenGLTexture::SetData");
+        FrameStatsTimer timer(*m_Stats);
+
+        // Rejected uploads are given back, nothing else would free their region
+        OpenGLUploadRing& ring = m_BoundContext->GetUploadRing();
+        if (!upload.Data || !ring.IsInitialized())
+        {
+            AGI_ERROR("Texture upload has no staging memory, use SetData(data, size) instead");
+            ring.Discard(upload);
+            return;
+        }
+
+        uint32_t expected = Utils::GetLevelDatasize(m_Specification, 0);
+        if (upload.Size != expected)
         {
-            AGI_ERROR("Data must be entire texture");
+            AGI_ERROR("Texture upload needs {} bytes, got {}", expected, upload.Size);
+            ring.Discard(upload);
             return;
         }
 
-        glBindTexture(GL_TEXTURE_2D, m_RendererID);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Specification.Size.x, m_Specification.Size.y, Utils::GetFormat(m_Specification), Utils::GetDataType(m_Specification), data);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        // Sourced from the bound unpack buffer, the driver doesn't have to copy anything now
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring.GetRendererID());
+        Upload((const void*)(uintptr_t)upload.Offset, { 0, 0, m_Specification.Size.x, m_Specification.Size.y }, 0, 0, Utils::GetLayerCount(m_Specification), 0, m_Specification.GenerateMips);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        ring.Submit(upload);
+    }
+
+    void OpenGLTexture::SetMipData(uint32_t mip, void* data, uint32_t size)
+    {
+        AGI_PROFILE_SCOPE("OpenGLTexture::SetMipData");
+        FrameStatsTimer timer(*m_Stats);
+
+        if (mip >= m_MipLevels)
+        {
+            AGI_ERROR("Texture has {} mip levels, can't set level {}", m_MipLevels, mip);
+            return;
+        }
+
+        uint32_t expected = Utils::GetLevelDatasize(m_Specification, mip);
+        if (size != expected)
+        {
+            AGI_ERROR("Mip level {} needs {} bytes, got {}", mip, expected, size);
+            return;
+        }
+
+        // Part of a prebuilt chain, so nothing is regenerated
+        glm::uvec2 mipSize = Utils::GetMipSize(m_Specification.Size, mip);
+        Upload(data, { 0, 0, mipSize.x, mipSize.y }, mip, 0, Utils::GetLayerCount(m_Specification, mip), 0, false);
+    }
+
+    void OpenGLTexture::GenerateMips()
+    {
+        AGI_PROFILE_SCOPE("OpenGLTexture::GenerateMips");
+        FrameStatsTimer timer(*m_Stats);
+
+        if (m_MipLevels == 1) return;
+        if (Utils::IsCompressed(m_Specification.Format))
+        {
+            AGI_WARN("Compressed textures can't generate mips, upload every level with SetMipData()");
+            return;
+        }
+
+        DetachFromCache();
+
+        glBindTexture(m_Target, m_RendererID);
+        glGenerateMipmap(m_Target);
+        glBindTexture(m_Target, 0);
     }
 
     void OpenGLTexture::Bind(uint32_t slot) const
     {
+        m_Stats->TextureBinds++;
         glActiveTexture(GL_TEXTURE0 + slot);
-        glBindTexture(GL_TEXTURE_2D, m_RendererID);
+        glBindTexture(m_Target, m_RendererID);
+    }
+
+    uint64_t OpenGLTexture::GetBindlessHandle() const
+    {
+        if (m_BindlessHandle || !m_BoundContext->IsBindlessSupported())
+            return m_BindlessHandle;
+
+        // Resident handles stay valid until the texture is deleted, shaders can read them from any buffer
+        m_BindlessHandle = OpenGLExtensions::GetTextureHandle(m_RendererID);
+        if (m_BindlessHandle)
+            OpenGLExtensions::MakeTextureHandleResident(m_BindlessHandle);
+
+        return m_BindlessHandle;
     }
 
 }
\ No newline at end of file
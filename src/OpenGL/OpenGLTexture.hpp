@@ -4,21 +4,45 @@
 
 namespace AGI {
 
+	class OpenGLContext;
+
 	class OpenGLTexture : public TextureBase
 	{
 	public:
-		OpenGLTexture(TextureSpecification spec);
+		OpenGLTexture(OpenGLContext* context, TextureSpecification spec);
 		virtual ~OpenGLTexture();
 
 		virtual const glm::uvec2& GetSize() const override { return m_Specification.Size; }
 		virtual const TextureSpecification& GetSpecification() const override { return m_Specification; }
 		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+		virtual uint32_t GetMipLevels() const override { return m_MipLevels; }
 
 		virtual void SetData(void* data, uint32_t size) override;
+		virtual void SetData(const void* data, uint32_t size, const TextureRegion& region, uint32_t mip = 0, uint32_t layer = 0, uint32_t rowPitch = 0) override;
+		virtual void SetData(const TextureUpload& upload) override;
+		virtual void SetMipData(uint32_t mip, void* data, uint32_t size) override;
+		virtual void GenerateMips() override;
 		virtual void Bind(uint32_t slot = 0) const override;
+		virtual uint64_t GetBindlessHandle() const override;
+	private:
+		// Mutable storage for drivers without GL_ARB_texture_storage, every level separately
+		void AllocateLevels(uint32_t internalFormat);
+
+		// 'rowLength' is in pixels, 0 when rows are tightly packed. Several layers
+		// are only uploaded together from tightly packed data.
+		void Upload(const void* data, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t layerCount, uint32_t rowLength, bool generateMips);
 	private:
+		OpenGLContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
 		TextureSpecification m_Specification;
 		uint32_t m_RendererID;
+		uint32_t m_Target = 0;
+		uint32_t m_MipLevels = 1;
+		int32_t m_UnpackAlignment = 4;
+
+		// Created and made resident on first use
+		mutable uint64_t m_BindlessHandle = 0;
 	};
 
 }
\ No newline at end of file
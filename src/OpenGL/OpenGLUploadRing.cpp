@@ -0,0 +1,73 @@
+#include "agipch.hpp"
+#include "OpenGLUploadRing.hpp"
+
+#include <glad/glad.h>
+
+namespace AGI {
+
+	bool OpenGLUploadRing::Init(uint32_t size)
+	{
+		if (!GLAD_GL_VERSION_4_4)
+		{
+			AGI_WARN("Asynchronous texture uploads need OpenGL 4.4, falling back to SetData()");
+			return false;
+		}
+
+		// Coherent, so writes from other threads need no explicit flush
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &m_RendererID);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_RendererID);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+
+		uint8_t* mapped = (uint8_t*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if (!mapped)
+		{
+			AGI_ERROR("Failed to map {} bytes of texture upload memory", size);
+			Shutdown();
+			return false;
+		}
+
+		Reset(mapped, size);
+		return true;
+	}
+
+	void OpenGLUploadRing::Shutdown()
+	{
+		if (!m_RendererID) return;
+		Release();
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_RendererID);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		glDeleteBuffers(1, &m_RendererID);
+		m_RendererID = 0;
+	}
+
+	void OpenGLUploadRing::Submit(const TextureUpload& upload)
+	{
+		UploadRing::Submit(upload, (uint64_t)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	}
+
+	bool OpenGLUploadRing::IsSignalled(uint64_t fence)
+	{
+		GLint status = GL_UNSIGNALED;
+		glGetSynciv((GLsync)fence, GL_SYNC_STATUS, 1, nullptr, &status);
+		return status == GL_SIGNALED;
+	}
+
+	void OpenGLUploadRing::Wait(uint64_t fence)
+	{
+		// Flushing makes sure the fence actually reaches the GPU before we block on it
+		while (glClientWaitSync((GLsync)fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+	}
+
+	void OpenGLUploadRing::DestroyFence(uint64_t fence)
+	{
+		glDeleteSync((GLsync)fence);
+	}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "UploadRing.hpp"
+
+namespace AGI {
+
+	// GL_PIXEL_UNPACK_BUFFER mapped once with GL_MAP_PERSISTENT_BIT, copies
+	// read from it by offset and are fenced with glFenceSync(). Needs OpenGL
+	// 4.4, older drivers get no staging memory and fall back to SetData().
+	class OpenGLUploadRing : public UploadRing
+	{
+	public:
+		virtual ~OpenGLUploadRing() { Shutdown(); }
+
+		bool Init(uint32_t size);
+		void Shutdown();
+
+		bool IsInitialized() const { return m_RendererID != 0; }
+		uint32_t GetRendererID() const { return m_RendererID; }
+
+		// Fences every copy issued so far that reads from 'upload'
+		void Submit(const TextureUpload& upload);
+	protected:
+		virtual bool IsSignalled(uint64_t fence) override;
+		virtual void Wait(uint64_t fence) override;
+		virtual void DestroyFence(uint64_t fence) override;
+	private:
+		uint32_t m_RendererID = 0;
+	};
+
+}
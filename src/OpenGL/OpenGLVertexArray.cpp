@@ -1,5 +1,6 @@
 #include "agipch.hpp"
 #include "OpenGLVertexArray.hpp"
+#include "OpenGLRenderContext.hpp"
 
 #include <glad/glad.h>
 
@@ -20,19 +21,23 @@ namespace AGI {
 			case ShaderDataType::Int3:     return GL_INT;
 			case ShaderDataType::Int4:     return GL_INT;
 			case ShaderDataType::Bool:     return GL_BOOL;
+			case ShaderDataType::Unknown:  break;
 		}
 
 		AGI_VERIFY(false, "Unknown ShaderDataType!");
 		return 0;
 	}
 
-	OpenGLVertexArray::OpenGLVertexArray()
+	OpenGLVertexArray::OpenGLVertexArray(OpenGLContext* context)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats())
 	{
+		m_Stats->ResourcesCreated++;
 		glGenVertexArrays(1, &m_RendererID);
 	}
 
 	OpenGLVertexArray::~OpenGLVertexArray()
 	{
+		m_Stats->ResourcesDestroyed++;
 		glDeleteVertexArrays(1, &m_RendererID);
 	}
 
@@ -4,10 +4,12 @@
 
 namespace AGI {
 
+	class OpenGLContext;
+
 	class OpenGLVertexArray : public VertexArrayBase
 	{
 	public:
-		OpenGLVertexArray();
+		OpenGLVertexArray(OpenGLContext* context);
 		virtual ~OpenGLVertexArray();
 
 		virtual void Bind() const override;
@@ -19,6 +21,9 @@ namespace AGI {
 		virtual const std::vector<VertexBuffer>& GetVertexBuffers() const override { return m_VertexBuffers; }
 		virtual const IndexBuffer& GetIndexBuffer() const override { return m_IndexBuffer; }
 	private:
+		OpenGLContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
 		uint32_t m_RendererID;
 		uint32_t m_VertexBufferIndex = 0;
 		std::vector<VertexBuffer> m_VertexBuffers;
@@ -0,0 +1,177 @@
+#include "agipch.hpp"
+#include "AGI/Profiler.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <memory>
+
+namespace AGI {
+
+	struct ProfileEvent
+	{
+		const char* Name;
+		uint64_t Start;
+		uint64_t End;
+	};
+
+	// Sequence is odd while the owning thread writes the slot and 2 * (index + 1)
+	// once event 'index' is in it. Readers check it again after copying, the
+	// writer may have wrapped around onto the slot in the meantime.
+	struct ProfileSlot
+	{
+		std::atomic<uint64_t> Sequence = 0;
+		std::atomic<const char*> Name = nullptr;
+		std::atomic<uint64_t> Start = 0;
+		std::atomic<uint64_t> End = 0;
+	};
+
+	// Single producer ring, only the owning thread writes. Readers take
+	// whatever has been published through Written.
+	struct ThreadBuffer
+	{
+		static constexpr uint32_t Capacity = 1 << 16;
+
+		uint32_t ThreadID;
+		std::unique_ptr<ProfileSlot[]> Events = std::make_unique<ProfileSlot[]>(Capacity);
+		std::atomic<uint64_t> Written = 0;
+		std::atomic<uint64_t> ClearedAt = 0;
+	};
+
+	struct ProfilerState
+	{
+		std::chrono::steady_clock::time_point Epoch = std::chrono::steady_clock::now();
+
+		std::mutex BuffersMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+	};
+
+	static ProfilerState& GetState()
+	{
+		static ProfilerState state;
+		return state;
+	}
+
+	static ThreadBuffer& GetThreadBuffer()
+	{
+		thread_local ThreadBuffer* buffer = nullptr;
+		if (!buffer)
+		{
+			ProfilerState& state = GetState();
+			std::lock_guard lock(state.BuffersMutex);
+
+			auto& created = state.Buffers.emplace_back(std::make_unique<ThreadBuffer>());
+			created->ThreadID = state.Buffers.size();
+			buffer = created.get();
+		}
+
+		return *buffer;
+	}
+
+	static void AppendEscaped(std::string& out, const char* str)
+	{
+		for (; *str; ++str)
+		{
+			switch (*str)
+			{
+			case '"':  out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			default:   out += *str; break;
+			}
+		}
+	}
+
+	// False when the owning thread overwrote the slot before or while it was copied
+	static bool ReadSlot(const ProfileSlot& slot, uint64_t index, ProfileEvent& event)
+	{
+		uint64_t sequence = slot.Sequence.load(std::memory_order_acquire);
+		if (sequence != index * 2 + 2)
+			return false;
+
+		event.Name = slot.Name.load(std::memory_order_relaxed);
+		event.Start = slot.Start.load(std::memory_order_relaxed);
+		event.End = slot.End.load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.Sequence.load(std::memory_order_relaxed) == sequence;
+	}
+
+	uint64_t Profiler::Now()
+	{
+		auto elapsed = std::chrono::steady_clock::now() - GetState().Epoch;
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	}
+
+	void Profiler::Record(const char* name, uint64_t start, uint64_t end)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+		uint64_t index = buffer.Written.load(std::memory_order_relaxed);
+
+		ProfileSlot& slot = buffer.Events[index % ThreadBuffer::Capacity];
+		slot.Sequence.store(index * 2 + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot.Name.store(name, std::memory_order_relaxed);
+		slot.Start.store(start, std::memory_order_relaxed);
+		slot.End.store(end, std::memory_order_relaxed);
+
+		slot.Sequence.store(index * 2 + 2, std::memory_order_release);
+		buffer.Written.store(index + 1, std::memory_order_release);
+	}
+
+	std::string Profiler::ExportChromeTrace()
+	{
+		ProfilerState& state = GetState();
+		std::lock_guard lock(state.BuffersMutex);
+
+		std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+
+		for (const auto& buffer : state.Buffers)
+		{
+			uint64_t written = buffer->Written.load(std::memory_order_acquire);
+			uint64_t begin = std::max(buffer->ClearedAt.load(), written > ThreadBuffer::Capacity ? written - ThreadBuffer::Capacity : 0);
+
+			for (uint64_t i = begin; i < written; ++i)
+			{
+				ProfileEvent event;
+				if (!ReadSlot(buffer->Events[i % ThreadBuffer::Capacity], i, event))
+					continue;
+
+				json += first ? "{\"name\":\"" : ",{\"name\":\"";
+				AppendEscaped(json, event.Name);
+				json += std::format("\",\"cat\":\"AGI\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+					buffer->ThreadID, event.Start / 1000.0, (event.End - event.Start) / 1000.0);
+
+				first = false;
+			}
+		}
+
+		json += "]}";
+		return json;
+	}
+
+	bool Profiler::WriteChromeTrace(const std::filesystem::path& path)
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+		{
+			AGI_ERROR("Could not open \"{}\" for writing", path.string());
+			return false;
+		}
+
+		file << ExportChromeTrace();
+		return true;
+	}
+
+	void Profiler::Clear()
+	{
+		ProfilerState& state = GetState();
+		std::lock_guard lock(state.BuffersMutex);
+
+		for (const auto& buffer : state.Buffers)
+			buffer->ClearedAt = buffer->Written.load(std::memory_order_acquire);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "agipch.hpp"
+#include "AGI/ResourceCache.hpp"
+
+#include <bit>
+
+namespace AGI {
+
+	namespace Utils {
+
+		static constexpr uint64_t s_Prime1 = 11400714785074694791ull;
+		static constexpr uint64_t s_Prime2 = 14029467366897019727ull;
+		static constexpr uint64_t s_Prime3 = 1609587929392839161ull;
+		static constexpr uint64_t s_Prime4 = 9650029242287828579ull;
+		static constexpr uint64_t s_Prime5 = 2870177450012600261ull;
+
+		static uint64_t Read64(const uint8_t* data) { uint64_t value; std::memcpy(&value, data, sizeof(value)); return value; }
+		static uint32_t Read32(const uint8_t* data) { uint32_t value; std::memcpy(&value, data, sizeof(value)); return value; }
+
+		static uint64_t Round(uint64_t acc, uint64_t input)
+		{
+			acc += input * s_Prime2;
+			return std::rotl(acc, 31) * s_Prime1;
+		}
+
+		static uint64_t MergeRound(uint64_t acc, uint64_t value)
+		{
+			acc ^= Round(0, value);
+			return acc * s_Prime1 + s_Prime4;
+		}
+
+		uint64_t HashData(const void* data, size_t size, uint64_t seed)
+		{
+			const uint8_t* p = (const uint8_t*)data;
+			const uint8_t* end = p + size;
+			uint64_t hash;
+
+			if (size >= 32)
+			{
+				uint64_t v1 = seed + s_Prime1 + s_Prime2;
+				uint64_t v2 = seed + s_Prime2;
+				uint64_t v3 = seed;
+				uint64_t v4 = seed - s_Prime1;
+
+				// Four independent lanes keep the multipliers busy
+				for (; p + 32 <= end; p += 32)
+				{
+					v1 = Round(v1, Read64(p));
+					v2 = Round(v2, Read64(p + 8));
+					v3 = Round(v3, Read64(p + 16));
+					v4 = Round(v4, Read64(p + 24));
+				}
+
+				hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+				hash = MergeRound(hash, v1);
+				hash = MergeRound(hash, v2);
+				hash = MergeRound(hash, v3);
+				hash = MergeRound(hash, v4);
+			}
+			else
+				hash = seed + s_Prime5;
+
+			hash += size;
+
+			for (; p + 8 <= end; p += 8)
+			{
+				hash ^= Round(0, Read64(p));
+				hash = std::rotl(hash, 27) * s_Prime1 + s_Prime4;
+			}
+
+			if (p + 4 <= end)
+			{
+				hash ^= Read32(p) * s_Prime1;
+				hash = std::rotl(hash, 23) * s_Prime2 + s_Prime3;
+				p += 4;
+			}
+
+			for (; p < end; ++p)
+			{
+				hash ^= *p * s_Prime5;
+				hash = std::rotl(hash, 11) * s_Prime1;
+			}
+
+			hash ^= hash >> 33;
+			hash *= s_Prime2;
+			hash ^= hash >> 29;
+			hash *= s_Prime3;
+			hash ^= hash >> 32;
+			return hash;
+		}
+
+	}
+
+	uint64_t ResourceCache::GetKey(const ShaderSources& sources)
+	{
+		// ShaderSources is unordered, so visit the stages in a fixed order
+		uint64_t key = (uint64_t)Kind::Shader;
+		for (ShaderType type : { ShaderType::Vertex, ShaderType::Fragment })
+		{
+			auto it = sources.find(type);
+			if (it == sources.end()) continue;
+
+			key = Utils::HashData(&type, sizeof(type), key);
+			key = Utils::HashData(it->second.data(), it->second.size(), key);
+		}
+
+		return key;
+	}
+
+	uint64_t ResourceCache::GetKey(const ShaderBinaries& binaries, const SpecializationConstants& constants)
+	{
+		// Tagged so a module can never collide with GLSL that happens to have the same bytes
+		uint64_t key = Utils::HashData("SPIR-V", 6, (uint64_t)Kind::Shader);
+		for (ShaderType type : { ShaderType::Vertex, ShaderType::Fragment })
+		{
+			auto it = binaries.find(type);
+			if (it == binaries.end()) continue;
+
+			key = Utils::HashData(&type, sizeof(type), key);
+			key = Utils::HashData(it->second.data(), it->second.size() * sizeof(uint32_t), key);
+		}
+
+		for (const SpecializationConstant& constant : constants)
+			key = Utils::HashData(&constant, sizeof(constant), key);
+
+		return key;
+	}
+
+	uint64_t ResourceCache::GetKey(const TextureSpecification& spec)
+	{
+		// Field by field, the padding inside the struct isn't initialised
+		uint32_t state[] = {
+			spec.Size.x, spec.Size.y, spec.LinearFiltering, spec.MipLevels, spec.GenerateMips, std::bit_cast<uint32_t>(spec.Anisotropy),
+			spec.SRGB, (uint32_t)spec.Format, (uint32_t)spec.Wrapping, spec.BytesPerChannel, (uint32_t)spec.Compression,
+			(uint32_t)spec.Type, spec.Layers
+		};
+
+		uint64_t key = Utils::HashData(state, sizeof(state), (uint64_t)Kind::Texture);
+		return Utils::HashData(spec.Data, spec.Datasize, key);
+	}
+
+	uint64_t ResourceCache::GetKey(const void* vertices, uint32_t size, const BufferLayout& layout)
+	{
+		// The layout lives on the buffer, equal bytes read differently aren't the same buffer
+		uint64_t key = Utils::HashData("Vertex", 6, (uint64_t)Kind::Buffer);
+		for (const BufferElement& element : layout)
+		{
+			uint32_t state[] = { (uint32_t)element.Type, element.Normalized };
+
+			key = Utils::HashData(element.Name.data(), element.Name.size(), key);
+			key = Utils::HashData(state, sizeof(state), key);
+		}
+
+		return Utils::HashData(vertices, size, key);
+	}
+
+	uint64_t ResourceCache::GetKey(const uint32_t* indices, uint32_t count)
+	{
+		uint64_t key = Utils::HashData("Index", 5, (uint64_t)Kind::Buffer);
+		return Utils::HashData(indices, count * sizeof(uint32_t), key);
+	}
+
+	uint64_t ResourceCache::GetKey(const SamplerSpecification& spec)
+	{
+		uint32_t state[] = {
+			(uint32_t)spec.MinFilter, (uint32_t)spec.MagFilter, (uint32_t)spec.MipMode, std::bit_cast<uint32_t>(spec.Anisotropy),
+			(uint32_t)spec.WrapU, (uint32_t)spec.WrapV, (uint32_t)spec.WrapW, (uint32_t)spec.Compare,
+			std::bit_cast<uint32_t>(spec.BorderColour.r), std::bit_cast<uint32_t>(spec.BorderColour.g), std::bit_cast<uint32_t>(spec.BorderColour.b), std::bit_cast<uint32_t>(spec.BorderColour.a),
+			std::bit_cast<uint32_t>(spec.MinLod), std::bit_cast<uint32_t>(spec.MaxLod), std::bit_cast<uint32_t>(spec.LodBias)
+		};
+
+		return Utils::HashData(state, sizeof(state), (uint64_t)Kind::Sampler);
+	}
+
+	void ResourceCache::Untrack(uint64_t key, const RefCounted* resource)
+	{
+		std::lock_guard lock(m_Mutex);
+
+		// A detached resource may share its key with a newer entry
+		auto it = m_Entries.find(key);
+		if (it != m_Entries.end() && it->second == resource)
+			m_Entries.erase(it);
+	}
+
+	ResourceCacheStats ResourceCache::GetStats() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Stats;
+	}
+
+	uint32_t ResourceCache::GetEntryCount() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Entries.size();
+	}
+
+	void ResourceCache::RecordHit(Kind kind, uint64_t bytes)
+	{
+		switch (kind)
+		{
+		case Kind::Shader:  m_Stats.ShaderHits++; break;
+		case Kind::Texture: m_Stats.TextureHits++; break;
+		case Kind::Buffer:  m_Stats.BufferHits++; break;
+		case Kind::Sampler: m_Stats.SamplerHits++; break;
+		}
+
+		m_Stats.BytesSaved += bytes;
+	}
+
+}
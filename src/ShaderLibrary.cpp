@@ -0,0 +1,242 @@
+#include "agipch.hpp"
+#include "AGI/ShaderLibrary.hpp"
+
+#include <bit>
+
+namespace AGI {
+
+	ShaderLibrary::ShaderLibrary(RenderContext* context, std::string source, std::vector<ShaderKeywordAxis> axes, ShaderFileProvider provider)
+		: m_Context(context), m_Source(std::move(source)), m_Preprocessor(provider)
+	{
+		uint32_t shift = 0;
+		for (auto& keywords : axes)
+		{
+			AGI_VERIFY(!keywords.empty(), "Shader keyword axis has no keywords");
+
+			Axis& axis = m_Axes.emplace_back();
+			axis.Keywords = std::move(keywords);
+			axis.Shift = shift;
+			axis.Bits = axis.Keywords.size() == 1 ? 1 : std::bit_width(axis.Keywords.size() - 1);
+
+			shift += axis.Bits;
+		}
+
+		AGI_VERIFY(shift <= 64, "Shader library needs {} key bits, only 64 are available", shift);
+	}
+
+	ShaderLibrary::~ShaderLibrary()
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_StopWorker = true;
+		}
+
+		m_WorkerWake.notify_all();
+		if (m_Worker.joinable()) m_Worker.join();
+	}
+
+	ShaderVariantKey ShaderLibrary::GetKey(std::initializer_list<std::string_view> keywords) const
+	{
+		return GetKey(std::span<const std::string_view>(keywords.begin(), keywords.size()));
+	}
+
+	ShaderVariantKey ShaderLibrary::GetKey(std::span<const std::string_view> keywords) const
+	{
+		ShaderVariantKey key = 0;
+		for (std::string_view keyword : keywords)
+		{
+			bool found = false;
+			for (const Axis& axis : m_Axes)
+			{
+				auto it = std::find(axis.Keywords.begin(), axis.Keywords.end(), keyword);
+				if (it == axis.Keywords.end()) continue;
+
+				uint64_t value = axis.Keywords.size() == 1 ? 1 : (uint64_t)(it - axis.Keywords.begin());
+				key |= value << axis.Shift;
+				found = true;
+				break;
+			}
+
+			if (!found) AGI_WARN("Unknown shader keyword \"{}\"", keyword);
+		}
+
+		return key;
+	}
+
+	Shader ShaderLibrary::Get(ShaderVariantKey key)
+	{
+		if (!IsValidKey(key))
+		{
+			AGI_ERROR("Invalid shader variant key {:#x}", key);
+			return nullptr;
+		}
+
+		ShaderSources sources;
+		{
+			std::lock_guard lock(m_Mutex);
+
+			auto it = m_Variants.find(key);
+			if (it != m_Variants.end()) return it->second;
+		}
+
+		std::lock_guard createLock(m_CreateMutex);
+		{
+			// Another thread might have created it while we were waiting
+			std::lock_guard lock(m_Mutex);
+
+			auto it = m_Variants.find(key);
+			if (it != m_Variants.end()) return it->second;
+
+			auto prepared = m_Prepared.find(key);
+			if (prepared != m_Prepared.end())
+			{
+				sources = std::move(prepared->second);
+				m_Prepared.erase(prepared);
+			}
+		}
+
+		if (sources.empty()) sources = Preprocess(key);
+		if (sources.empty()) return nullptr;
+
+		Shader shader = m_Context->CreateShader(sources);
+
+		std::lock_guard lock(m_Mutex);
+		m_Variants[key] = shader;
+		return shader;
+	}
+
+	void ShaderLibrary::Prewarm(std::span<const ShaderVariantKey> keys)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+
+			for (ShaderVariantKey key : keys)
+			{
+				if (!IsValidKey(key))
+				{
+					AGI_ERROR("Invalid shader variant key {:#x}", key);
+					continue;
+				}
+
+				if (!m_Variants.contains(key) && !m_Prepared.contains(key))
+					m_PrewarmQueue.push_back(key);
+			}
+
+			if (!m_Worker.joinable())
+				m_Worker = std::thread(&ShaderLibrary::WorkerLoop, this);
+		}
+
+		m_WorkerWake.notify_one();
+	}
+
+	void ShaderLibrary::Update()
+	{
+		std::unordered_map<ShaderVariantKey, ShaderSources> prepared;
+		{
+			std::lock_guard lock(m_Mutex);
+			if (m_Prepared.empty()) return;
+
+			prepared.swap(m_Prepared);
+		}
+
+		std::lock_guard createLock(m_CreateMutex);
+		for (auto& [key, sources] : prepared)
+		{
+			if (HasVariant(key)) continue;
+
+			// The driver compiles these in the background, the first bind waits if it has to
+			Shader shader = m_Context->CreateShaderAsync(sources);
+
+			std::lock_guard lock(m_Mutex);
+			m_Variants[key] = shader;
+		}
+	}
+
+	bool ShaderLibrary::HasVariant(ShaderVariantKey key) const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Variants.contains(key);
+	}
+
+	uint32_t ShaderLibrary::GetVariantCount() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Variants.size();
+	}
+
+	void ShaderLibrary::Clear()
+	{
+		std::lock_guard createLock(m_CreateMutex);
+		std::lock_guard lock(m_Mutex);
+
+		m_Variants.clear();
+		m_Prepared.clear();
+	}
+
+	bool ShaderLibrary::IsValidKey(ShaderVariantKey key) const
+	{
+		uint64_t used = 0;
+		for (const Axis& axis : m_Axes)
+		{
+			uint64_t mask = (axis.Bits == 64 ? ~0ull : (1ull << axis.Bits) - 1) << axis.Shift;
+			used |= mask;
+
+			if (axis.Keywords.size() > 1 && ((key & mask) >> axis.Shift) >= axis.Keywords.size())
+				return false;
+		}
+
+		return (key & ~used) == 0;
+	}
+
+	ShaderDefines ShaderLibrary::GetDefines(ShaderVariantKey key) const
+	{
+		ShaderDefines defines;
+		for (const Axis& axis : m_Axes)
+		{
+			uint64_t value = (key >> axis.Shift) & ((1ull << axis.Bits) - 1);
+
+			if (axis.Keywords.size() == 1)
+			{
+				if (value) defines.emplace_back(axis.Keywords[0], "1");
+			}
+			else
+				defines.emplace_back(axis.Keywords[value], "1");
+		}
+
+		return defines;
+	}
+
+	ShaderSources ShaderLibrary::Preprocess(ShaderVariantKey key)
+	{
+		AGI_PROFILE_SCOPE("ShaderLibrary::Preprocess");
+
+		ShaderDefines defines = GetDefines(key);
+
+		std::lock_guard lock(m_PreprocessorMutex);
+		return m_Preprocessor.Process(m_Source, defines);
+	}
+
+	void ShaderLibrary::WorkerLoop()
+	{
+		std::unique_lock lock(m_Mutex);
+		while (true)
+		{
+			m_WorkerWake.wait(lock, [this]() { return m_StopWorker || !m_PrewarmQueue.empty(); });
+			if (m_StopWorker) return;
+
+			ShaderVariantKey key = m_PrewarmQueue.front();
+			m_PrewarmQueue.pop_front();
+
+			if (m_Variants.contains(key) || m_Prepared.contains(key))
+				continue;
+
+			lock.unlock();
+			ShaderSources sources = Preprocess(key);
+			lock.lock();
+
+			if (!sources.empty() && !m_Variants.contains(key))
+				m_Prepared.emplace(key, std::move(sources));
+		}
+	}
+
+}
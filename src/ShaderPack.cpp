@@ -0,0 +1,135 @@
+#include "agipch.hpp"
+#include "AGI/ShaderPack.hpp"
+
+#include <fstream>
+#include <utility>
+
+namespace AGI {
+
+	ShaderPack::ShaderPack(std::span<const uint32_t> data)
+		: m_Data(data)
+	{
+		if (!Validate()) AGI_ERROR("Shader pack is corrupt or from an incompatible version");
+	}
+
+	ShaderPack::ShaderPack(const std::filesystem::path& path)
+	{
+		AGI_PROFILE_SCOPE("ShaderPack::ShaderPack");
+
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			AGI_ERROR("Could not open shader pack \"{}\"", path.string());
+			return;
+		}
+
+		size_t size = file.tellg();
+		m_Storage.resize(size / sizeof(uint32_t));
+		file.seekg(0);
+		file.read((char*)m_Storage.data(), m_Storage.size() * sizeof(uint32_t));
+
+		m_Data = m_Storage;
+		if (!Validate()) AGI_ERROR("\"{}\" is corrupt or from an incompatible version", path.string());
+	}
+
+	ShaderPack::ShaderPack(ShaderPack&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	ShaderPack& ShaderPack::operator=(ShaderPack&& other) noexcept
+	{
+		if (this == &other) return *this;
+
+		// Moving a vector keeps its buffer, so the views stay valid and the source ends up empty
+		m_Storage = std::move(other.m_Storage);
+		m_Data = std::exchange(other.m_Data, {});
+		m_Header = std::exchange(other.m_Header, nullptr);
+		m_Entries = std::exchange(other.m_Entries, {});
+		m_Names = std::exchange(other.m_Names, {});
+		m_Code = std::exchange(other.m_Code, {});
+		return *this;
+	}
+
+	bool ShaderPack::Validate()
+	{
+		using namespace ShaderPackFormat;
+
+		constexpr size_t headerWords = sizeof(Header) / sizeof(uint32_t);
+		constexpr size_t entryWords = sizeof(Entry) / sizeof(uint32_t);
+
+		if (m_Data.size() < headerWords) return false;
+
+		const Header* header = (const Header*)m_Data.data();
+		if (header->Magic != Magic || header->Version != ShaderPackFormat::Version) return false;
+
+		size_t namesStart = headerWords + (size_t)header->EntryCount * entryWords;
+		size_t codeStart = namesStart + header->NameWords;
+		if (codeStart > m_Data.size()) return false;
+
+		std::span<const Entry> entries((const Entry*)(m_Data.data() + headerWords), header->EntryCount);
+		std::string_view names((const char*)(m_Data.data() + namesStart), (size_t)header->NameWords * sizeof(uint32_t));
+		std::span<const uint32_t> code = m_Data.subspan(codeStart);
+
+		// Checked once here so lookups never have to
+		for (const Entry& entry : entries)
+		{
+			if ((size_t)entry.NameOffset + entry.NameLength > names.size()) return false;
+			if ((size_t)entry.CodeOffset + entry.CodeWords > code.size()) return false;
+		}
+
+		m_Header = header;
+		m_Entries = entries;
+		m_Names = names;
+		m_Code = code;
+		return true;
+	}
+
+	std::string_view ShaderPack::GetName(const ShaderPackFormat::Entry& entry) const
+	{
+		return m_Names.substr(entry.NameOffset, entry.NameLength);
+	}
+
+	std::span<const ShaderPackFormat::Entry> ShaderPack::FindEntries(std::string_view name) const
+	{
+		auto [first, last] = std::equal_range(m_Entries.begin(), m_Entries.end(), name, [this](const auto& a, const auto& b)
+		{
+			if constexpr (std::is_same_v<std::decay_t<decltype(a)>, std::string_view>)
+				return a < GetName(b);
+			else
+				return GetName(a) < b;
+		});
+
+		return std::span<const ShaderPackFormat::Entry>(first, last);
+	}
+
+	bool ShaderPack::Contains(std::string_view name) const
+	{
+		return !FindEntries(name).empty();
+	}
+
+	std::vector<std::string_view> ShaderPack::GetNames() const
+	{
+		std::vector<std::string_view> names;
+		for (const auto& entry : m_Entries)
+		{
+			std::string_view name = GetName(entry);
+			if (names.empty() || names.back() != name) names.push_back(name);
+		}
+
+		return names;
+	}
+
+	ShaderBinaries ShaderPack::GetBinaries(std::string_view name) const
+	{
+		ShaderBinaries binaries;
+		for (const auto& entry : FindEntries(name))
+		{
+			std::span<const uint32_t> code = m_Code.subspan(entry.CodeOffset, entry.CodeWords);
+			binaries[(ShaderType)entry.Type].assign(code.begin(), code.end());
+		}
+
+		return binaries;
+	}
+
+}
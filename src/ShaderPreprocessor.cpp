@@ -0,0 +1,358 @@
+#include "agipch.hpp"
+#include "AGI/ShaderPreprocessor.hpp"
+
+#include <fstream>
+
+namespace AGI {
+
+	namespace Utils {
+
+		static std::string_view TrimLeft(std::string_view text)
+		{
+			size_t start = text.find_first_not_of(" \t");
+			return start == std::string_view::npos ? std::string_view() : text.substr(start);
+		}
+
+		// 'name' on its own, not just the start of a longer word like '#includes'
+		static bool IsDirective(std::string_view line, std::string_view name, std::string_view followers = " \t\r")
+		{
+			if (!line.starts_with(name)) return false;
+			return line.size() == name.size() || followers.find(line[name.size()]) != std::string_view::npos;
+		}
+
+		// Both '#include "file"' and '#include <file>' are accepted
+		static std::string_view ParseIncludeName(std::string_view directive)
+		{
+			std::string_view rest = TrimLeft(directive.substr(8));
+			if (rest.empty()) return {};
+
+			char close = rest[0] == '"' ? '"' : (rest[0] == '<' ? '>' : 0);
+			if (!close) return {};
+
+			size_t end = rest.find(close, 1);
+			if (end == std::string_view::npos) return {};
+
+			return rest.substr(1, end - 1);
+		}
+
+		static bool HasPragmaOnce(std::string_view text)
+		{
+			for (size_t pos = 0; pos < text.size();)
+			{
+				size_t eol = text.find('\n', pos);
+				std::string_view line = text.substr(pos, eol == std::string_view::npos ? std::string_view::npos : eol - pos);
+				if (IsDirective(TrimLeft(line), "#pragma once")) return true;
+
+				if (eol == std::string_view::npos) break;
+				pos = eol + 1;
+			}
+
+			return false;
+		}
+
+	}
+
+	ShaderPreprocessor::ShaderPreprocessor(ShaderFileProvider provider)
+		: m_Provider(provider)
+	{
+		m_SourceNames.emplace_back("<source>");
+	}
+
+	ShaderSources ShaderPreprocessor::ProcessFile(std::string_view path, const ShaderDefines& defines, std::vector<std::string>* dependencies)
+	{
+		AGI_PROFILE_SCOPE("ShaderPreprocessor::ProcessFile");
+
+		ExpandState state;
+		const CachedFile* root = LoadFile(std::string(path));
+		if (!root)
+		{
+			AGI_ERROR("Could not open shader \"{}\"", path);
+			return {};
+		}
+
+		ShaderSources sources = Split(*root, defines, state);
+		if (dependencies)
+		{
+			dependencies->assign(1, std::string(path));
+
+			auto result = m_Results.find(GetResultKey(*root, defines));
+			if (result != m_Results.end())
+			{
+				for (const auto& [file, hash] : result->second.Dependencies)
+					dependencies->push_back(file);
+			}
+		}
+
+		return sources;
+	}
+
+	ShaderSources ShaderPreprocessor::Process(std::string_view source, const ShaderDefines& defines)
+	{
+		AGI_PROFILE_SCOPE("ShaderPreprocessor::Process");
+
+		// The caller owns the source for the duration of the call, no need to copy it
+		CachedFile root;
+		root.Contents = source;
+		root.Hash = Utils::HashShaderSource(source);
+		root.SourceIndex = 0;
+
+		ExpandState state;
+		return Split(root, defines, state);
+	}
+
+	std::string_view ShaderPreprocessor::GetSourceName(uint32_t index) const
+	{
+		return index < m_SourceNames.size() ? std::string_view(m_SourceNames[index]) : std::string_view();
+	}
+
+	const ShaderPreprocessor::CachedFile* ShaderPreprocessor::LoadFile(const std::string& path)
+	{
+		std::string contents;
+		if (!m_Provider || !m_Provider(path, contents)) return nullptr;
+
+		uint64_t hash = Utils::HashShaderSource(contents);
+		auto [it, inserted] = m_Files.try_emplace(path);
+		CachedFile& file = it->second;
+
+		if (inserted)
+		{
+			file.SourceIndex = m_SourceNames.size();
+			m_SourceNames.push_back(path);
+		}
+
+		// Only changed files get rescanned, views into the old contents die with this call
+		if (inserted || file.Hash != hash)
+		{
+			file.Storage = std::move(contents);
+			file.Contents = file.Storage;
+			file.Hash = hash;
+			file.PragmaOnce = Utils::HasPragmaOnce(file.Contents);
+		}
+
+		return &file;
+	}
+
+	const ShaderPreprocessor::CachedFile* ShaderPreprocessor::LoadFile(const std::string& path, ExpandState& state)
+	{
+		// A file is read at most once per call, even when it's included by several stages
+		auto it = state.Loaded.find(path);
+		if (it != state.Loaded.end()) return it->second;
+
+		const CachedFile* file = LoadFile(path);
+		state.Loaded[path] = file;
+
+		if (file) state.Dependencies.emplace_back(path, file->Hash);
+		return file;
+	}
+
+	uint64_t ShaderPreprocessor::GetResultKey(const CachedFile& root, const ShaderDefines& defines) const
+	{
+		uint64_t key = root.Hash;
+		for (const auto& [name, value] : defines)
+		{
+			key = Utils::HashShaderSource(name, key);
+			key = Utils::HashShaderSource("=", key);
+			key = Utils::HashShaderSource(value, key);
+			key = Utils::HashShaderSource("\n", key);
+		}
+
+		return key;
+	}
+
+	ShaderSources ShaderPreprocessor::Split(const CachedFile& root, const ShaderDefines& defines, ExpandState& state)
+	{
+		uint64_t key = GetResultKey(root, defines);
+
+		auto cached = m_Results.find(key);
+		if (cached != m_Results.end())
+		{
+			bool changed = false;
+			for (const auto& [path, hash] : cached->second.Dependencies)
+			{
+				const CachedFile* file = LoadFile(path, state);
+				if (!file || file->Hash != hash)
+				{
+					changed = true;
+					break;
+				}
+			}
+
+			if (!changed)
+			{
+				m_CacheHits++;
+				cached->second.LastUse = ++m_ResultUses;
+				return cached->second.Sources;
+			}
+		}
+
+		m_CacheMisses++;
+
+		// The check above already loaded some files, forget them so they get recorded again
+		state.Dependencies.clear();
+		state.Loaded.clear();
+
+		ShaderSources shaderSources;
+		std::string_view source = root.Contents;
+
+		const std::string_view typeToken = "#type";
+		size_t pos = 0;
+
+		while ((pos = source.find(typeToken, pos)) != std::string_view::npos)
+		{
+			// Errors instead of asserts, a half saved file while hot reloading is no reason to stop
+			size_t eol = source.find_first_of("\r\n", pos);
+			if (eol == std::string_view::npos)
+			{
+				AGI_ERROR("{}: Missing end of line after #type", m_SourceNames[root.SourceIndex]);
+				return {};
+			}
+
+			size_t typeStart = pos + typeToken.length() + 1;
+			std::string typeName(source.substr(typeStart, eol - typeStart));
+			ShaderType shaderType = Utils::StringToShaderType(typeName);
+			if (shaderType == ShaderType::None)
+			{
+				AGI_ERROR("{}: Unknown shader type '{}'", m_SourceNames[root.SourceIndex], typeName);
+				return {};
+			}
+
+			size_t codeStart = source.find_first_not_of("\r\n", eol);
+			if (codeStart == std::string_view::npos)
+			{
+				AGI_ERROR("{}: No shader code after #type", m_SourceNames[root.SourceIndex]);
+				return {};
+			}
+
+			size_t nextTypePos = source.find(typeToken, codeStart);
+			std::string_view code = source.substr(codeStart, nextTypePos == std::string_view::npos ? std::string_view::npos : nextTypePos - codeStart);
+
+			uint32_t firstLine = 1 + std::count(source.begin(), source.begin() + codeStart, '\n');
+
+			state.Output.clear();
+			state.Included.clear();
+			Expand(root, m_SourceNames[root.SourceIndex], code, firstLine, &defines, state);
+
+			shaderSources[shaderType] = std::move(state.Output);
+			pos = nextTypePos;
+		}
+
+		// Edited sources and defines leave entries behind that are never hit again
+		if (m_Results.size() >= s_MaxResults && !m_Results.contains(key))
+		{
+			auto oldest = std::min_element(m_Results.begin(), m_Results.end(), [](const auto& a, const auto& b) { return a.second.LastUse < b.second.LastUse; });
+			m_Results.erase(oldest);
+		}
+
+		CachedResult& result = m_Results[key];
+		result.LastUse = ++m_ResultUses;
+		result.Sources = shaderSources;
+		result.Dependencies = std::move(state.Dependencies);
+		return shaderSources;
+	}
+
+	void ShaderPreprocessor::Expand(const CachedFile& file, std::string_view path, std::string_view text, uint32_t firstLine, const ShaderDefines* defines, ExpandState& state)
+	{
+		state.Stack.push_back(&file);
+
+		uint32_t line = firstLine;
+		bool injected = defines == nullptr;
+
+		for (size_t pos = 0; pos < text.size(); ++line)
+		{
+			size_t eol = text.find('\n', pos);
+			std::string_view lineText = text.substr(pos, eol == std::string_view::npos ? std::string_view::npos : eol - pos);
+			pos = eol == std::string_view::npos ? text.size() : eol + 1;
+
+			std::string_view directive = Utils::TrimLeft(lineText);
+
+			if (Utils::IsDirective(directive, "#include", " \t\"<"))
+			{
+				std::string_view name = Utils::ParseIncludeName(directive);
+				if (name.empty())
+				{
+					AGI_ERROR("{}({}): Malformed #include", path, line);
+					state.Output += '\n';
+					continue;
+				}
+
+				// Relative to the including file first, then as given
+				std::string includePath = (std::filesystem::path(path).parent_path() / name).lexically_normal().generic_string();
+				const CachedFile* child = LoadFile(includePath, state);
+				if (!child)
+				{
+					includePath = name;
+					child = LoadFile(includePath, state);
+				}
+
+				if (!child)
+				{
+					AGI_ERROR("{}({}): Could not open include \"{}\"", path, line, name);
+				}
+				else if (std::find(state.Stack.begin(), state.Stack.end(), child) != state.Stack.end())
+				{
+					AGI_ERROR("{}({}): Recursive include of \"{}\"", path, line, name);
+				}
+				else if (!child->PragmaOnce || std::find(state.Included.begin(), state.Included.end(), child) == state.Included.end())
+				{
+					state.Included.push_back(child);
+
+					state.Output += std::format("#line 1 {}\n", child->SourceIndex);
+					Expand(*child, includePath, child->Contents, 1, nullptr, state);
+					state.Output += std::format("#line {} {}\n", line + 1, file.SourceIndex);
+					continue;
+				}
+
+				state.Output += '\n';
+				continue;
+			}
+
+			// Blank line rather than dropping it, keeps the line numbers intact
+			if (Utils::IsDirective(directive, "#pragma once"))
+			{
+				state.Output += '\n';
+				continue;
+			}
+
+			state.Output += lineText;
+			state.Output += '\n';
+
+			// Defines go straight after #version, which has to stay the first directive
+			if (!injected && directive.starts_with("#version"))
+			{
+				injected = true;
+				for (const auto& [name, value] : *defines)
+					state.Output += std::format("#define {} {}\n", name, value);
+
+				state.Output += std::format("#line {} {}\n", line + 1, file.SourceIndex);
+			}
+		}
+
+		// Without #version the code still starts below the #type line
+		if (!injected)
+		{
+			std::string prefix;
+			for (const auto& [name, value] : *defines)
+				prefix += std::format("#define {} {}\n", name, value);
+
+			prefix += std::format("#line {} {}\n", firstLine, file.SourceIndex);
+			state.Output.insert(0, prefix);
+		}
+
+		state.Stack.pop_back();
+	}
+
+	ShaderFileProvider ShaderPreprocessor::FilesystemProvider(const std::filesystem::path& root)
+	{
+		return [root](std::string_view path, std::string& contents)
+		{
+			std::ifstream file(root / path, std::ios::binary | std::ios::ate);
+			if (!file) return false;
+
+			contents.resize(file.tellg());
+			file.seekg(0);
+			file.read(contents.data(), contents.size());
+			return (bool)file;
+		};
+	}
+
+}
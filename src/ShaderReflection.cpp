@@ -0,0 +1,530 @@
+#include "agipch.hpp"
+#include "AGI/Shader.hpp"
+
+namespace AGI {
+
+	ShaderReflection::ShaderReflection(std::vector<ShaderAttribute> attributes, std::vector<ShaderUniform> uniforms, std::vector<ShaderBlock> uniformBlocks,
+		std::vector<ShaderBlock> storageBlocks, std::vector<ShaderSampler> samplers)
+		: m_Attributes(std::move(attributes)), m_Uniforms(std::move(uniforms)), m_UniformBlocks(std::move(uniformBlocks)),
+		m_StorageBlocks(std::move(storageBlocks)), m_Samplers(std::move(samplers))
+	{
+		std::sort(m_Attributes.begin(), m_Attributes.end(), [](const ShaderAttribute& a, const ShaderAttribute& b) { return a.Location < b.Location; });
+
+		for (const auto& attribute : m_Attributes)
+			m_Layout.PushBack(BufferElement(attribute.Type, attribute.Name));
+
+		// Drivers report block members in whatever order they like
+		auto sortMembers = [](ShaderBlock& block)
+		{
+			std::sort(block.Members.begin(), block.Members.end(), [](const ShaderBlockMember& a, const ShaderBlockMember& b) { return a.Offset < b.Offset; });
+		};
+
+		for (auto& block : m_UniformBlocks) sortMembers(block);
+		for (auto& block : m_StorageBlocks) sortMembers(block);
+	}
+
+	const ShaderAttribute* ShaderReflection::FindAttribute(std::string_view name) const
+	{
+		for (const auto& attribute : m_Attributes)
+			if (attribute.Name == name) return &attribute;
+
+		return nullptr;
+	}
+
+	const ShaderUniform* ShaderReflection::FindUniform(UniformID id) const
+	{
+		for (const auto& uniform : m_Uniforms)
+			if (uniform.ID == id) return &uniform;
+
+		return nullptr;
+	}
+
+	const ShaderBlock* ShaderReflection::FindUniformBlock(std::string_view name) const
+	{
+		for (const auto& block : m_UniformBlocks)
+			if (block.Name == name) return &block;
+
+		return nullptr;
+	}
+
+	const ShaderBlock* ShaderReflection::FindStorageBlock(std::string_view name) const
+	{
+		for (const auto& block : m_StorageBlocks)
+			if (block.Name == name) return &block;
+
+		return nullptr;
+	}
+
+	const ShaderSampler* ShaderReflection::FindSampler(UniformID id) const
+	{
+		for (const auto& sampler : m_Samplers)
+			if (sampler.ID == id) return &sampler;
+
+		return nullptr;
+	}
+
+	// Just enough of the SPIR-V spec to walk declarations, see the unified SPIR-V specification
+	namespace Spirv {
+
+		constexpr uint32_t Magic = 0x07230203;
+
+		enum Op : uint16_t
+		{
+			OpName = 5, OpMemberName = 6, OpEntryPoint = 15,
+			OpTypeBool = 20, OpTypeInt = 21, OpTypeFloat = 22, OpTypeVector = 23, OpTypeMatrix = 24,
+			OpTypeImage = 25, OpTypeSampledImage = 27, OpTypeArray = 28, OpTypeRuntimeArray = 29,
+			OpTypeStruct = 30, OpTypePointer = 32, OpConstant = 43, OpSpecConstant = 50,
+			OpFunction = 54, OpVariable = 59, OpDecorate = 71, OpMemberDecorate = 72
+		};
+
+		enum Decoration : uint32_t
+		{
+			SpecId = 1, Block = 2, BufferBlock = 3, ArrayStride = 6, MatrixStride = 7, BuiltIn = 11,
+			Location = 30, Binding = 33, DescriptorSet = 34, Offset = 35
+		};
+
+		enum StorageClass : uint32_t
+		{
+			UniformConstant = 0, Input = 1, Uniform = 2, StorageBuffer = 12
+		};
+
+		enum ExecutionModel : uint32_t
+		{
+			Vertex = 0
+		};
+
+		struct Id
+		{
+			uint16_t Op = 0;
+			std::vector<uint32_t> Operands; // Type operands, or the value of a constant
+
+			std::string Name;
+			std::vector<std::string> MemberNames;
+			std::vector<uint32_t> MemberOffsets;
+			std::vector<uint32_t> MemberMatrixStrides;
+
+			int32_t Location = -1;
+			uint32_t Binding = 0, Set = 0, ArrayStride = 0;
+			bool Block = false, BufferBlock = false, BuiltIn = false;
+		};
+
+		class Module
+		{
+		public:
+			Module(std::span<const uint32_t> words);
+
+			bool IsValid() const { return m_Valid; }
+			bool IsVertex() const { return m_Vertex; }
+
+			ShaderDataType GetDataType(uint32_t type) const;
+			SamplerType GetSamplerType(uint32_t type) const;
+			uint32_t GetArraySize(uint32_t type) const;
+			uint32_t GetSize(uint32_t type, uint32_t matrixStride = 0) const;
+			uint32_t StripArrays(uint32_t type) const;
+
+			ShaderBlock GetBlock(uint32_t variable, uint32_t structType) const;
+
+			std::vector<Id> Ids;
+			std::vector<uint32_t> Variables;
+			std::vector<uint32_t> SpecializationIDs;
+		private:
+			bool m_Valid = false;
+			bool m_Vertex = false;
+		};
+
+		// Universal limits, anything above them isn't a module a driver would accept
+		constexpr uint32_t MaxIdBound = 4194303;
+		constexpr uint32_t MaxStructMembers = 16383;
+
+		// Leading words the parser reads after the opcode, shorter instructions are malformed
+		static size_t GetMinArgs(uint16_t op)
+		{
+			switch (op)
+			{
+			case OpName: case OpDecorate: return 2;
+			case OpMemberName: case OpMemberDecorate: case OpEntryPoint: return 3;
+			case OpConstant: case OpSpecConstant: case OpVariable: return 3;
+			case OpTypeBool: case OpTypeStruct: return 1;
+			case OpTypeFloat: case OpTypeSampledImage: case OpTypeRuntimeArray: return 2;
+			case OpTypeInt: case OpTypeVector: case OpTypeMatrix: case OpTypeArray: case OpTypePointer: return 3;
+			case OpTypeImage: return 8;
+			}
+
+			return 0;
+		}
+
+		// Types may only refer to ids declared before them, which also rules out cycles
+		static bool HasValidOperands(uint16_t op, const std::vector<uint32_t>& operands, const std::vector<Id>& ids)
+		{
+			auto declared = [&](uint32_t id) { return id < ids.size() && ids[id].Op != 0; };
+
+			switch (op)
+			{
+			case OpTypeVector: case OpTypeMatrix: case OpTypeImage:
+			case OpTypeSampledImage: case OpTypeRuntimeArray:
+				return declared(operands[0]);
+			case OpTypeArray:
+				return declared(operands[0]) && declared(operands[1]);
+			case OpTypePointer:
+				return declared(operands[1]);
+			case OpTypeStruct:
+				return operands.size() <= MaxStructMembers && std::all_of(operands.begin(), operands.end(), declared);
+			}
+
+			return true;
+		}
+
+		static std::string ReadString(std::span<const uint32_t> words)
+		{
+			const char* chars = (const char*)words.data();
+			return std::string(chars, strnlen(chars, words.size() * sizeof(uint32_t)));
+		}
+
+		Module::Module(std::span<const uint32_t> words)
+		{
+			if (words.size() < 5 || words[0] != Magic || words[3] > MaxIdBound) return;
+
+			Ids.resize(words[3]); // Id bound
+
+			for (size_t pos = 5; pos < words.size();)
+			{
+				uint16_t op = words[pos] & 0xFFFF;
+				uint16_t count = words[pos] >> 16;
+				if (count == 0 || pos + count > words.size()) return;
+
+				std::span<const uint32_t> args = words.subspan(pos + 1, count - 1);
+				pos += count;
+
+				if (args.size() < GetMinArgs(op)) return;
+
+				// Every id is below the bound, a module that breaks that is rejected after this instruction
+				bool badId = false;
+				auto id = [&](uint32_t index) -> Id* { if (index < Ids.size()) return &Ids[index]; badId = true; return nullptr; };
+
+				switch (op)
+				{
+				case OpName:
+					if (Id* target = id(args[0])) target->Name = ReadString(args.subspan(1));
+					break;
+				case OpMemberName:
+					if (Id* target = id(args[0]); target && args[1] < MaxStructMembers)
+					{
+						if (target->MemberNames.size() <= args[1]) target->MemberNames.resize(args[1] + 1);
+						target->MemberNames[args[1]] = ReadString(args.subspan(2));
+					}
+					break;
+				case OpEntryPoint:
+					m_Vertex |= args[0] == Vertex;
+					break;
+				case OpDecorate:
+					if (Id* target = id(args[0]))
+					{
+						uint32_t value = args.size() > 2 ? args[2] : 0;
+						switch (args[1])
+						{
+						case Spirv::Block:       target->Block = true; break;
+						case Spirv::BufferBlock: target->BufferBlock = true; break;
+						case Spirv::BuiltIn:     target->BuiltIn = true; break;
+						case Spirv::ArrayStride: target->ArrayStride = value; break;
+						case Spirv::Location:    target->Location = value; break;
+						case Spirv::Binding:     target->Binding = value; break;
+						case Spirv::DescriptorSet: target->Set = value; break;
+						case Spirv::SpecId:      SpecializationIDs.push_back(value); break;
+						}
+					}
+					break;
+				case OpMemberDecorate:
+					if (Id* target = id(args[0]); target && args.size() > 3 && args[1] < MaxStructMembers)
+					{
+						uint32_t member = args[1];
+						if (args[2] == Spirv::Offset)
+						{
+							if (target->MemberOffsets.size() <= member) target->MemberOffsets.resize(member + 1);
+							target->MemberOffsets[member] = args[3];
+						}
+						else if (args[2] == Spirv::MatrixStride)
+						{
+							if (target->MemberMatrixStrides.size() <= member) target->MemberMatrixStrides.resize(member + 1);
+							target->MemberMatrixStrides[member] = args[3];
+						}
+						else if (args[2] == Spirv::BuiltIn)
+						{
+							target->BuiltIn = true;
+						}
+					}
+					break;
+				case OpTypeBool: case OpTypeInt: case OpTypeFloat: case OpTypeVector: case OpTypeMatrix:
+				case OpTypeImage: case OpTypeSampledImage: case OpTypeArray: case OpTypeRuntimeArray:
+				case OpTypeStruct: case OpTypePointer:
+					if (Id* target = id(args[0]))
+					{
+						// Ids are only defined once
+						if (target->Op != 0) return;
+
+						target->Operands.assign(args.begin() + 1, args.end());
+						if (!HasValidOperands(op, target->Operands, Ids)) return;
+
+						target->Op = op;
+					}
+					break;
+				case OpConstant: case OpSpecConstant:
+					if (Id* target = id(args[1]))
+					{
+						if (target->Op != 0) return;
+
+						target->Op = op;
+						target->Operands.assign(args.begin() + 2, args.end());
+					}
+					break;
+				case OpVariable:
+					if (Id* target = id(args[1]))
+					{
+						if (target->Op != 0 || args[0] >= Ids.size() || Ids[args[0]].Op != OpTypePointer) return;
+
+						target->Op = op;
+						target->Operands = { args[0], args[2] }; // Pointer type, storage class
+						Variables.push_back(args[1]);
+					}
+					break;
+				case OpFunction:
+					// Declarations all come before the first function
+					pos = words.size();
+					break;
+				}
+
+				if (badId) return;
+			}
+
+			m_Valid = true;
+		}
+
+		ShaderDataType Module::GetDataType(uint32_t type) const
+		{
+			const Id& id = Ids[type];
+			switch (id.Op)
+			{
+			case OpTypeBool:  return ShaderDataType::Bool;
+			case OpTypeFloat: return id.Operands[0] == 32 ? ShaderDataType::Float : ShaderDataType::Unknown;
+			case OpTypeInt:   return id.Operands[0] == 32 && id.Operands[1] ? ShaderDataType::Int : ShaderDataType::Unknown;
+			case OpTypeVector:
+			{
+				ShaderDataType component = GetDataType(id.Operands[0]);
+				uint32_t count = id.Operands[1];
+				if (component == ShaderDataType::Float && count >= 2) return (ShaderDataType)((uint32_t)ShaderDataType::Float + count - 1);
+				if (component == ShaderDataType::Int && count >= 2)   return (ShaderDataType)((uint32_t)ShaderDataType::Int + count - 1);
+				return ShaderDataType::Unknown;
+			}
+			case OpTypeMatrix:
+			{
+				ShaderDataType column = GetDataType(id.Operands[0]);
+				if (column == ShaderDataType::Float3 && id.Operands[1] == 3) return ShaderDataType::Mat3;
+				if (column == ShaderDataType::Float4 && id.Operands[1] == 4) return ShaderDataType::Mat4;
+				return ShaderDataType::Unknown;
+			}
+			}
+
+			return ShaderDataType::Unknown;
+		}
+
+		SamplerType Module::GetSamplerType(uint32_t type) const
+		{
+			const Id* id = &Ids[type];
+			if (id->Op == OpTypeSampledImage) id = &Ids[id->Operands[0]];
+			if (id->Op != OpTypeImage) return SamplerType::Unknown;
+
+			uint32_t dim = id->Operands[1];
+			bool arrayed = id->Operands[3];
+
+			switch (dim)
+			{
+			case 0: return SamplerType::Sampler1D;
+			case 1: return arrayed ? SamplerType::Sampler2DArray : SamplerType::Sampler2D;
+			case 2: return SamplerType::Sampler3D;
+			case 3: return arrayed ? SamplerType::SamplerCubeArray : SamplerType::SamplerCube;
+			case 5: return SamplerType::SamplerBuffer;
+			}
+
+			return SamplerType::Unknown;
+		}
+
+		uint32_t Module::GetArraySize(uint32_t type) const
+		{
+			const Id& id = Ids[type];
+			if (id.Op == OpTypeRuntimeArray) return 0;
+			if (id.Op != OpTypeArray) return 1;
+
+			const Id& length = Ids[id.Operands[1]];
+			return length.Operands.empty() ? 1 : length.Operands[0];
+		}
+
+		uint32_t Module::StripArrays(uint32_t type) const
+		{
+			while (Ids[type].Op == OpTypeArray || Ids[type].Op == OpTypeRuntimeArray)
+				type = Ids[type].Operands[0];
+
+			return type;
+		}
+
+		uint32_t Module::GetSize(uint32_t type, uint32_t matrixStride) const
+		{
+			const Id& id = Ids[type];
+			switch (id.Op)
+			{
+			case OpTypeBool: return 4;
+			case OpTypeInt: case OpTypeFloat: return id.Operands[0] / 8;
+			case OpTypeVector: return GetSize(id.Operands[0]) * id.Operands[1];
+			case OpTypeMatrix: return (matrixStride ? matrixStride : GetSize(id.Operands[0])) * id.Operands[1];
+			case OpTypeArray: return id.ArrayStride * GetArraySize(type);
+			case OpTypeRuntimeArray: return 0;
+			case OpTypeStruct:
+			{
+				uint32_t size = 0;
+				for (size_t i = 0; i < id.Operands.size(); ++i)
+				{
+					uint32_t offset = i < id.MemberOffsets.size() ? id.MemberOffsets[i] : 0;
+					uint32_t stride = i < id.MemberMatrixStrides.size() ? id.MemberMatrixStrides[i] : 0;
+					size = std::max(size, offset + GetSize(id.Operands[i], stride));
+				}
+
+				return size;
+			}
+			}
+
+			return 0;
+		}
+
+		ShaderBlock Module::GetBlock(uint32_t variable, uint32_t structType) const
+		{
+			const Id& var = Ids[variable];
+			const Id& type = Ids[structType];
+
+			ShaderBlock block;
+			block.Name = type.Name.empty() ? var.Name : type.Name;
+			block.Binding = var.Binding;
+			block.Set = var.Set;
+			block.Size = GetSize(structType);
+
+			for (size_t i = 0; i < type.Operands.size(); ++i)
+			{
+				uint32_t memberType = type.Operands[i];
+				uint32_t stride = i < type.MemberMatrixStrides.size() ? type.MemberMatrixStrides[i] : 0;
+
+				ShaderBlockMember& member = block.Members.emplace_back();
+				member.Name = i < type.MemberNames.size() ? type.MemberNames[i] : std::string();
+				member.Type = GetDataType(StripArrays(memberType));
+				member.Offset = i < type.MemberOffsets.size() ? type.MemberOffsets[i] : 0;
+				member.Size = GetSize(memberType, stride);
+				member.ArraySize = GetArraySize(memberType);
+				member.ArrayStride = Ids[memberType].ArrayStride;
+			}
+
+			return block;
+		}
+
+	}
+
+	namespace Utils {
+
+		static bool HasBinding(const std::vector<ShaderBlock>& blocks, uint32_t set, uint32_t binding)
+		{
+			return std::any_of(blocks.begin(), blocks.end(), [&](const ShaderBlock& block) { return block.Set == set && block.Binding == binding; });
+		}
+
+		ShaderReflection ReflectSpirv(const std::vector<std::span<const uint32_t>>& modules)
+		{
+			std::vector<ShaderAttribute> attributes;
+			std::vector<ShaderUniform> uniforms;
+			std::vector<ShaderBlock> uniformBlocks;
+			std::vector<ShaderBlock> storageBlocks;
+			std::vector<ShaderSampler> samplers;
+
+			for (std::span<const uint32_t> words : modules)
+			{
+				Spirv::Module module(words);
+				if (!module.IsValid())
+				{
+					AGI_ERROR("Invalid SPIR-V module, skipping reflection");
+					continue;
+				}
+
+				for (uint32_t variable : module.Variables)
+				{
+					const Spirv::Id& var = module.Ids[variable];
+					uint32_t storage = var.Operands[1];
+
+					const Spirv::Id& pointer = module.Ids[var.Operands[0]];
+					if (pointer.Op != Spirv::OpTypePointer) continue;
+
+					uint32_t type = pointer.Operands[1];
+					uint32_t baseType = module.StripArrays(type);
+					const Spirv::Id& base = module.Ids[baseType];
+
+					if (storage == Spirv::Input)
+					{
+						if (!module.IsVertex() || var.BuiltIn || base.BuiltIn || var.Location == -1) continue;
+
+						ShaderAttribute& attribute = attributes.emplace_back();
+						attribute.Name = var.Name;
+						attribute.Type = module.GetDataType(baseType);
+						attribute.Location = var.Location;
+					}
+					else if ((storage == Spirv::Uniform || storage == Spirv::StorageBuffer) && base.Op != Spirv::OpTypeStruct)
+					{
+						continue;
+					}
+					else if ((storage == Spirv::Uniform && base.BufferBlock) || storage == Spirv::StorageBuffer)
+					{
+						if (!HasBinding(storageBlocks, var.Set, var.Binding))
+							storageBlocks.push_back(module.GetBlock(variable, baseType));
+					}
+					else if (storage == Spirv::Uniform)
+					{
+						if (!HasBinding(uniformBlocks, var.Set, var.Binding))
+							uniformBlocks.push_back(module.GetBlock(variable, baseType));
+					}
+					else if (storage == Spirv::UniformConstant)
+					{
+						SamplerType samplerType = module.GetSamplerType(baseType);
+						if (samplerType != SamplerType::Unknown)
+						{
+							bool exists = std::any_of(samplers.begin(), samplers.end(), [&](const ShaderSampler& sampler) { return sampler.Set == var.Set && sampler.Binding == var.Binding; });
+							if (exists) continue;
+
+							ShaderSampler& sampler = samplers.emplace_back();
+							sampler.Name = var.Name;
+							sampler.ID = HashUniformName(var.Name);
+							sampler.Type = samplerType;
+							sampler.Location = var.Location;
+							sampler.Binding = var.Binding;
+							sampler.Set = var.Set;
+							sampler.ArraySize = module.GetArraySize(type);
+						}
+						else if (var.Location != -1)
+						{
+							// Loose uniforms only exist in SPIR-V made for OpenGL
+							bool exists = std::any_of(uniforms.begin(), uniforms.end(), [&](const ShaderUniform& uniform) { return uniform.Location == var.Location; });
+							if (exists) continue;
+
+							ShaderUniform& uniform = uniforms.emplace_back();
+							uniform.Name = var.Name;
+							uniform.ID = HashUniformName(var.Name);
+							uniform.Type = module.GetDataType(baseType);
+							uniform.Location = var.Location;
+							uniform.ArraySize = module.GetArraySize(type);
+						}
+					}
+				}
+			}
+
+			return ShaderReflection(std::move(attributes), std::move(uniforms), std::move(uniformBlocks), std::move(storageBlocks), std::move(samplers));
+		}
+
+		std::vector<uint32_t> GetSpirvSpecializationIDs(std::span<const uint32_t> words)
+		{
+			Spirv::Module module(words);
+			return module.IsValid() ? module.SpecializationIDs : std::vector<uint32_t>();
+		}
+
+	}
+
+}
@@ -0,0 +1,133 @@
+#include "agipch.hpp"
+#include "AGI/ShaderWatcher.hpp"
+
+#if defined(AGI_LINUX)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+namespace AGI {
+
+	ShaderWatcher::ShaderWatcher(RenderContext* context, const std::filesystem::path& root)
+		: m_Context(context), m_Root(root), m_Preprocessor(ShaderPreprocessor::FilesystemProvider(root))
+	{
+#if defined(AGI_LINUX)
+		m_Handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_Handle == -1) AGI_WARN("inotify_init1 failed ({}), shaders won't hot reload", strerror(errno));
+#else
+		AGI_WARN("Shader hot reload is only supported on Linux");
+#endif
+	}
+
+	ShaderWatcher::~ShaderWatcher()
+	{
+#if defined(AGI_LINUX)
+		if (m_Handle != -1) close(m_Handle);
+#endif
+	}
+
+	Shader ShaderWatcher::Load(std::string_view path, const ShaderDefines& defines)
+	{
+		WatchedShader watched;
+		watched.Path = path;
+		watched.Defines = defines;
+
+		ShaderSources sources = m_Preprocessor.ProcessFile(path, defines, &watched.Dependencies);
+		if (sources.empty()) return nullptr;
+
+		// Nothing to reload into, Vulkan can't compile GLSL at all
+		watched.Handle = m_Context->CreateShader(sources);
+		if (!watched.Handle) return nullptr;
+
+		WatchFiles(watched.Dependencies);
+
+		m_Shaders.push_back(std::move(watched));
+		return m_Shaders.back().Handle;
+	}
+
+	void ShaderWatcher::Unwatch(const Shader& shader)
+	{
+		std::erase_if(m_Shaders, [&](const WatchedShader& watched) { return watched.Handle == shader; });
+	}
+
+	void ShaderWatcher::WatchFiles(const std::vector<std::string>& files)
+	{
+#if defined(AGI_LINUX)
+		if (m_Handle == -1) return;
+
+		// Directories rather than files, editors often save by replacing the file
+		for (const std::string& file : files)
+		{
+			std::filesystem::path directory = (m_Root / file).parent_path();
+			if (directory.empty()) directory = ".";
+
+			int watch = inotify_add_watch(m_Handle, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+			if (watch == -1)
+			{
+				AGI_WARN("Can't watch \"{}\" for shader changes ({})", directory.string(), strerror(errno));
+				continue;
+			}
+
+			m_Directories[watch] = directory;
+		}
+#endif
+	}
+
+	uint32_t ShaderWatcher::Poll()
+	{
+#if defined(AGI_LINUX)
+		if (m_Handle == -1) return 0;
+
+		AGI_PROFILE_SCOPE("ShaderWatcher::Poll");
+
+		std::vector<std::filesystem::path> changed;
+		alignas(inotify_event) char buffer[4096];
+
+		while (true)
+		{
+			ssize_t length = read(m_Handle, buffer, sizeof(buffer));
+			if (length <= 0) break; // EAGAIN once drained
+
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const inotify_event* event = (const inotify_event*)(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				auto directory = m_Directories.find(event->wd);
+				if (directory == m_Directories.end() || event->len == 0) continue;
+
+				changed.push_back((directory->second / event->name).lexically_normal());
+			}
+		}
+
+		if (changed.empty()) return 0;
+
+		uint32_t reloads = 0;
+		for (WatchedShader& watched : m_Shaders)
+		{
+			bool affected = std::any_of(watched.Dependencies.begin(), watched.Dependencies.end(), [&](const std::string& file)
+			{
+				std::filesystem::path path = (m_Root / file).lexically_normal();
+				return std::find(changed.begin(), changed.end(), path) != changed.end();
+			});
+
+			if (!affected || !watched.Handle) continue;
+
+			AGI_INFO("Reloading shader \"{}\"", watched.Path);
+
+			// The include set may have changed with the edit
+			ShaderSources sources = m_Preprocessor.ProcessFile(watched.Path, watched.Defines, &watched.Dependencies);
+			WatchFiles(watched.Dependencies);
+
+			if (!sources.empty() && watched.Handle->Reload(sources))
+				reloads++;
+		}
+
+		return reloads;
+#else
+		return 0;
+#endif
+	}
+
+}
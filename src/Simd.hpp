@@ -0,0 +1,91 @@
+#pragma once
+
+// Four float lanes on SSE2 and NEON, plain floats everywhere else
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+	#define AGI_SIMD_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#define AGI_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace AGI::Simd {
+
+#if defined(AGI_SIMD_SSE2)
+
+	struct Float4
+	{
+		__m128 Value;
+
+		Float4() : Value(_mm_setzero_ps()) {}
+		Float4(__m128 value) : Value(value) {}
+		explicit Float4(float value) : Value(_mm_set1_ps(value)) {}
+
+		static Float4 Load(const float* data) { return _mm_loadu_ps(data); }
+		void Store(float* data) const { _mm_storeu_ps(data, Value); }
+
+		Float4 operator+(Float4 other) const { return _mm_add_ps(Value, other.Value); }
+		Float4 operator-(Float4 other) const { return _mm_sub_ps(Value, other.Value); }
+		Float4 operator*(Float4 other) const { return _mm_mul_ps(Value, other.Value); }
+		Float4 operator*(float scale) const { return _mm_mul_ps(Value, _mm_set1_ps(scale)); }
+		Float4& operator+=(Float4 other) { Value = _mm_add_ps(Value, other.Value); return *this; }
+
+		static Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a.Value, b.Value); }
+		static Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a.Value, b.Value); }
+
+		float Sum() const { __m128 pairs = _mm_add_ps(Value, _mm_movehl_ps(Value, Value)); return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1))); }
+	};
+
+#elif defined(AGI_SIMD_NEON)
+
+	struct Float4
+	{
+		float32x4_t Value;
+
+		Float4() : Value(vdupq_n_f32(0.0f)) {}
+		Float4(float32x4_t value) : Value(value) {}
+		explicit Float4(float value) : Value(vdupq_n_f32(value)) {}
+
+		static Float4 Load(const float* data) { return vld1q_f32(data); }
+		void Store(float* data) const { vst1q_f32(data, Value); }
+
+		Float4 operator+(Float4 other) const { return vaddq_f32(Value, other.Value); }
+		Float4 operator-(Float4 other) const { return vsubq_f32(Value, other.Value); }
+		Float4 operator*(Float4 other) const { return vmulq_f32(Value, other.Value); }
+		Float4 operator*(float scale) const { return vmulq_n_f32(Value, scale); }
+		Float4& operator+=(Float4 other) { Value = vaddq_f32(Value, other.Value); return *this; }
+
+		static Float4 Min(Float4 a, Float4 b) { return vminq_f32(a.Value, b.Value); }
+		static Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a.Value, b.Value); }
+
+		float Sum() const { float32x2_t pairs = vadd_f32(vget_low_f32(Value), vget_high_f32(Value)); return vget_lane_f32(vpadd_f32(pairs, pairs), 0); }
+	};
+
+#else
+
+	struct Float4
+	{
+		float Value[4];
+
+		Float4() : Value{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+		explicit Float4(float value) : Value{ value, value, value, value } {}
+
+		static Float4 Load(const float* data) { Float4 result; std::memcpy(result.Value, data, sizeof(result.Value)); return result; }
+		void Store(float* data) const { std::memcpy(data, Value, sizeof(Value)); }
+
+		Float4 operator+(Float4 other) const { Float4 r; for (int i = 0; i < 4; ++i) r.Value[i] = Value[i] + other.Value[i]; return r; }
+		Float4 operator-(Float4 other) const { Float4 r; for (int i = 0; i < 4; ++i) r.Value[i] = Value[i] - other.Value[i]; return r; }
+		Float4 operator*(Float4 other) const { Float4 r; for (int i = 0; i < 4; ++i) r.Value[i] = Value[i] * other.Value[i]; return r; }
+		Float4 operator*(float scale) const { Float4 r; for (int i = 0; i < 4; ++i) r.Value[i] = Value[i] * scale; return r; }
+		Float4& operator+=(Float4 other) { *this = *this + other; return *this; }
+
+		static Float4 Min(Float4 a, Float4 b) { Float4 r; for (int i = 0; i < 4; ++i) r.Value[i] = std::min(a.Value[i], b.Value[i]); return r; }
+		static Float4 Max(Float4 a, Float4 b) { Float4 r; for (int i = 0; i < 4; ++i) r.Value[i] = std::max(a.Value[i], b.Value[i]); return r; }
+
+		float Sum() const { return Value[0] + Value[1] + Value[2] + Value[3]; }
+	};
+
+#endif
+
+}
@@ -0,0 +1,416 @@
+#include "agipch.hpp"
+#include "AGI/TextureAtlas.hpp"
+
+namespace AGI {
+
+	// Lowest height of at least 'height' whose widest freed rectangle is at least 'width' wide,
+	// UINT32_MAX when there's none. Subtrees that are too narrow or too short are skipped whole.
+	static uint32_t FindFreedHeight(const std::vector<uint32_t>& widths, size_t node, uint32_t low, uint32_t high, uint32_t height, uint32_t width)
+	{
+		if (high < height || widths[node] < width) return UINT32_MAX;
+		if (low == high) return low;
+
+		uint32_t middle = low + (high - low) / 2;
+		uint32_t found = FindFreedHeight(widths, node * 2, low, middle, height, width);
+		return found != UINT32_MAX ? found : FindFreedHeight(widths, node * 2 + 1, middle + 1, high, height, width);
+	}
+
+	TextureAtlas::TextureAtlas(RenderContext* context, const AtlasSpecification& spec)
+		: m_Context(context), m_Specification(spec)
+	{
+		AGI_VERIFY(!Utils::IsCompressed(spec.Format), "Texture atlases need an uncompressed format");
+		AGI_VERIFY(spec.MaxPages > 0, "Texture atlas needs at least one page");
+
+		TextureSpecification textureSpec;
+		textureSpec.Format = spec.Format;
+		textureSpec.BytesPerChannel = spec.BytesPerChannel;
+		m_BytesPerPixel = Utils::GetBytesPerPixel(textureSpec);
+	}
+
+	AtlasHandle TextureAtlas::Add(const void* data, const glm::uvec2& size, uint32_t rowPitch)
+	{
+		AGI_PROFILE_SCOPE("TextureAtlas::Add");
+
+		uint32_t padding = m_Specification.Padding;
+		glm::uvec2 padded = { size.x + padding * 2, size.y + padding * 2 };
+
+		if (!data || size.x == 0 || size.y == 0 || padded.x > m_Specification.PageSize.x || padded.y > m_Specification.PageSize.y)
+		{
+			AGI_ERROR("Atlas image of {}x{} doesn't fit a {}x{} page", size.x, size.y, m_Specification.PageSize.x, m_Specification.PageSize.y);
+			return 0;
+		}
+
+		uint32_t rowSize = size.x * m_BytesPerPixel;
+		if (rowPitch == 0) rowPitch = rowSize;
+
+		if (rowPitch < rowSize)
+		{
+			AGI_ERROR("Atlas image row pitch {} is smaller than a row of {} bytes", rowPitch, rowSize);
+			return 0;
+		}
+
+		// Edge texels are repeated outwards into the padding
+		Entry entry;
+		entry.PaddedSize = padded;
+		entry.Pixels.resize((size_t)padded.x * padded.y * m_BytesPerPixel);
+
+		for (uint32_t y = 0; y < padded.y; ++y)
+		{
+			uint32_t sourceY = std::clamp((int32_t)y - (int32_t)padding, 0, (int32_t)size.y - 1);
+			const uint8_t* source = (const uint8_t*)data + (size_t)sourceY * rowPitch;
+			uint8_t* destination = entry.Pixels.data() + (size_t)y * padded.x * m_BytesPerPixel;
+
+			for (uint32_t x = 0; x < padding; ++x)
+			{
+				std::memcpy(destination + x * m_BytesPerPixel, source, m_BytesPerPixel);
+				std::memcpy(destination + (padding + size.x + x) * m_BytesPerPixel, source + rowSize - m_BytesPerPixel, m_BytesPerPixel);
+			}
+
+			std::memcpy(destination + padding * m_BytesPerPixel, source, rowSize);
+		}
+
+		// Existing pages first, a new one only when none of them has room
+		TextureRegion region;
+		uint32_t page = 0;
+		while (page < m_Pages.size() && !Allocate(m_Pages[page], padded, region))
+			page++;
+
+		if (page == m_Pages.size())
+		{
+			if (m_Pages.size() >= m_Specification.MaxPages)
+			{
+				AGI_WARN("Texture atlas is full, Repack() it or raise MaxPages");
+				return 0;
+			}
+
+			Page& newPage = m_Pages.emplace_back();
+			newPage.Image = CreatePageTexture();
+			ResetPage(newPage);
+
+			if (!newPage.Image || !Allocate(newPage, padded, region))
+			{
+				m_Pages.pop_back();
+				return 0;
+			}
+		}
+
+		AtlasHandle handle = m_NextHandle++;
+		Entry& stored = m_Entries.emplace(handle, std::move(entry)).first->second;
+
+		Place(stored, page, region);
+		Upload(stored);
+		return handle;
+	}
+
+	void TextureAtlas::Remove(AtlasHandle handle)
+	{
+		auto it = m_Entries.find(handle);
+		if (it == m_Entries.end())
+		{
+			AGI_WARN("Texture atlas has no image with handle {}", handle);
+			return;
+		}
+
+		// The texels stay until something else is packed there
+		Page& page = m_Pages[it->second.Region.Page];
+		TextureRegion padded = GetPaddedRegion(it->second);
+		uint64_t area = (uint64_t)padded.Width * padded.Height;
+
+		AddFreed(page, padded);
+		page.UsedArea -= area;
+
+		m_Entries.erase(it);
+	}
+
+	const AtlasRegion* TextureAtlas::Get(AtlasHandle handle) const
+	{
+		auto it = m_Entries.find(handle);
+		return it != m_Entries.end() ? &it->second.Region : nullptr;
+	}
+
+	bool TextureAtlas::Repack()
+	{
+		AGI_PROFILE_SCOPE("TextureAtlas::Repack");
+
+		// Tallest first keeps the skyline flat
+		std::vector<Entry*> order;
+		order.reserve(m_Entries.size());
+		for (auto& [handle, entry] : m_Entries)
+			order.push_back(&entry);
+
+		std::sort(order.begin(), order.end(), [](const Entry* a, const Entry* b)
+		{
+			return a->PaddedSize.y != b->PaddedSize.y ? a->PaddedSize.y > b->PaddedSize.y : a->PaddedSize.x > b->PaddedSize.x;
+		});
+
+		// Packed into fresh pages first, so a failure changes nothing
+		std::vector<Page> pages(1);
+		ResetPage(pages[0]);
+
+		std::vector<std::pair<uint32_t, TextureRegion>> placements(order.size());
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			uint32_t page = 0;
+			while (page < pages.size() && !Allocate(pages[page], order[i]->PaddedSize, placements[i].second))
+				page++;
+
+			if (page == pages.size())
+			{
+				if (pages.size() >= m_Specification.MaxPages)
+				{
+					AGI_WARN("Texture atlas images don't fit in {} pages after repacking, nothing was moved", m_Specification.MaxPages);
+					return false;
+				}
+
+				ResetPage(pages.emplace_back());
+				Allocate(pages.back(), order[i]->PaddedSize, placements[i].second);
+			}
+
+			placements[i].first = page;
+		}
+
+		// Textures are kept, pages that ended up empty stay around for later images.
+		// New ones are created before anything moves, so failing still changes nothing.
+		std::vector<Texture> textures(std::max(pages.size(), m_Pages.size()));
+		for (uint32_t page = 0; page < textures.size(); ++page)
+		{
+			textures[page] = page < m_Pages.size() ? m_Pages[page].Image : CreatePageTexture();
+			if (!textures[page])
+			{
+				AGI_ERROR("Failed to create a texture atlas page, nothing was moved");
+				return false;
+			}
+		}
+
+		pages.resize(textures.size());
+		for (uint32_t page = 0; page < textures.size(); ++page)
+		{
+			if (pages[page].Skyline.empty()) ResetPage(pages[page]);
+			pages[page].Image = std::move(textures[page]);
+		}
+
+		m_Pages = std::move(pages);
+
+		// Images that kept their place still have their texels there
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			Entry& entry = *order[i];
+			AtlasRegion previous = entry.Region;
+
+			Place(entry, placements[i].first, placements[i].second);
+
+			if (previous.Page != entry.Region.Page || previous.Region.X != entry.Region.Region.X || previous.Region.Y != entry.Region.Region.Y)
+				Upload(entry);
+		}
+
+		return true;
+	}
+
+	float TextureAtlas::GetFragmentation() const
+	{
+		uint64_t freed = 0, used = 0;
+		for (const Page& page : m_Pages)
+		{
+			freed += page.FreedArea;
+			used += page.UsedArea;
+		}
+
+		return freed + used > 0 ? (float)freed / (freed + used) : 0.0f;
+	}
+
+	Texture TextureAtlas::CreatePageTexture() const
+	{
+		TextureSpecification spec;
+		spec.Size = m_Specification.PageSize;
+		spec.Format = m_Specification.Format;
+		spec.BytesPerChannel = m_Specification.BytesPerChannel;
+		spec.SRGB = m_Specification.SRGB;
+		spec.LinearFiltering = m_Specification.LinearFiltering;
+		spec.Wrapping = WrappingType::ClampEdge;
+
+		// Mips would blend neighbouring images together
+		spec.MipLevels = 1;
+		spec.GenerateMips = false;
+
+		return m_Context->CreateTexture(spec);
+	}
+
+	void TextureAtlas::ResetPage(Page& page) const
+	{
+		page.Skyline = { { 0, { 0, m_Specification.PageSize.x } } };
+		page.SkylineHeights = { { 0, 0 } };
+
+		// A leaf for every height a rectangle can have, 0 up to the page height
+		page.Freed.clear();
+		page.FreedWidths.assign((size_t)std::bit_ceil(m_Specification.PageSize.y + 1) * 2, 0);
+		page.FreedArea = 0;
+		page.UsedArea = 0;
+	}
+
+	bool TextureAtlas::Allocate(Page& page, const glm::uvec2& size, TextureRegion& region) const
+	{
+		return AllocateFreed(page, size, region) || AllocateSkyline(page, size, region);
+	}
+
+	bool TextureAtlas::AllocateFreed(Page& page, const glm::uvec2& size, TextureRegion& region) const
+	{
+		uint32_t height = FindFreedHeight(page.FreedWidths, 1, 0, (uint32_t)page.FreedWidths.size() / 2 - 1, size.y, size.x);
+		if (height == UINT32_MAX) return false;
+
+		// Narrowest of the shortest rectangles that are tall enough
+		std::multimap<uint32_t, TextureRegion>& sameHeight = page.Freed[height];
+		auto it = sameHeight.lower_bound(size.x);
+
+		TextureRegion freed = it->second;
+		sameHeight.erase(it);
+		if (sameHeight.empty()) page.Freed.erase(height);
+
+		UpdateFreedWidth(page, height);
+		page.FreedArea -= (uint64_t)freed.Width * freed.Height;
+
+		region = { freed.X, freed.Y, size.x, size.y };
+
+		// What's left goes back as a strip to the right and one above
+		TextureRegion right = { freed.X + size.x, freed.Y, freed.Width - size.x, size.y };
+		TextureRegion above = { freed.X, freed.Y + size.y, freed.Width, freed.Height - size.y };
+
+		for (const TextureRegion& leftover : { right, above })
+		{
+			if (leftover.Width != 0 && leftover.Height != 0)
+				AddFreed(page, leftover);
+		}
+
+		return true;
+	}
+
+	bool TextureAtlas::AllocateSkyline(Page& page, const glm::uvec2& size, TextureRegion& region) const
+	{
+		const glm::uvec2& pageSize = m_Specification.PageSize;
+		std::map<uint32_t, SkylineSegment>& skyline = page.Skyline;
+
+		// Bottom-left: segments are tried lowest first, the first one with enough neighbours no
+		// higher than it is where the rectangle rests lowest. Usually one of the first few, only
+		// wells narrower than the rectangle are passed over.
+		auto first = skyline.end();
+		uint32_t y = 0;
+
+		for (const auto& [segmentY, segmentX] : page.SkylineHeights)
+		{
+			if (segmentY + size.y > pageSize.y) return false;
+
+			auto begin = skyline.find(segmentX), end = std::next(begin);
+			uint32_t width = begin->second.Width;
+
+			while (width < size.x && end != skyline.end() && end->second.Y <= segmentY)
+				width += (end++)->second.Width;
+			while (width < size.x && begin != skyline.begin() && std::prev(begin)->second.Y <= segmentY)
+				width += (--begin)->second.Width;
+
+			if (width >= size.x)
+			{
+				first = begin;
+				y = segmentY;
+				break;
+			}
+		}
+
+		if (first == skyline.end()) return false;
+
+		region = { first->first, y, size.x, size.y };
+
+		auto erase = [&](std::map<uint32_t, SkylineSegment>::iterator it)
+		{
+			page.SkylineHeights.erase({ it->second.Y, it->first });
+			return skyline.erase(it);
+		};
+
+		auto insert = [&](uint32_t x, uint32_t segmentY, uint32_t width)
+		{
+			page.SkylineHeights.emplace(segmentY, x);
+			return skyline.emplace(x, SkylineSegment{ segmentY, width }).first;
+		};
+
+		// The new segment covers the ones it was placed over, a partly covered one shrinks
+		uint32_t end = region.X + size.x;
+		for (auto it = first; it != skyline.end() && it->first < end;)
+		{
+			SkylineSegment covered = it->second;
+			uint32_t coveredEnd = it->first + covered.Width;
+			it = erase(it);
+
+			if (coveredEnd > end)
+			{
+				insert(end, covered.Y, coveredEnd - end);
+				break;
+			}
+		}
+
+		auto segment = insert(region.X, y + size.y, size.x);
+
+		// Neighbours at the same height become one segment
+		if (auto next = std::next(segment); next != skyline.end() && next->second.Y == segment->second.Y)
+		{
+			segment->second.Width += next->second.Width;
+			erase(next);
+		}
+
+		if (segment != skyline.begin())
+		{
+			auto previous = std::prev(segment);
+			if (previous->second.Y == segment->second.Y)
+			{
+				previous->second.Width += segment->second.Width;
+				erase(segment);
+			}
+		}
+
+		return true;
+	}
+
+	void TextureAtlas::AddFreed(Page& page, const TextureRegion& region) const
+	{
+		page.Freed[region.Height].emplace(region.Width, region);
+		page.FreedArea += (uint64_t)region.Width * region.Height;
+
+		UpdateFreedWidth(page, region.Height);
+	}
+
+	void TextureAtlas::UpdateFreedWidth(Page& page, uint32_t height) const
+	{
+		auto it = page.Freed.find(height);
+		uint32_t width = it != page.Freed.end() ? it->second.rbegin()->first : 0;
+
+		// Leaves are the second half, every parent holds the wider of its children
+		size_t node = page.FreedWidths.size() / 2 + height;
+		page.FreedWidths[node] = width;
+
+		for (node /= 2; node > 0; node /= 2)
+			page.FreedWidths[node] = std::max(page.FreedWidths[node * 2], page.FreedWidths[node * 2 + 1]);
+	}
+
+	TextureRegion TextureAtlas::GetPaddedRegion(const Entry& entry) const
+	{
+		uint32_t padding = m_Specification.Padding;
+		return { entry.Region.Region.X - padding, entry.Region.Region.Y - padding, entry.PaddedSize.x, entry.PaddedSize.y };
+	}
+
+	void TextureAtlas::Place(Entry& entry, uint32_t page, const TextureRegion& padded)
+	{
+		uint32_t padding = m_Specification.Padding;
+		glm::vec2 pageSize = m_Specification.PageSize;
+
+		AtlasRegion& region = entry.Region;
+		region.Page = page;
+		region.Region = { padded.X + padding, padded.Y + padding, padded.Width - padding * 2, padded.Height - padding * 2 };
+		region.UVMin = glm::vec2(region.Region.X, region.Region.Y) / pageSize;
+		region.UVMax = glm::vec2(region.Region.X + region.Region.Width, region.Region.Y + region.Region.Height) / pageSize;
+
+		m_Pages[page].UsedArea += (uint64_t)padded.Width * padded.Height;
+	}
+
+	void TextureAtlas::Upload(const Entry& entry)
+	{
+		m_Pages[entry.Region.Page].Image->SetData(entry.Pixels.data(), (uint32_t)entry.Pixels.size(), GetPaddedRegion(entry));
+	}
+
+}
@@ -0,0 +1,154 @@
+#include "agipch.hpp"
+#include "UploadRing.hpp"
+
+namespace AGI {
+
+	// Buffer to image copies must start on a whole texel. 768 is the lcm of the 256 bytes
+	// drivers like for copies and every texel or block size (1, 2, 3, 4, 6, 8, 12 and 16 bytes),
+	// so an upload can be allocated before the texture it's for is known
+	static constexpr uint32_t s_UploadAlignment = 768;
+
+	TextureUpload UploadRing::Allocate(uint32_t size)
+	{
+		if (!m_Mapped || size == 0 || size > m_Size)
+			return {};
+
+		Retire();
+
+		uint32_t begin = 0;
+		while (!FindSpace(size, begin))
+		{
+			// Out of room, the oldest upload has to finish first
+			Region& oldest = m_Regions.front();
+			if (oldest.Fence == 0)
+				return {};
+
+			AGI_PROFILE_SCOPE("UploadRing::Wait");
+			Wait(oldest.Fence);
+			DestroyFence(oldest.Fence);
+			m_Regions.pop_front();
+		}
+
+		Region& region = m_Regions.emplace_back();
+		region.Begin = begin;
+		region.End = begin + size;
+		region.ID = m_NextID++;
+
+		TextureUpload upload;
+		upload.Data = m_Mapped + begin;
+		upload.Size = size;
+		upload.Offset = begin;
+		upload.ID = region.ID;
+		return upload;
+	}
+
+	void UploadRing::Submit(const TextureUpload& upload, uint64_t fence)
+	{
+		Region* region = FindRegion(upload.ID);
+		if (!region)
+		{
+			DestroyFence(fence);
+			return;
+		}
+
+		if (region->Fence) DestroyFence(region->Fence);
+		region->Fence = fence;
+	}
+
+	void UploadRing::Discard(const TextureUpload& upload)
+	{
+		// Submitted regions are still read by their copy and retire on their own
+		auto it = std::find_if(m_Regions.begin(), m_Regions.end(), [&](const Region& region) { return region.ID == upload.ID; });
+		if (it == m_Regions.end() || it->Fence != 0) return;
+
+		// A gap left in the middle is reused once the regions before it retire
+		m_Regions.erase(it);
+		Retire();
+	}
+
+	bool UploadRing::IsComplete(const TextureUpload& upload)
+	{
+		Retire();
+
+		// Retired regions aren't tracked anymore
+		Region* region = FindRegion(upload.ID);
+		if (!region) return upload.ID != 0 && upload.ID < m_NextID;
+
+		return region->Fence != 0 && IsSignalled(region->Fence);
+	}
+
+	void UploadRing::Retire()
+	{
+		// In order, so the free space stays a single span
+		while (!m_Regions.empty() && m_Regions.front().Fence != 0 && IsSignalled(m_Regions.front().Fence))
+		{
+			DestroyFence(m_Regions.front().Fence);
+			m_Regions.pop_front();
+		}
+	}
+
+	void UploadRing::Reset(uint8_t* mapped, uint32_t size)
+	{
+		Release();
+
+		m_Mapped = mapped;
+		m_Size = size;
+	}
+
+	void UploadRing::Release()
+	{
+		for (Region& region : m_Regions)
+		{
+			if (region.Fence)
+			{
+				Wait(region.Fence);
+				DestroyFence(region.Fence);
+			}
+		}
+
+		m_Regions.clear();
+		m_Mapped = nullptr;
+		m_Size = 0;
+	}
+
+	UploadRing::Region* UploadRing::FindRegion(uint64_t id)
+	{
+		// Usually one of the newest, search from the back
+		for (auto it = m_Regions.rbegin(); it != m_Regions.rend(); ++it)
+		{
+			if (it->ID == id) return &*it;
+		}
+
+		return nullptr;
+	}
+
+	bool UploadRing::FindSpace(uint32_t size, uint32_t& begin) const
+	{
+		if (m_Regions.empty())
+		{
+			begin = 0;
+			return size <= m_Size;
+		}
+
+		uint32_t tail = m_Regions.front().Begin;
+		uint32_t head = (m_Regions.back().End + s_UploadAlignment - 1) / s_UploadAlignment * s_UploadAlignment;
+
+		// Regions run from tail to head, possibly wrapping past the end of the buffer
+		bool wrapped = m_Regions.back().Begin < tail;
+		if (wrapped)
+		{
+			begin = head;
+			return head + size <= tail;
+		}
+
+		if (head + size <= m_Size)
+		{
+			begin = head;
+			return true;
+		}
+
+		begin = 0;
+		return size <= tail;
+	}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <deque>
+
+namespace AGI {
+
+	// Hands out regions of a persistently mapped staging buffer in a ring. Each
+	// region is reused once the fence the backend attached after its copy has
+	// signalled. Allocation and fencing happen on the render thread, the mapped
+	// memory itself can be written from anywhere until the copy is issued.
+	class UploadRing
+	{
+	public:
+		virtual ~UploadRing() = default;
+
+		TextureUpload Allocate(uint32_t size);
+
+		// Call after issuing the copy that reads from 'upload'
+		void Submit(const TextureUpload& upload, uint64_t fence);
+
+		// Frees an upload no copy will read from, one that was never submitted would block the ring
+		void Discard(const TextureUpload& upload);
+
+		bool IsComplete(const TextureUpload& upload);
+
+		// Reuses every region that finished, never waits
+		void Retire();
+	protected:
+		void Reset(uint8_t* mapped, uint32_t size);
+		void Release();
+
+		virtual bool IsSignalled(uint64_t fence) = 0;
+		virtual void Wait(uint64_t fence) = 0;
+		virtual void DestroyFence(uint64_t fence) = 0;
+	protected:
+		uint8_t* m_Mapped = nullptr;
+		uint32_t m_Size = 0;
+	private:
+		struct Region
+		{
+			uint32_t Begin = 0;
+			uint32_t End = 0;
+			uint64_t ID = 0;
+			uint64_t Fence = 0; // 0 while the region is still being filled
+		};
+
+		Region* FindRegion(uint64_t id);
+		bool FindSpace(uint32_t size, uint32_t& begin) const;
+	private:
+		std::deque<Region> m_Regions;
+		uint64_t m_NextID = 1;
+	};
+
+}
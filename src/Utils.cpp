@@ -4,6 +4,9 @@
 #include "OpenGL/OpenGLRenderContext.hpp"
 #include "Vulkan/VulkanRenderContext.hpp"
 
+#include <fstream>
+#include <bit>
+
 namespace AGI {
 
 	APIType BestAPI()
@@ -19,14 +22,44 @@ namespace AGI {
 
 		newapi->m_BoundWindow = window;
 		newapi->m_Settings = window->m_Settings;
+		newapi->m_StatsHistory.resize(std::max(newapi->m_Settings.FrameStatsHistory, 1u));
+		newapi->m_ResourceCache->SetEnabled(newapi->m_Settings.DeduplicateResources);
 		return newapi;
 	}
 
+	FrameStats RenderContext::GetFrameStats(uint32_t framesAgo) const
+	{
+		if (framesAgo >= m_StatsHistory.size() || framesAgo >= m_StatsFrame)
+			return FrameStats();
+
+		return m_StatsHistory[(m_StatsFrame - 1 - framesAgo) % m_StatsHistory.size()];
+	}
+
+	void RenderContext::SubmitFrameStats()
+	{
+		m_CurrentStats->Frame = m_StatsFrame;
+		m_StatsHistory[m_StatsFrame % m_StatsHistory.size()] = *m_CurrentStats;
+
+		*m_CurrentStats = FrameStats();
+		++m_StatsFrame;
+	}
+
 	RenderContext::~RenderContext()
 	{
 		delete m_BoundWindow;
 	}
 
+	ImageFormat RenderContext::ChooseFormat(std::initializer_list<ImageFormat> candidates) const
+	{
+		for (ImageFormat format : candidates)
+		{
+			if (IsFormatSupported(format))
+				return format;
+		}
+
+		return ImageFormat::RGBA;
+	}
+
 	namespace Utils {
 
 		ImageFormat ChannelsToImageFormat(uint16_t channels)
@@ -51,55 +84,296 @@ namespace AGI {
 			case ImageFormat::RG:   return 2;
 			case ImageFormat::RGB:  return 3;
 			case ImageFormat::RGBA: return 4;
+
+			// What the blocks decode to
+			case ImageFormat::BC4:       return 1;
+			case ImageFormat::BC5:       return 2;
+			case ImageFormat::BC1:
+			case ImageFormat::BC6H:
+			case ImageFormat::ETC2_RGB:  return 3;
+			case ImageFormat::BC2:
+			case ImageFormat::BC3:
+			case ImageFormat::BC7:
+			case ImageFormat::ETC2_RGBA:
+			case ImageFormat::ASTC_4x4:
+			case ImageFormat::ASTC_8x8:  return 4;
 			}
 
 			AGI_WARN("Unknown ImageFormat");
 			return 0;
 		}
 
+		bool IsCompressed(ImageFormat format)
+		{
+			return format >= ImageFormat::BC1;
+		}
+
+		glm::uvec2 GetBlockExtent(ImageFormat format)
+		{
+			if (format == ImageFormat::ASTC_8x8) return { 8, 8 };
+			return IsCompressed(format) ? glm::uvec2(4, 4) : glm::uvec2(1, 1);
+		}
+
+		uint32_t GetBlockSize(ImageFormat format)
+		{
+			switch (format)
+			{
+			case ImageFormat::BC1:
+			case ImageFormat::BC4:
+			case ImageFormat::ETC2_RGB:  return 8;
+			case ImageFormat::BC2:
+			case ImageFormat::BC3:
+			case ImageFormat::BC5:
+			case ImageFormat::BC6H:
+			case ImageFormat::BC7:
+			case ImageFormat::ETC2_RGBA:
+			case ImageFormat::ASTC_4x4:
+			case ImageFormat::ASTC_8x8:  return 16;
+			default: break;
+			}
+
+			AGI_VERIFY(false, "Block sizes only exist for compressed formats");
+			return 0;
+		}
+
+		uint32_t CalculateMipLevels(const glm::uvec2& size)
+		{
+			return std::bit_width(std::max({ size.x, size.y, 1u }));
+		}
+
+		glm::uvec2 GetMipSize(const glm::uvec2& size, uint32_t mip)
+		{
+			return glm::max(size >> mip, glm::uvec2(1));
+		}
+
+		uint32_t GetBytesPerPixel(const TextureSpecification& spec)
+		{
+			return ImageFormatToChannels(spec.Format) * (spec.BytesPerChannel / 8);
+		}
+
+		uint32_t GetLayerCount(const TextureSpecification& spec, uint32_t mip)
+		{
+			switch (spec.Type)
+			{
+			case TextureType::Texture2D:      return 1;
+			case TextureType::Texture2DArray: return spec.Layers;
+			case TextureType::Cube:           return 6;
+			case TextureType::CubeArray:      return spec.Layers * 6;
+			case TextureType::Texture3D:      return std::max(spec.Layers >> mip, 1u);
+			}
+
+			AGI_VERIFY(false, "Unknown TextureType");
+			return 1;
+		}
+
+		uint32_t CalculateMipLevels(const TextureSpecification& spec)
+		{
+			// 3D textures halve their depth too, the chain ends when every axis is 1
+			uint32_t levels = CalculateMipLevels(spec.Size);
+			if (spec.Type == TextureType::Texture3D) levels = std::max<uint32_t>(levels, std::bit_width(spec.Layers));
+
+			if (spec.MipLevels == FullMipChain) return levels;
+			return std::min(spec.MipLevels, levels);
+		}
+
+		uint32_t GetRegionDatasize(const TextureSpecification& spec, const TextureRegion& region, uint32_t rowPitch)
+		{
+			if (region.Width == 0 || region.Height == 0) return 0;
+
+			uint32_t rowSize = region.Width * GetBytesPerPixel(spec);
+			uint32_t rows = region.Height;
+
+			if (IsCompressed(spec.Format))
+			{
+				glm::uvec2 block = GetBlockExtent(spec.Format);
+				rowSize = (region.Width + block.x - 1) / block.x * GetBlockSize(spec.Format);
+				rows = (region.Height + block.y - 1) / block.y;
+			}
+
+			if (rowPitch == 0) rowPitch = rowSize;
+
+			// The last row doesn't need its padding
+			return rowPitch * (rows - 1) + rowSize;
+		}
+
+		uint32_t GetLevelDatasize(const TextureSpecification& spec, uint32_t mip)
+		{
+			glm::uvec2 size = GetMipSize(spec.Size, mip);
+			return GetRegionDatasize(spec, { 0, 0, size.x, size.y }) * GetLayerCount(spec, mip);
+		}
+
+		SamplerSpecification GetSamplerSpecification(const TextureSpecification& spec)
+		{
+			FilterMode filter = spec.LinearFiltering ? FilterMode::Linear : FilterMode::Nearest;
+
+			SamplerSpecification sampler;
+			sampler.MinFilter = filter;
+			sampler.MagFilter = filter;
+			sampler.Anisotropy = spec.Anisotropy;
+			sampler.WrapU = spec.Wrapping;
+			sampler.WrapV = spec.Wrapping;
+			sampler.WrapW = spec.Wrapping;
+
+			uint32_t mipLevels = CalculateMipLevels(spec);
+			if (mipLevels == 1) sampler.MipMode = MipmapMode::None;
+			else sampler.MipMode = spec.LinearFiltering ? MipmapMode::Linear : MipmapMode::Nearest;
+
+			// MaxLod stays open, the texture's level count already clamps it and
+			// textures with different mip counts can share the sampler
+			return sampler;
+		}
+
+		bool ValidateSpecification(const TextureSpecification& spec)
+		{
+			if (spec.Layers == 0 || (spec.Layers != 1 && (spec.Type == TextureType::Texture2D || spec.Type == TextureType::Cube)))
+			{
+				AGI_ERROR("{} layers don't fit the texture type, only arrays and 3D textures have more than 1", spec.Layers);
+				return false;
+			}
+
+			bool cube = spec.Type == TextureType::Cube || spec.Type == TextureType::CubeArray;
+			if (cube && spec.Size.x != spec.Size.y)
+			{
+				AGI_ERROR("Cube faces must be square, got {}x{}", spec.Size.x, spec.Size.y);
+				return false;
+			}
+
+			if (spec.Type == TextureType::Texture3D && IsCompressed(spec.Format))
+			{
+				AGI_ERROR("3D textures can't use block compressed formats");
+				return false;
+			}
+
+			return true;
+		}
+
+		bool ValidateRegion(const TextureSpecification& spec, uint32_t mipLevels, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t size, uint32_t rowPitch)
+		{
+			if (mip >= mipLevels)
+			{
+				AGI_ERROR("Texture has {} mip levels, can't set level {}", mipLevels, mip);
+				return false;
+			}
+
+			uint32_t layers = GetLayerCount(spec, mip);
+			if (layer >= layers)
+			{
+				AGI_ERROR("Mip level {} has {} layers, can't set layer {}", mip, layers, layer);
+				return false;
+			}
+
+			glm::uvec2 mipSize = GetMipSize(spec.Size, mip);
+			if (region.Width == 0 || region.Height == 0 || region.X + region.Width > mipSize.x || region.Y + region.Height > mipSize.y)
+			{
+				AGI_ERROR("Region ({}, {}, {}x{}) is outside mip level {} ({}x{})", region.X, region.Y, region.Width, region.Height, mip, mipSize.x, mipSize.y);
+				return false;
+			}
+
+			if (IsCompressed(spec.Format))
+			{
+				// Partial blocks are only allowed where the level itself ends
+				glm::uvec2 block = GetBlockExtent(spec.Format);
+				bool aligned = region.X % block.x == 0 && region.Y % block.y == 0 &&
+					(region.Width % block.x == 0 || region.X + region.Width == mipSize.x) &&
+					(region.Height % block.y == 0 || region.Y + region.Height == mipSize.y);
+
+				if (!aligned || (rowPitch != 0 && rowPitch != GetRegionDatasize(spec, { 0, 0, region.Width, 1 })))
+				{
+					AGI_ERROR("Compressed regions must cover whole {}x{} blocks and be tightly packed", block.x, block.y);
+					return false;
+				}
+			}
+			else
+			{
+				uint32_t bytesPerPixel = GetBytesPerPixel(spec);
+				if (rowPitch != 0 && (rowPitch < region.Width * bytesPerPixel || rowPitch % bytesPerPixel != 0))
+				{
+					AGI_ERROR("Row pitch {} must be at least one row and a multiple of {} bytes", rowPitch, bytesPerPixel);
+					return false;
+				}
+			}
+
+			uint32_t expected = GetRegionDatasize(spec, region, rowPitch);
+			if (size < expected)
+			{
+				AGI_ERROR("Region needs {} bytes, got {}", expected, size);
+				return false;
+			}
+
+			return true;
+		}
+
 		ShaderType StringToShaderType(const std::string& type)
 		{
 			if (type == "vertex")   return ShaderType::Vertex;
 			if (type == "fragment") return ShaderType::Fragment;
 			if (type == "pixel")    return ShaderType::Fragment;
 
-			AGI_VERIFY(false, "Unknown shader type '{}'", type);
+			// Callers decide how loud an unknown type is
 			return ShaderType::None;
 		}
 
-		ShaderSources ProcessSource(const std::string& source)
+		ShaderSources ProcessSource(std::string_view source)
 		{
 			ShaderSources shaderSources;
 
-			const std::string typeToken = "#type";
+			const std::string_view typeToken = "#type";
 			size_t typeTokenLength = typeToken.length();
 			size_t pos = 0;
 
-			while ((pos = source.find(typeToken, pos)) != std::string::npos)
+			while ((pos = source.find(typeToken, pos)) != std::string_view::npos)
 			{
 				size_t eol = source.find_first_of("\r\n", pos);
-				AGI_VERIFY(eol != std::string::npos, "Syntax error: Missing end of line after #type");
+				AGI_VERIFY(eol != std::string_view::npos, "Syntax error: Missing end of line after #type");
 
 				size_t typeStart = pos + typeTokenLength + 1;
-				std::string typeStr = source.substr(typeStart, eol - typeStart);
-				ShaderType shaderType = StringToShaderType(typeStr);
+				std::string typeName(source.substr(typeStart, eol - typeStart));
+				ShaderType shaderType = StringToShaderType(typeName);
+				AGI_VERIFY(shaderType != ShaderType::None, "Unknown shader type '{}'", typeName);
 
 				size_t codeStart = source.find_first_not_of("\r\n", eol);
-				AGI_VERIFY(codeStart != std::string::npos, "Syntax error: No shader code after #type");
+				AGI_VERIFY(codeStart != std::string_view::npos, "Syntax error: No shader code after #type");
 
+				// Views until here, the only copy is into the result
 				size_t nextTypePos = source.find(typeToken, codeStart);
+				std::string_view shaderCode = source.substr(codeStart, nextTypePos == std::string_view::npos ? std::string_view::npos : nextTypePos - codeStart);
 
-				std::string shaderCode = (nextTypePos == std::string::npos)
-					? source.substr(codeStart)
-					: source.substr(codeStart, nextTypePos - codeStart);
-
-				shaderSources[shaderType] = shaderCode;
+				shaderSources[shaderType].assign(shaderCode);
 				pos = nextTypePos;
 			}
 
 			return shaderSources;
 		}
 
+		std::vector<uint32_t> LoadSpirv(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file)
+			{
+				AGI_ERROR("Could not open SPIR-V module \"{}\"", path.string());
+				return {};
+			}
+
+			size_t size = file.tellg();
+			if (size % sizeof(uint32_t) != 0 || size < 5 * sizeof(uint32_t))
+			{
+				AGI_ERROR("\"{}\" is not a SPIR-V module", path.string());
+				return {};
+			}
+
+			std::vector<uint32_t> code(size / sizeof(uint32_t));
+			file.seekg(0);
+			file.read((char*)code.data(), size);
+
+			if (code[0] != 0x07230203)
+			{
+				AGI_ERROR("\"{}\" is not a SPIR-V module", path.string());
+				return {};
+			}
+
+			return code;
+		}
+
 	}
 
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "agipch.hpp"
+#include "VulkanBindlessTable.hpp"
+
+#include "VulkanRenderContext.hpp"
+
+namespace AGI {
+
+	bool VulkanBindlessTable::Create(VulkanContext* context, uint32_t size, uint32_t framesInFlight)
+	{
+		m_BoundContext = context;
+		m_FramesInFlight = framesInFlight;
+		VkDevice device = m_BoundContext->GetDevice().Logical;
+
+		VkPhysicalDeviceVulkan12Properties limits = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES };
+		VkPhysicalDeviceProperties2 properties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+		properties.pNext = &limits;
+		vkGetPhysicalDeviceProperties2(m_BoundContext->GetDevice().Physical, &properties);
+
+		m_Size = std::min({ size, limits.maxDescriptorSetUpdateAfterBindSampledImages, limits.maxPerStageDescriptorUpdateAfterBindSampledImages });
+		if (m_Size < size)
+			AGI_WARN("The device only fits {} bindless textures, {} were requested", m_Size, size);
+
+		VkDescriptorSetLayoutBinding binding = {};
+		binding.binding = 0;
+		binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		binding.descriptorCount = m_Size;
+		binding.stageFlags = VK_SHADER_STAGE_ALL;
+
+		// Slots change while frames that don't read them are still in flight
+		VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO };
+		flagsInfo.bindingCount = 1;
+		flagsInfo.pBindingFlags = &bindingFlags;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+		layoutInfo.pNext = &flagsInfo;
+		layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &binding;
+
+		VK_CHECK_RETURN(vkCreateDescriptorSetLayout, device, &layoutInfo, m_BoundContext->GetAllocator(), &m_Layout);
+
+		VkDescriptorPoolSize poolSize = { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_Size };
+
+		VkDescriptorPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolInfo.maxSets = 1;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+
+		if (vkCreateDescriptorPool(device, &poolInfo, m_BoundContext->GetAllocator(), &m_Pool) != VK_SUCCESS)
+		{
+			AGI_ERROR("Failed to create the bindless descriptor pool");
+			Destroy();
+			return false;
+		}
+
+		VkDescriptorSetAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+		allocateInfo.descriptorPool = m_Pool;
+		allocateInfo.descriptorSetCount = 1;
+		allocateInfo.pSetLayouts = &m_Layout;
+
+		if (vkAllocateDescriptorSets(device, &allocateInfo, &m_Set) != VK_SUCCESS)
+		{
+			AGI_ERROR("Failed to allocate the bindless descriptor set");
+			Destroy();
+			return false;
+		}
+
+		return true;
+	}
+
+	void VulkanBindlessTable::Destroy()
+	{
+		if (!m_BoundContext) return;
+
+		// The set is freed with its pool
+		VkDevice device = m_BoundContext->GetDevice().Logical;
+		if (m_Pool) vkDestroyDescriptorPool(device, m_Pool, m_BoundContext->GetAllocator());
+		if (m_Layout) vkDestroyDescriptorSetLayout(device, m_Layout, m_BoundContext->GetAllocator());
+
+		m_Pool = nullptr;
+		m_Layout = nullptr;
+		m_Set = nullptr;
+
+		m_NextSlot = 1;
+		m_FreeSlots.clear();
+		m_Retiring.clear();
+	}
+
+	uint32_t VulkanBindlessTable::Allocate(VkImageView view, VkSampler sampler)
+	{
+		if (!IsEnabled()) return 0;
+
+		uint32_t slot = 0;
+		if (!m_FreeSlots.empty())
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else if (m_NextSlot < m_Size)
+		{
+			slot = m_NextSlot++;
+		}
+		else
+		{
+			AGI_ERROR("All {} bindless texture slots are taken, raise Settings::BindlessTableSize", m_Size);
+			return 0;
+		}
+
+		VkDescriptorImageInfo imageInfo = {};
+		imageInfo.sampler = sampler;
+		imageInfo.imageView = view;
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+		write.dstSet = m_Set;
+		write.dstBinding = 0;
+		write.dstArrayElement = slot;
+		write.descriptorCount = 1;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.pImageInfo = &imageInfo;
+
+		vkUpdateDescriptorSets(m_BoundContext->GetDevice().Logical, 1, &write, 0, nullptr);
+		return slot;
+	}
+
+	void VulkanBindlessTable::Free(uint32_t slot)
+	{
+		if (!IsEnabled() || slot == 0) return;
+
+		m_Retiring.push_back({ slot, m_Frame });
+	}
+
+	void VulkanBindlessTable::BeginFrame()
+	{
+		++m_Frame;
+
+		// Frames recorded before the slot was freed may still index it
+		while (!m_Retiring.empty() && m_Retiring.front().Frame + m_FramesInFlight < m_Frame)
+		{
+			m_FreeSlots.push_back(m_Retiring.front().Slot);
+			m_Retiring.pop_front();
+		}
+	}
+
+};
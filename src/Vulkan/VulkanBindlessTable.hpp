@@ -0,0 +1,53 @@
+#pragma once
+#include "Vulkan.hpp"
+
+namespace AGI {
+
+	class VulkanContext;
+
+	// One update-after-bind descriptor set with a partially bound array of
+	// combined image samplers at binding 0, for every shader stage. Textures
+	// take a slot the first time they're asked for a bindless handle and give
+	// it back when destroyed. Freed slots are reused once every frame that
+	// could still index them has finished. Slot 0 is never handed out.
+	class VulkanBindlessTable
+	{
+	public:
+		VulkanBindlessTable() = default;
+
+		bool Create(VulkanContext* context, uint32_t size, uint32_t framesInFlight);
+		void Destroy();
+
+		// 0 when the table is full
+		uint32_t Allocate(VkImageView view, VkSampler sampler);
+		void Free(uint32_t slot);
+
+		// Must be called after the frame's fence was waited on
+		void BeginFrame();
+
+		bool IsEnabled() const { return m_Set != nullptr; }
+		VkDescriptorSetLayout GetLayout() const { return m_Layout; }
+		VkDescriptorSet GetSet() const { return m_Set; }
+	private:
+		struct RetiringSlot
+		{
+			uint32_t Slot;
+			uint64_t Frame;
+		};
+	private:
+		VulkanContext* m_BoundContext = nullptr;
+
+		VkDescriptorSetLayout m_Layout = nullptr;
+		VkDescriptorPool m_Pool = nullptr;
+		VkDescriptorSet m_Set = nullptr;
+
+		uint32_t m_Size = 0;
+		uint32_t m_NextSlot = 1;
+		std::vector<uint32_t> m_FreeSlots;
+
+		std::deque<RetiringSlot> m_Retiring;
+		uint32_t m_FramesInFlight = 1;
+		uint64_t m_Frame = 0;
+	};
+
+};
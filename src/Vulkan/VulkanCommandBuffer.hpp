@@ -27,6 +27,10 @@ namespace AGI {
         
         void UpdateSubmitted();
         void Reset();
+
+        // Blits each level from the one above it. Every level must be in TRANSFER_DST_OPTIMAL
+        // and all of them end up in SHADER_READ_ONLY_OPTIMAL.
+        void GenerateMips(VkImage image, const glm::uvec2& size, uint32_t mipLevels, uint32_t layers = 1, uint32_t depth = 1, VkFilter filter = VK_FILTER_LINEAR);
     private:
         VulkanContext* m_BoundContext = nullptr;
         VkCommandPool m_Parent = nullptr;
@@ -47,9 +47,52 @@ namespace AGI {
 			queue_create_infos.emplace_back(createinfo);
 		}
 
+		VkPhysicalDeviceFeatures supported_features;
+		vkGetPhysicalDeviceFeatures(m_Device.Physical, &supported_features);
+
+		// Compressed formats can't be sampled unless their feature is enabled
 		VkPhysicalDeviceFeatures device_features = {};
+		device_features.textureCompressionBC = supported_features.textureCompressionBC;
+		device_features.textureCompressionETC2 = supported_features.textureCompressionETC2;
+		device_features.textureCompressionASTC_LDR = supported_features.textureCompressionASTC_LDR;
+		device_features.samplerAnisotropy = supported_features.samplerAnisotropy;
+		m_Device.Features = device_features;
+
+		// Bindless textures index one big descriptor array that changes while frames are in flight
+		VkPhysicalDeviceVulkan12Features supported_indexing = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+		VkPhysicalDeviceFeatures2 supported_features2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+		supported_features2.pNext = &supported_indexing;
+
+		VkPhysicalDeviceProperties device_properties;
+		vkGetPhysicalDeviceProperties(m_Device.Physical, &device_properties);
+		if (device_properties.apiVersion >= VK_API_VERSION_1_2)
+			vkGetPhysicalDeviceFeatures2(m_Device.Physical, &supported_features2);
+
+		m_Device.DedicatedAllocation = device_properties.apiVersion >= VK_API_VERSION_1_1;
+
+		VkPhysicalDeviceVulkan12Features indexing_features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+		m_Device.DescriptorIndexing = m_Settings.BindlessTextures &&
+			supported_indexing.runtimeDescriptorArray &&
+			supported_indexing.shaderSampledImageArrayNonUniformIndexing &&
+			supported_indexing.descriptorBindingPartiallyBound &&
+			supported_indexing.descriptorBindingSampledImageUpdateAfterBind &&
+			supported_indexing.descriptorBindingUpdateUnusedWhilePending;
+
+		if (m_Device.DescriptorIndexing)
+		{
+			indexing_features.runtimeDescriptorArray = VK_TRUE;
+			indexing_features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+			indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		}
+		else if (m_Settings.BindlessTextures)
+		{
+			AGI_WARN("The device doesn't support descriptor indexing, textures have to be bound");
+		}
 
 		VkDeviceCreateInfo device_create_info = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+		device_create_info.pNext = m_Device.DescriptorIndexing ? &indexing_features : nullptr;
 		device_create_info.queueCreateInfoCount = queue_create_infos.size();
 		device_create_info.pQueueCreateInfos = queue_create_infos.data();
 		device_create_info.enabledExtensionCount = requirements.Extensions.size();
@@ -77,6 +120,37 @@ namespace AGI {
 		vkDestroyDevice(m_Device.Logical, m_Allocator);
 	}
 
+	uint32_t VulkanContext::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const
+	{
+		VkPhysicalDeviceMemoryProperties memory;
+		vkGetPhysicalDeviceMemoryProperties(m_Device.Physical, &memory);
+
+		for (uint32_t i = 0; i < memory.memoryTypeCount; ++i)
+		{
+			if ((typeBits & (1u << i)) && (memory.memoryTypes[i].propertyFlags & properties) == properties)
+				return i;
+		}
+
+		return UINT32_MAX;
+	}
+
+	bool VulkanContext::IsFormatSupported(ImageFormat format) const
+	{
+		if (format >= ImageFormat::BC1 && format <= ImageFormat::BC7 && !m_Device.Features.textureCompressionBC) return false;
+		if ((format == ImageFormat::ETC2_RGB || format == ImageFormat::ETC2_RGBA) && !m_Device.Features.textureCompressionETC2) return false;
+		if ((format == ImageFormat::ASTC_4x4 || format == ImageFormat::ASTC_8x8) && !m_Device.Features.textureCompressionASTC_LDR) return false;
+
+		// VulkanTexture widens it to RGBA when the device can't sample it
+		if (format == ImageFormat::RGB) return true;
+
+		TextureSpecification spec;
+		spec.Format = format;
+
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(m_Device.Physical, Utils::TextureFormatToVk(spec), &properties);
+		return properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+	}
+
 	bool VulkanContext::MatchPhysicalDevice(VkPhysicalDevice* chosen_device, DeviceRequirements& requirements)
 	{
 		auto physical_devices = EnumerateParent<VkPhysicalDevice>(vkEnumeratePhysicalDevices, m_Instance);
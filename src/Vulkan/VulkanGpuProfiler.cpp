@@ -0,0 +1,172 @@
+#include "agipch.hpp"
+#include "VulkanGpuProfiler.hpp"
+
+#include "VulkanRenderContext.hpp"
+
+namespace AGI {
+
+	bool VulkanGpuProfiler::Create(VulkanContext* context, uint32_t frames)
+	{
+		m_BoundContext = context;
+
+		if (m_BoundContext == nullptr)
+		{
+			AGI_ERROR("VulkanGpuProfiler cannot be created with no context attached");
+			return false;
+		}
+
+		const VulkanDevice& device = m_BoundContext->GetDevice();
+
+		auto queue_families = EnumerateParent<VkQueueFamilyProperties>(vkGetPhysicalDeviceQueueFamilyProperties, device.Physical);
+		uint32_t validBits = queue_families[device.QueueInfo.GraphicsIndex].timestampValidBits;
+		if (validBits == 0)
+		{
+			AGI_WARN("Graphics queue does not support timestamps, GPU profiling disabled");
+			return false;
+		}
+
+		m_TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+		VkPhysicalDeviceProperties props;
+		vkGetPhysicalDeviceProperties(device.Physical, &props);
+		m_TimestampPeriod = props.limits.timestampPeriod;
+
+		m_Frames.resize(frames);
+		for (auto& frame : m_Frames)
+		{
+			VkQueryPoolCreateInfo createInfo = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+			createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			createInfo.queryCount = s_MaxQueries;
+
+			VK_CHECK_RETURN(vkCreateQueryPool, device.Logical, &createInfo, m_BoundContext->GetAllocator(), &frame.Pool);
+		}
+
+		m_Results.resize(s_MaxQueries);
+		return true;
+	}
+
+	void VulkanGpuProfiler::Destroy()
+	{
+		for (auto& frame : m_Frames)
+		{
+			if (frame.Pool)
+				vkDestroyQueryPool(m_BoundContext->GetDevice().Logical, frame.Pool, m_BoundContext->GetAllocator());
+		}
+
+		m_Frames.clear();
+	}
+
+	bool VulkanGpuProfiler::BeginFrame(uint32_t frame, VulkanCommandBuffer& commands, GpuFrameTimings& timings)
+	{
+		m_CurrentFrame = frame;
+		m_CurrentCommands = &commands;
+		m_ZoneStack.clear();
+		m_DroppedZones = 0;
+
+		Frame& current = m_Frames[m_CurrentFrame];
+		bool collected = current.Submitted && Collect(current, timings);
+
+		current.Submitted = false;
+		current.UsedQueries = 0;
+		current.Zones.clear();
+		current.Index = m_FrameIndex;
+
+		vkCmdResetQueryPool(commands.GetHandle(), current.Pool, 0, s_MaxQueries);
+		return collected;
+	}
+
+	void VulkanGpuProfiler::EndFrame()
+	{
+		if (!m_ZoneStack.empty() || m_DroppedZones > 0)
+		{
+			AGI_WARN("{} GPU zone(s) still open at the end of the frame", m_ZoneStack.size() + m_DroppedZones);
+			while (!m_ZoneStack.empty() || m_DroppedZones > 0) EndZone();
+		}
+
+		Frame& current = m_Frames[m_CurrentFrame];
+		current.Submitted = !current.Zones.empty();
+
+		m_CurrentCommands = nullptr;
+		++m_FrameIndex;
+	}
+
+	void VulkanGpuProfiler::BeginZone(std::string_view name)
+	{
+		if (!IsEnabled() || !m_CurrentCommands) return;
+		Frame& frame = m_Frames[m_CurrentFrame];
+
+		// Out of queries, nothing opened after this point is recorded
+		if (frame.UsedQueries + 2 > s_MaxQueries)
+		{
+			m_DroppedZones++;
+			return;
+		}
+
+		PendingZone& zone = frame.Zones.emplace_back();
+		zone.Name = name;
+		zone.Depth = m_ZoneStack.size();
+		zone.Parent = m_ZoneStack.empty() ? -1 : m_ZoneStack.back();
+		zone.BeginQuery = frame.UsedQueries;
+		frame.UsedQueries += 2;
+
+		vkCmdWriteTimestamp(m_CurrentCommands->GetHandle(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.Pool, zone.BeginQuery);
+		m_ZoneStack.push_back(frame.Zones.size() - 1);
+	}
+
+	void VulkanGpuProfiler::EndZone()
+	{
+		if (!IsEnabled() || !m_CurrentCommands) return;
+		if (m_DroppedZones > 0)
+		{
+			m_DroppedZones--;
+			return;
+		}
+
+		if (m_ZoneStack.empty())
+		{
+			AGI_WARN("EndGpuZone() called without a matching BeginGpuZone()");
+			return;
+		}
+
+		int32_t index = m_ZoneStack.back();
+		m_ZoneStack.pop_back();
+
+		Frame& frame = m_Frames[m_CurrentFrame];
+		vkCmdWriteTimestamp(m_CurrentCommands->GetHandle(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.Pool, frame.Zones[index].BeginQuery + 1);
+	}
+
+	bool VulkanGpuProfiler::Collect(Frame& frame, GpuFrameTimings& timings)
+	{
+		// No WAIT_BIT, the fence for this frame has already signalled
+		VkResult result = vkGetQueryPoolResults(
+			m_BoundContext->GetDevice().Logical,
+			frame.Pool,
+			0, frame.UsedQueries,
+			frame.UsedQueries * sizeof(uint64_t), m_Results.data(),
+			sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT
+		);
+
+		if (result != VK_SUCCESS) return false;
+
+		timings.Frame = frame.Index;
+		timings.Zones.resize(frame.Zones.size());
+
+		for (size_t i = 0; i < frame.Zones.size(); ++i)
+		{
+			const PendingZone& pending = frame.Zones[i];
+			uint64_t begin = m_Results[pending.BeginQuery] & m_TimestampMask;
+			uint64_t end = m_Results[pending.BeginQuery + 1] & m_TimestampMask;
+
+			GpuZone& zone = timings.Zones[i];
+			zone.Name = pending.Name;
+			zone.Depth = pending.Depth;
+			zone.Parent = pending.Parent;
+			// Masked again so a counter that wrapped inside the zone still gives its length
+			zone.Duration = (uint64_t)((double)((end - begin) & m_TimestampMask) * m_TimestampPeriod);
+		}
+
+		return true;
+	}
+
+};
\ No newline at end of file
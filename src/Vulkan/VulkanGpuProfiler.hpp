@@ -0,0 +1,65 @@
+#pragma once
+#include "Vulkan.hpp"
+
+#include "VulkanCommandBuffer.hpp"
+
+namespace AGI {
+
+	class VulkanContext;
+
+	// Records nested GPU zones with timestamps into one VkQueryPool per frame
+	// in flight. Results are read back once that frame's fence has signalled.
+	class VulkanGpuProfiler
+	{
+	public:
+		VulkanGpuProfiler() = default;
+
+		bool Create(VulkanContext* context, uint32_t frames);
+		void Destroy();
+
+		// Must be called after the frame's fence was waited on and outside of a render pass
+		bool BeginFrame(uint32_t frame, VulkanCommandBuffer& commands, GpuFrameTimings& timings);
+		void EndFrame();
+
+		void BeginZone(std::string_view name);
+		void EndZone();
+
+		bool IsEnabled() const { return !m_Frames.empty(); }
+	private:
+		struct PendingZone
+		{
+			std::string Name;
+			uint32_t Depth;
+			int32_t Parent;
+			uint32_t BeginQuery;
+		};
+
+		struct Frame
+		{
+			VkQueryPool Pool = nullptr;
+			uint32_t UsedQueries = 0;
+
+			std::vector<PendingZone> Zones;
+			uint64_t Index = 0;
+			bool Submitted = false;
+		};
+
+		bool Collect(Frame& frame, GpuFrameTimings& timings);
+	private:
+		static constexpr uint32_t s_MaxQueries = 512;
+
+		VulkanContext* m_BoundContext = nullptr;
+		VulkanCommandBuffer* m_CurrentCommands = nullptr; // Set in BeginFrame()
+
+		std::vector<Frame> m_Frames;
+		std::vector<int32_t> m_ZoneStack;
+		uint32_t m_DroppedZones = 0; // Opened after the pool ran out, always the innermost ones
+		std::vector<uint64_t> m_Results;
+
+		uint32_t m_CurrentFrame = 0;
+		uint64_t m_FrameIndex = 0;
+		float m_TimestampPeriod = 1.0f;
+		uint64_t m_TimestampMask = ~0ull; // Bits above timestampValidBits are undefined
+	};
+
+};
\ No newline at end of file
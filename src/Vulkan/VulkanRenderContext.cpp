@@ -34,6 +34,12 @@ namespace AGI {
 
 	bool VulkanContext::Init()
 	{
+		if (m_Settings.Headless)
+		{
+			AGI_ERROR("Headless rendering is only supported by OpenGL");
+			return false;
+		}
+
 		VkApplicationInfo app_info = { VK_STRUCTURE_TYPE_APPLICATION_INFO };
 		app_info.apiVersion = VK_API_VERSION_1_2;
 		app_info.pApplicationName = m_BoundWindow->GetTitle().c_str();
@@ -165,6 +171,12 @@ namespace AGI {
 
 		m_ImagesInFlight.resize(m_Swapchain.Images.size());
 
+		if (m_Settings.GpuProfiling)
+			m_GpuProfiler.Create(this, m_Swapchain.FramesInFlight);
+
+		if (m_Device.DescriptorIndexing)
+			m_BindlessTable.Create(this, m_Settings.BindlessTableSize, m_Swapchain.FramesInFlight);
+
 		PrintProperties();
 		return true;
 	}
@@ -173,6 +185,10 @@ namespace AGI {
 	{
 		vkDeviceWaitIdle(m_Device.Logical);
 
+		m_UploadRing.Shutdown();
+		m_BindlessTable.Destroy();
+		RetireSubmits();
+
 		for (int i = 0; i < m_Swapchain.FramesInFlight; ++i)
 		{
 			vkDestroySemaphore(m_Device.Logical, m_ImageAvailableSemaphores[i], m_Allocator);
@@ -188,6 +204,7 @@ namespace AGI {
 			m_Swapchain.Framebuffers[i].Destroy();
 
 		m_MainRenderpass.Destroy();
+		m_GpuProfiler.Destroy();
 
 		DestroySwapchain();
 		DestroyDevice();
@@ -209,12 +226,279 @@ namespace AGI {
 		m_ClearColour = colour;
 	}
 
+	void VulkanContext::ReadPixels(uint32_t x, uint32_t y, uint32_t width, uint32_t height, void* data)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+
+		VkFormat format = m_Swapchain.ImageFormat.format;
+		bool bgra = format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB;
+		bool rgba = format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB;
+
+		if (!m_Swapchain.Readable || !(bgra || rgba))
+		{
+			AGI_ERROR("ReadPixels needs Settings::FrameReadback and a swapchain that can be copied from");
+			return;
+		}
+
+		if (!width || !height || (uint64_t)x + width > m_Swapchain.Extent.width || (uint64_t)y + height > m_Swapchain.Extent.height)
+		{
+			AGI_ERROR("ReadPixels region {}x{} at ({}, {}) is outside the {}x{} swapchain", width, height, x, y, m_Swapchain.Extent.width, m_Swapchain.Extent.height);
+			return;
+		}
+
+		// EndFrame() copied the image before presenting it, wait for that copy to land
+		vkQueueWaitIdle(m_Device.GraphicsQueue);
+
+		// Rows are top down because BeginFrame() flips the viewport, match OpenGL and return the bottom one first
+		uint32_t top = m_Swapchain.Extent.height - y - height;
+		size_t srcStride = (size_t)m_Swapchain.Extent.width * 4;
+		const uint8_t* src = (const uint8_t*)m_Readback.Mapped + (size_t)top * srcStride + (size_t)x * 4;
+		uint8_t* dst = (uint8_t*)data;
+		uint32_t stride = width * 4;
+
+		for (uint32_t row = 0; row < height; row++)
+		{
+			const uint8_t* srcRow = src + (size_t)(height - 1 - row) * srcStride;
+			uint8_t* dstRow = dst + (size_t)row * stride;
+
+			if (rgba)
+			{
+				memcpy(dstRow, srcRow, stride);
+				continue;
+			}
+
+			for (uint32_t i = 0; i < stride; i += 4)
+			{
+				dstRow[i + 0] = srcRow[i + 2];
+				dstRow[i + 1] = srcRow[i + 1];
+				dstRow[i + 2] = srcRow[i + 0];
+				dstRow[i + 3] = srcRow[i + 3];
+			}
+		}
+	}
+
+	void VulkanContext::CopyToReadback(VulkanCommandBuffer& commands)
+	{
+		// The image is still owned by the application here, presenting only starts after this submit
+		VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+		barrier.image = m_Swapchain.Images[m_ImageIndex];
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		barrier.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		// Frames in flight share the buffer, order this write after the previous frame's
+		VkBufferMemoryBarrier bufferBarrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+		bufferBarrier.buffer = m_Readback.Buffer;
+		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.size = VK_WHOLE_SIZE;
+		bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		bufferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(commands.GetHandle(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1, &bufferBarrier, 1, &barrier);
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageExtent = { m_Swapchain.Extent.width, m_Swapchain.Extent.height, 1 };
+
+		vkCmdCopyImageToBuffer(commands.GetHandle(), barrier.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_Readback.Buffer, 1, &region);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.dstAccessMask = 0;
+
+		bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+		vkCmdPipelineBarrier(commands.GetHandle(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &bufferBarrier, 1, &barrier);
+	}
+
+	Shader VulkanContext::CreateShader(const ShaderSources&)
+	{
+		AGI_ERROR("Vulkan can't compile GLSL, load precompiled SPIR-V with CreateShader(ShaderBinaries)");
+		return nullptr;
+	}
+
+	Shader VulkanContext::CreateShader(const ShaderBinaries& binaries, const SpecializationConstants& constants)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() -> ResourceBarrier<VulkanShader>
+		{
+			ResourceBarrier<VulkanShader> shader = ResourceBarrier<VulkanShader>::Create(this, binaries, constants);
+			return shader->IsReady() ? shader : nullptr;
+		};
+
+		if (!m_ResourceCache->IsEnabled()) return create();
+
+		uint64_t bytes = 0;
+		for (const auto& [type, code] : binaries)
+			bytes += code.size() * sizeof(uint32_t);
+
+		return m_ResourceCache->GetOrCreate<ShaderBase>(ResourceCache::Kind::Shader, ResourceCache::GetKey(binaries, constants), bytes, create);
+	}
+
+	Texture VulkanContext::CreateTexture(const TextureSpecification& spec)
+	{
+		// Comes back here with the encoded format and no Compression
+		if (spec.Compression != TextureCompression::None) return CreateCompressedTexture(spec);
+		if (!Utils::ValidateSpecification(spec)) return nullptr;
+
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() { return ResourceBarrier<VulkanTexture>::Create(this, spec); };
+
+		if (!m_ResourceCache->IsEnabled() || !spec.Data) return create();
+		return m_ResourceCache->GetOrCreate<TextureBase>(ResourceCache::Kind::Texture, ResourceCache::GetKey(spec), spec.Datasize, create);
+	}
+
+	Sampler VulkanContext::CreateSampler(const SamplerSpecification& spec)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+		auto create = [&]() { return ResourceBarrier<VulkanSampler>::Create(this, spec); };
+
+		auto matches = [&](const SamplerBase& sampler) { return sampler.GetSpecification() == spec; };
+
+		return m_ResourceCache->GetOrCreate<SamplerBase>(ResourceCache::Kind::Sampler, ResourceCache::GetKey(spec), 0, create, matches);
+	}
+
+	TextureUpload VulkanContext::AllocateUpload(uint32_t size)
+	{
+		FrameStatsTimer timer(*m_CurrentStats);
+
+		if (!m_UploadRing.IsInitialized() && !m_UploadRingFailed)
+			m_UploadRingFailed = !m_UploadRing.Init(this, m_Settings.UploadRingSize);
+
+		return m_UploadRing.Allocate(size);
+	}
+
+	bool VulkanContext::CreateHostBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VulkanHostBuffer& buffer)
+	{
+		VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+		bufferInfo.size = size;
+		bufferInfo.usage = usage;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VK_CHECK_RETURN(vkCreateBuffer, m_Device.Logical, &bufferInfo, m_Allocator, &buffer.Buffer);
+
+		VkMemoryRequirements requirements;
+		vkGetBufferMemoryRequirements(m_Device.Logical, buffer.Buffer, &requirements);
+
+		VkMemoryAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+		allocateInfo.allocationSize = requirements.size;
+		allocateInfo.memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+		if (allocateInfo.memoryTypeIndex == UINT32_MAX ||
+			vkAllocateMemory(m_Device.Logical, &allocateInfo, m_Allocator, &buffer.Memory) != VK_SUCCESS ||
+			vkBindBufferMemory(m_Device.Logical, buffer.Buffer, buffer.Memory, 0) != VK_SUCCESS ||
+			vkMapMemory(m_Device.Logical, buffer.Memory, 0, VK_WHOLE_SIZE, 0, &buffer.Mapped) != VK_SUCCESS)
+		{
+			DestroyHostBuffer(buffer);
+			return false;
+		}
+
+		return true;
+	}
+
+	void VulkanContext::DestroyHostBuffer(VulkanHostBuffer& buffer)
+	{
+		if (buffer.Mapped) vkUnmapMemory(m_Device.Logical, buffer.Memory);
+		if (buffer.Memory) vkFreeMemory(m_Device.Logical, buffer.Memory, m_Allocator);
+		if (buffer.Buffer) vkDestroyBuffer(m_Device.Logical, buffer.Buffer, m_Allocator);
+
+		buffer = {};
+	}
+
+	VulkanCommandBuffer VulkanContext::BeginSingleUse()
+	{
+		VulkanCommandBuffer commands;
+		commands.Allocate(this, m_Device.GraphicsPool, true);
+		commands.Begin(true, false, false);
+
+		return commands;
+	}
+
+	uint64_t VulkanContext::EndSingleUse(VulkanCommandBuffer& commands)
+	{
+		commands.End();
+
+		VkFenceCreateInfo fenceInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+		VkFence fence = nullptr;
+		VK_CHECK(vkCreateFence, m_Device.Logical, &fenceInfo, m_Allocator, &fence);
+
+		VkCommandBuffer handle = commands.GetHandle();
+
+		VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &handle;
+
+		VK_CHECK(vkQueueSubmit, m_Device.GraphicsQueue, 1, &submitInfo, fence);
+		commands.UpdateSubmitted();
+
+		m_PendingSubmits.push_back({ m_NextSubmit, fence, commands });
+		return m_NextSubmit++;
+	}
+
+	bool VulkanContext::IsSubmitComplete(uint64_t serial)
+	{
+		RetireSubmits();
+
+		for (const PendingSubmit& submit : m_PendingSubmits)
+		{
+			if (submit.Serial == serial)
+				return vkGetFenceStatus(m_Device.Logical, submit.Fence) == VK_SUCCESS;
+		}
+
+		return true;
+	}
+
+	void VulkanContext::WaitSubmit(uint64_t serial)
+	{
+		for (const PendingSubmit& submit : m_PendingSubmits)
+		{
+			if (submit.Serial == serial)
+			{
+				AGI_PROFILE_SCOPE("vkWaitForFences");
+				vkWaitForFences(m_Device.Logical, 1, &submit.Fence, true, UINT64_MAX);
+				break;
+			}
+		}
+	}
+
+	void VulkanContext::RetireSubmits()
+	{
+		// The queue finishes them in order, so only the front needs checking
+		while (!m_PendingSubmits.empty() && vkGetFenceStatus(m_Device.Logical, m_PendingSubmits.front().Fence) == VK_SUCCESS)
+		{
+			PendingSubmit& submit = m_PendingSubmits.front();
+			vkDestroyFence(m_Device.Logical, submit.Fence, m_Allocator);
+			submit.Commands.Free();
+
+			m_PendingSubmits.pop_front();
+		}
+	}
+
 	void VulkanContext::BeginFrame()
 	{
+		AGI_PROFILE_SCOPE("VulkanContext::BeginFrame");
+		SubmitFrameStats();
+		FrameStatsTimer timer(*m_CurrentStats);
+
+		RetireSubmits();
+		m_UploadRing.Retire();
+
 		// 1) Wait for the frame were about to use to be idle (GPU done with it)
-		vkWaitForFences(m_Device.Logical, 1, &m_InFlightFences[m_CurrentFrame], true, UINT64_MAX);
+		{
+			AGI_PROFILE_SCOPE("vkWaitForFences");
+			vkWaitForFences(m_Device.Logical, 1, &m_InFlightFences[m_CurrentFrame], true, UINT64_MAX);
+		}
 		vkResetFences(m_Device.Logical, 1, &m_InFlightFences[m_CurrentFrame]); // reset right after a successful wait
 
+		if (m_BindlessTable.IsEnabled())
+			m_BindlessTable.BeginFrame();
+
 		// 2) Acquire next swapchain image (signal the per-frame "imageAvailable")
 		AcquireNextImage(
 			UINT64_MAX,
@@ -235,6 +519,9 @@ namespace AGI {
 		commands.Reset();
 		commands.Begin(false, false, false);
 
+		if (m_GpuProfiler.IsEnabled())
+			m_GpuProfiler.BeginFrame(m_CurrentFrame, commands, m_GpuTimings);
+
 		VkViewport viewport{};
 		viewport.x = 0.0f;
 		viewport.y = (float)m_BoundWindow->GetSize().y;
@@ -255,9 +542,18 @@ namespace AGI {
 
 	void VulkanContext::EndFrame()
 	{
+		AGI_PROFILE_SCOPE("VulkanContext::EndFrame");
+		FrameStatsTimer timer(*m_CurrentStats);
+
+		if (m_GpuProfiler.IsEnabled())
+			m_GpuProfiler.EndFrame();
+
 		m_MainRenderpass.End();
 
 		VulkanCommandBuffer& commands = m_GraphicsCommands[m_ImageIndex];
+		if (m_Swapchain.Readable)
+			CopyToReadback(commands);
+
 		commands.End();
 
 		// 5) Submit once, waiting on "imageAvailable", signaling "renderFinished"
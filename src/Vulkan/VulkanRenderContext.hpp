@@ -6,6 +6,12 @@
 #include "VulkanRenderPass.hpp"
 #include "VulkanCommandBuffer.hpp"
 #include "VulkanFramebuffer.hpp"
+#include "VulkanGpuProfiler.hpp"
+#include "VulkanShader.hpp"
+#include "VulkanTexture.hpp"
+#include "VulkanSampler.hpp"
+#include "VulkanUploadRing.hpp"
+#include "VulkanBindlessTable.hpp"
 
 namespace AGI {
 
@@ -49,6 +55,11 @@ namespace AGI {
 		VkQueue TransferQueue;
 
 		VkCommandPool GraphicsPool;
+
+		// What CreateDevice() enabled
+		VkPhysicalDeviceFeatures Features = {};
+		bool DescriptorIndexing = false;
+		bool DedicatedAllocation = false; // Core in 1.1
 	};
 
 	struct VulkanSwapchain
@@ -60,6 +71,16 @@ namespace AGI {
 
 		uint8_t FramesInFlight = 3;
 		VkSurfaceFormatKHR ImageFormat;
+		VkExtent2D Extent = {};
+		bool Readable = false; // Every frame is copied to the readback buffer before presenting
+	};
+
+	// Host visible, coherent and mapped for its whole lifetime
+	struct VulkanHostBuffer
+	{
+		VkBuffer Buffer = nullptr;
+		VkDeviceMemory Memory = nullptr;
+		void* Mapped = nullptr;
 	};
 
 
@@ -75,17 +96,51 @@ namespace AGI {
 		virtual void DrawIndexed(const VertexArray& vertexArray, uint32_t indexCount = 0) override;
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 		virtual void SetClearColour(const glm::vec4& colour) override;
+		virtual void ReadPixels(uint32_t x, uint32_t y, uint32_t width, uint32_t height, void* data) override;
+
+		virtual void BeginGpuZone(std::string_view name) override { m_GpuProfiler.BeginZone(name); }
+		virtual void EndGpuZone() override                       { m_GpuProfiler.EndZone(); }
 
 		virtual VertexBuffer CreateVertexBuffer(uint32_t vertices, const BufferLayout& layout) override { return nullptr; }
+		virtual VertexBuffer CreateVertexBuffer(const void* vertices, uint32_t size, const BufferLayout& layout) override { return nullptr; }
 		virtual IndexBuffer CreateIndexBuffer(uint32_t* indices, uint32_t size) override { return nullptr; }
 		virtual Framebuffer CreateFramebuffer(const FramebufferSpecification& spec) override { return nullptr; }
-		virtual Shader CreateShader(const ShaderSources& shaderSources) override { return nullptr; }
-		virtual Texture CreateTexture(const TextureSpecification& spec) override { return nullptr; }
+		virtual Shader CreateShader(const ShaderSources& shaderSources) override;
+		virtual Shader CreateShaderAsync(const ShaderSources& shaderSources) override { return CreateShader(shaderSources); }
+		virtual Shader CreateShader(const ShaderBinaries& binaries, const SpecializationConstants& constants = {}) override;
+		virtual Texture CreateTexture(const TextureSpecification& spec) override;
+		using RenderContext::CreateTexture;
+		virtual Sampler CreateSampler(const SamplerSpecification& spec) override;
 		virtual VertexArray CreateVertexArray() override { return nullptr; }
 
+		virtual TextureUpload AllocateUpload(uint32_t size) override;
+		virtual bool IsUploadComplete(const TextureUpload& upload) override { return m_UploadRing.IsComplete(upload); }
+		virtual void DiscardUpload(const TextureUpload& upload) override { m_UploadRing.Discard(upload); }
+
+		virtual bool IsFormatSupported(ImageFormat format) const override;
+		virtual bool IsBindlessSupported() const override { return m_BindlessTable.IsEnabled(); }
+
 		const VulkanDevice& GetDevice() const { return m_Device; }
 		const VulkanSwapchain& GetSwapchain() const { return m_Swapchain; }
 		const VkAllocationCallbacks* GetAllocator() const { return m_Allocator; }
+		VulkanUploadRing& GetUploadRing() { return m_UploadRing; }
+
+		// Pipelines that sample bindless textures include its layout and bind its set
+		VulkanBindlessTable& GetBindlessTable() { return m_BindlessTable; }
+
+		// UINT32_MAX when no memory type has every property
+		uint32_t FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+
+		// For one-off copies, like uploads that don't fit the upload ring
+		bool CreateHostBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VulkanHostBuffer& buffer);
+		void DestroyHostBuffer(VulkanHostBuffer& buffer);
+
+		// One-shot command buffers on the graphics queue for work outside a frame.
+		// EndSingleUse() submits and returns a serial that can be polled or waited on.
+		VulkanCommandBuffer BeginSingleUse();
+		uint64_t EndSingleUse(VulkanCommandBuffer& commands);
+		bool IsSubmitComplete(uint64_t serial);
+		void WaitSubmit(uint64_t serial);
 
 	private:
 		bool MatchPhysicalDevice(VkPhysicalDevice* chosen_device, DeviceRequirements& requirements);
@@ -100,7 +155,20 @@ namespace AGI {
 
 		bool AcquireNextImage(uint64_t timeout, VkSemaphore signal_semaphore, VkFence fence, uint32_t* out_image);
 		bool PresentSwapchain(VkSemaphore wait_semaphore, uint32_t image);
+
+		// Frees the fences and command buffers of finished one-shot submits
+		void RetireSubmits();
+	private:
+		// Records the copy of the current image into m_Readback, after the main render pass
+		void CopyToReadback(VulkanCommandBuffer& commands);
 	private:
+		struct PendingSubmit
+		{
+			uint64_t Serial;
+			VkFence Fence;
+			VulkanCommandBuffer Commands;
+		};
+
 		VkDebugUtilsMessengerEXT m_Debugger;
 
 		VkInstance m_Instance;
@@ -110,7 +178,9 @@ namespace AGI {
 
 		VulkanDevice m_Device;
 		VulkanSwapchain m_Swapchain;
+		VulkanHostBuffer m_Readback; // Last presented frame, rows top down
 		VulkanRenderPass m_MainRenderpass;
+		VulkanGpuProfiler m_GpuProfiler;
 
 		// TODO: What are these for? :/
 		std::vector<VkSemaphore> m_ImageAvailableSemaphores;
@@ -122,6 +192,14 @@ namespace AGI {
 		std::vector<VulkanCommandBuffer> m_GraphicsCommands;
 		glm::vec4 m_ClearColour = { 1.0f, 1.0f, 1.0f, 1.0f };
 
+		VulkanUploadRing m_UploadRing;
+		bool m_UploadRingFailed = false;
+
+		VulkanBindlessTable m_BindlessTable;
+
+		std::deque<PendingSubmit> m_PendingSubmits;
+		uint64_t m_NextSubmit = 1;
+
 		uint32_t m_CurrentFrame = 0;
 		uint32_t m_ImageIndex = 0;
 	};
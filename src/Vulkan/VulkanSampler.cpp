@@ -0,0 +1,94 @@
+#include "agipch.hpp"
+#include "VulkanSampler.hpp"
+
+#include "VulkanRenderContext.hpp"
+
+namespace AGI {
+
+	namespace Utils {
+
+		static VkSamplerAddressMode GetAddressMode(WrappingType wrapping)
+		{
+			switch (wrapping)
+			{
+			case WrappingType::ClampBorder:  return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+			case WrappingType::ClampEdge:    return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			case WrappingType::Repeat:       return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+			case WrappingType::MirrorRepeat: return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+			}
+
+			AGI_VERIFY(false, "Unsupported WrappingType");
+			return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		}
+
+		static VkCompareOp GetCompareOp(CompareFunction compare)
+		{
+			switch (compare)
+			{
+			case CompareFunction::None:
+			case CompareFunction::Never:        return VK_COMPARE_OP_NEVER;
+			case CompareFunction::Less:         return VK_COMPARE_OP_LESS;
+			case CompareFunction::Equal:        return VK_COMPARE_OP_EQUAL;
+			case CompareFunction::LessEqual:    return VK_COMPARE_OP_LESS_OR_EQUAL;
+			case CompareFunction::Greater:      return VK_COMPARE_OP_GREATER;
+			case CompareFunction::NotEqual:     return VK_COMPARE_OP_NOT_EQUAL;
+			case CompareFunction::GreaterEqual: return VK_COMPARE_OP_GREATER_OR_EQUAL;
+			case CompareFunction::Always:       return VK_COMPARE_OP_ALWAYS;
+			}
+
+			AGI_VERIFY(false, "Unsupported CompareFunction");
+			return VK_COMPARE_OP_NEVER;
+		}
+
+		// Only three border colours exist without VK_EXT_custom_border_color
+		static VkBorderColor GetBorderColour(const glm::vec4& colour)
+		{
+			if (colour.a < 0.5f) return VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+
+			float brightness = (colour.r + colour.g + colour.b) / 3.0f;
+			return brightness < 0.5f ? VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK : VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+		}
+
+	}
+
+	VulkanSampler::VulkanSampler(VulkanContext* context, const SamplerSpecification& spec)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_Specification(spec)
+	{
+		m_Stats->ResourcesCreated++;
+
+		VkSamplerCreateInfo samplerInfo = { VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
+		samplerInfo.magFilter = spec.MagFilter == FilterMode::Linear ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+		samplerInfo.minFilter = spec.MinFilter == FilterMode::Linear ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = spec.MipMode == MipmapMode::Linear ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = Utils::GetAddressMode(spec.WrapU);
+		samplerInfo.addressModeV = Utils::GetAddressMode(spec.WrapV);
+		samplerInfo.addressModeW = Utils::GetAddressMode(spec.WrapW);
+		samplerInfo.mipLodBias = spec.LodBias;
+		samplerInfo.compareEnable = spec.Compare != CompareFunction::None;
+		samplerInfo.compareOp = Utils::GetCompareOp(spec.Compare);
+		samplerInfo.borderColor = Utils::GetBorderColour(spec.BorderColour);
+
+		// Vulkan has no mip mode that skips mips, clamping to level 0 does the same
+		samplerInfo.minLod = spec.MinLod;
+		samplerInfo.maxLod = spec.MipMode == MipmapMode::None ? spec.MinLod : spec.MaxLod;
+
+		if (spec.Anisotropy > 1.0f && m_BoundContext->GetDevice().Features.samplerAnisotropy)
+		{
+			VkPhysicalDeviceProperties properties;
+			vkGetPhysicalDeviceProperties(m_BoundContext->GetDevice().Physical, &properties);
+
+			samplerInfo.anisotropyEnable = VK_TRUE;
+			samplerInfo.maxAnisotropy = std::min(spec.Anisotropy, properties.limits.maxSamplerAnisotropy);
+		}
+
+		VK_CHECK(vkCreateSampler, m_BoundContext->GetDevice().Logical, &samplerInfo, m_BoundContext->GetAllocator(), &m_Sampler);
+	}
+
+	VulkanSampler::~VulkanSampler()
+	{
+		m_Stats->ResourcesDestroyed++;
+
+		if (m_Sampler) vkDestroySampler(m_BoundContext->GetDevice().Logical, m_Sampler, m_BoundContext->GetAllocator());
+	}
+
+};
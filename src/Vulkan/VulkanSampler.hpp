@@ -0,0 +1,30 @@
+#pragma once
+#include "Vulkan.hpp"
+
+namespace AGI {
+
+	class VulkanContext;
+
+	class VulkanSampler : public SamplerBase
+	{
+	public:
+		VulkanSampler(VulkanContext* context, const SamplerSpecification& spec);
+		virtual ~VulkanSampler();
+
+		virtual const SamplerSpecification& GetSpecification() const override { return m_Specification; }
+		virtual uint32_t GetRendererID() const override { return 0; } // Use GetSampler()
+
+		// Samplers are written into descriptor sets instead
+		virtual void Bind(uint32_t = 0) const override {}
+		virtual void Unbind(uint32_t = 0) const override {}
+
+		VkSampler GetSampler() const { return m_Sampler; }
+	private:
+		VulkanContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
+		SamplerSpecification m_Specification;
+		VkSampler m_Sampler = nullptr;
+	};
+
+};
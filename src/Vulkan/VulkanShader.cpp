@@ -0,0 +1,94 @@
+#include "agipch.hpp"
+#include "VulkanShader.hpp"
+
+#include "VulkanRenderContext.hpp"
+
+namespace AGI {
+
+	namespace Utils {
+
+		static VkShaderStageFlagBits ShaderTypeToVkStage(ShaderType type)
+		{
+			if (type == ShaderType::Vertex)   return VK_SHADER_STAGE_VERTEX_BIT;
+			if (type == ShaderType::Fragment) return VK_SHADER_STAGE_FRAGMENT_BIT;
+
+			AGI_VERIFY(false, "Unknown shader type '{}'", (int)type);
+			return VK_SHADER_STAGE_ALL;
+		}
+
+	}
+
+	VulkanShader::VulkanShader(VulkanContext* context, const ShaderBinaries& binaries, const SpecializationConstants& constants)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats())
+	{
+		AGI_PROFILE_SCOPE("VulkanShader::VulkanShader");
+		m_Stats->ResourcesCreated++;
+
+		for (const SpecializationConstant& constant : constants)
+		{
+			VkSpecializationMapEntry& entry = m_SpecializationEntries.emplace_back();
+			entry.constantID = constant.ID;
+			entry.offset = m_SpecializationData.size() * sizeof(uint32_t);
+			entry.size = sizeof(uint32_t);
+
+			m_SpecializationData.push_back(constant.Value);
+		}
+
+		m_SpecializationInfo.mapEntryCount = m_SpecializationEntries.size();
+		m_SpecializationInfo.pMapEntries = m_SpecializationEntries.data();
+		m_SpecializationInfo.dataSize = m_SpecializationData.size() * sizeof(uint32_t);
+		m_SpecializationInfo.pData = m_SpecializationData.data();
+
+		std::vector<std::span<const uint32_t>> modules;
+		for (const auto& [type, code] : binaries)
+		{
+			VkShaderModuleCreateInfo createInfo = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+			createInfo.codeSize = code.size() * sizeof(uint32_t);
+			createInfo.pCode = code.data();
+
+			VkShaderModule module = nullptr;
+			VK_CHECK(vkCreateShaderModule, m_BoundContext->GetDevice().Logical, &createInfo, m_BoundContext->GetAllocator(), &module);
+			if (!module)
+			{
+				// A pipeline missing a stage is no use to anyone
+				m_Ready = false;
+				return;
+			}
+
+			m_Modules.push_back(module);
+			modules.emplace_back(code);
+
+			VkPipelineShaderStageCreateInfo& stage = m_Stages.emplace_back();
+			stage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+			stage.stage = Utils::ShaderTypeToVkStage(type);
+			stage.module = module;
+			stage.pName = "main";
+			stage.pSpecializationInfo = constants.empty() ? nullptr : &m_SpecializationInfo;
+		}
+
+		m_Reflection = Utils::ReflectSpirv(modules);
+	}
+
+	VulkanShader::~VulkanShader()
+	{
+		m_Stats->ResourcesDestroyed++;
+
+		for (VkShaderModule module : m_Modules)
+			vkDestroyShaderModule(m_BoundContext->GetDevice().Logical, module, m_BoundContext->GetAllocator());
+	}
+
+	bool VulkanShader::Reload(const ShaderSources&)
+	{
+		AGI_WARN("Vulkan shaders can't be reloaded from GLSL yet");
+		return false;
+	}
+
+	void VulkanShader::WarnUniform()
+	{
+		if (m_WarnedUniform) return;
+
+		AGI_WARN("Vulkan shaders have no loose uniforms, use a uniform block instead");
+		m_WarnedUniform = true;
+	}
+
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include "Vulkan.hpp"
+
+namespace AGI {
+
+	class VulkanContext;
+
+	// Shader modules for each stage plus the specialization data, ready to be
+	// plugged into VkGraphicsPipelineCreateInfo through GetStages(). Vulkan has
+	// no loose uniforms, so the Set* functions only warn.
+	class VulkanShader : public ShaderBase
+	{
+	public:
+		VulkanShader(VulkanContext* context, const ShaderBinaries& binaries, const SpecializationConstants& constants);
+		virtual ~VulkanShader();
+
+		virtual void Bind() override {}
+		virtual void Unbind() override {}
+		virtual bool IsReady() override { return m_Ready; }
+
+		virtual bool Reload(const ShaderSources& sources) override;
+		virtual bool IsReloading() const override { return false; }
+
+		virtual const BufferLayout& GetLayout() const override { return m_Reflection.GetLayout(); }
+		virtual const ShaderReflection& GetReflection() const override { return m_Reflection; }
+		virtual bool AttributeExists(const std::string& name) const override { return m_Reflection.FindUniform(GetUniformID(name)) || m_Reflection.FindSampler(GetUniformID(name)); }
+
+		using ShaderBase::SetInt, ShaderBase::SetIntArray, ShaderBase::SetFloat, ShaderBase::SetFloat2;
+		using ShaderBase::SetFloat3, ShaderBase::SetFloat4, ShaderBase::SetMat3, ShaderBase::SetMat4;
+
+		virtual void SetInt(UniformID, int) override                   { WarnUniform(); }
+		virtual void SetIntArray(UniformID, int*, uint32_t) override   { WarnUniform(); }
+		virtual void SetFloat(UniformID, float) override               { WarnUniform(); }
+		virtual void SetFloat2(UniformID, const glm::vec2&) override   { WarnUniform(); }
+		virtual void SetFloat3(UniformID, const glm::vec3&) override   { WarnUniform(); }
+		virtual void SetFloat4(UniformID, const glm::vec4&) override   { WarnUniform(); }
+		virtual void SetMat3(UniformID, const glm::mat3&) override     { WarnUniform(); }
+		virtual void SetMat4(UniformID, const glm::mat4&) override     { WarnUniform(); }
+
+		const std::vector<VkPipelineShaderStageCreateInfo>& GetStages() const { return m_Stages; }
+	private:
+		void WarnUniform();
+	private:
+		VulkanContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
+		std::vector<VkShaderModule> m_Modules;
+		std::vector<VkPipelineShaderStageCreateInfo> m_Stages;
+
+		// Pointed to by every stage, so these must not move after construction
+		std::vector<VkSpecializationMapEntry> m_SpecializationEntries;
+		std::vector<uint32_t> m_SpecializationData;
+		VkSpecializationInfo m_SpecializationInfo = {};
+
+		ShaderReflection m_Reflection;
+		bool m_Ready = true; // False when a stage's module couldn't be created
+		bool m_WarnedUniform = false;
+	};
+
+};
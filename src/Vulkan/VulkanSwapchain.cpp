@@ -40,6 +40,21 @@ namespace AGI {
         createInfo.imageArrayLayers = 1;
         createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
+        m_Swapchain.Extent = extent;
+        m_Swapchain.Readable = false;
+        if (m_Settings.FrameReadback)
+        {
+            if (!(m_Device.SwapchainInfo.Capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+                AGI_WARN("Swapchain images can't be copied from, ReadPixels() is disabled");
+            else if (!CreateHostBuffer((VkDeviceSize)extent.width * extent.height * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT, m_Readback))
+                AGI_WARN("No memory for the readback buffer, ReadPixels() is disabled");
+            else
+            {
+                m_Swapchain.Readable = true;
+                createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            }
+        }
+
         uint32_t queueFamilyIndices[] = { m_Device.QueueInfo.GraphicsIndex, m_Device.QueueInfo.PresentIndex };
         createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
         createInfo.pQueueFamilyIndices = queueFamilyIndices;
@@ -86,10 +101,13 @@ namespace AGI {
             vkDestroyImageView(m_Device.Logical, m_Swapchain.ImageViews[i], m_Allocator);
 
         vkDestroySwapchainKHR(m_Device.Logical, m_Swapchain.Handle, m_Allocator);
+        DestroyHostBuffer(m_Readback);
 	}
 
     bool VulkanContext::AcquireNextImage(uint64_t timeout, VkSemaphore signal_semaphore, VkFence fence, uint32_t* out_image)
     {
+        AGI_PROFILE_SCOPE("VulkanContext::AcquireNextImage");
+
         VkResult result = vkAcquireNextImageKHR(m_Device.Logical, m_Swapchain.Handle, timeout, signal_semaphore, fence, out_image);
         if (result == VK_ERROR_OUT_OF_DATE_KHR)
         {
@@ -102,6 +120,8 @@ namespace AGI {
 
     bool VulkanContext::PresentSwapchain(VkSemaphore wait_semaphore, uint32_t image)
     {
+        AGI_PROFILE_SCOPE("VulkanContext::PresentSwapchain");
+
         VkPresentInfoKHR present_info = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
         present_info.waitSemaphoreCount = 1;
         present_info.pWaitSemaphores = &wait_semaphore;
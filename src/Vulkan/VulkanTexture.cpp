@@ -0,0 +1,448 @@
+#include "agipch.hpp"
+#include "VulkanTexture.hpp"
+
+#include "VulkanRenderContext.hpp"
+
+namespace AGI {
+
+	namespace Utils {
+
+		VkFormat TextureFormatToVk(const TextureSpecification& spec)
+		{
+			switch (spec.Format)
+			{
+			case ImageFormat::RED:
+				switch (spec.BytesPerChannel)
+				{
+				case 8:  return VK_FORMAT_R8_UNORM;
+				case 16: return VK_FORMAT_R16_SFLOAT;
+				case 32: return VK_FORMAT_R32_SFLOAT;
+				}
+				break;
+			case ImageFormat::RG:
+				switch (spec.BytesPerChannel)
+				{
+				case 8:  return VK_FORMAT_R8G8_UNORM;
+				case 16: return VK_FORMAT_R16G16_SFLOAT;
+				case 32: return VK_FORMAT_R32G32_SFLOAT;
+				}
+				break;
+			case ImageFormat::RGB:
+				switch (spec.BytesPerChannel)
+				{
+				case 8:  return spec.SRGB ? VK_FORMAT_R8G8B8_SRGB : VK_FORMAT_R8G8B8_UNORM;
+				case 16: return VK_FORMAT_R16G16B16_SFLOAT;
+				case 32: return VK_FORMAT_R32G32B32_SFLOAT;
+				}
+				break;
+			case ImageFormat::RGBA:
+				switch (spec.BytesPerChannel)
+				{
+				case 8:  return spec.SRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+				case 16: return VK_FORMAT_R16G16B16A16_SFLOAT;
+				case 32: return VK_FORMAT_R32G32B32A32_SFLOAT;
+				}
+				break;
+			case ImageFormat::BC1:       return spec.SRGB ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+			case ImageFormat::BC2:       return spec.SRGB ? VK_FORMAT_BC2_SRGB_BLOCK : VK_FORMAT_BC2_UNORM_BLOCK;
+			case ImageFormat::BC3:       return spec.SRGB ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+			case ImageFormat::BC4:       return VK_FORMAT_BC4_UNORM_BLOCK;
+			case ImageFormat::BC5:       return VK_FORMAT_BC5_UNORM_BLOCK;
+			case ImageFormat::BC6H:      return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+			case ImageFormat::BC7:       return spec.SRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+			case ImageFormat::ETC2_RGB:  return spec.SRGB ? VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+			case ImageFormat::ETC2_RGBA: return spec.SRGB ? VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+			case ImageFormat::ASTC_4x4:  return spec.SRGB ? VK_FORMAT_ASTC_4x4_SRGB_BLOCK : VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+			case ImageFormat::ASTC_8x8:  return spec.SRGB ? VK_FORMAT_ASTC_8x8_SRGB_BLOCK : VK_FORMAT_ASTC_8x8_UNORM_BLOCK;
+			}
+
+			AGI_VERIFY(false, "Unsupported Vulkan format");
+			return VK_FORMAT_UNDEFINED;
+		}
+
+		static VkImageViewType GetViewType(TextureType type)
+		{
+			switch (type)
+			{
+			case TextureType::Texture2D:      return VK_IMAGE_VIEW_TYPE_2D;
+			case TextureType::Texture2DArray: return VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+			case TextureType::Cube:           return VK_IMAGE_VIEW_TYPE_CUBE;
+			case TextureType::CubeArray:      return VK_IMAGE_VIEW_TYPE_CUBE_ARRAY;
+			case TextureType::Texture3D:      return VK_IMAGE_VIEW_TYPE_3D;
+			}
+
+			AGI_VERIFY(false, "Unsupported TextureType");
+			return VK_IMAGE_VIEW_TYPE_2D;
+		}
+
+		static bool CanSample(VkPhysicalDevice physical, VkFormat format)
+		{
+			VkFormatProperties properties;
+			vkGetPhysicalDeviceFormatProperties(physical, format, &properties);
+			return properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+		}
+
+		// 'rows' of RGB texels 'pitch' bytes apart, written tightly packed with an opaque alpha
+		static void ExpandToRGBA(uint8_t* destination, const uint8_t* source, uint32_t width, uint32_t rows, uint32_t pitch, uint32_t channelSize)
+		{
+			static constexpr uint8_t one8[] = { 0xFF };
+			static constexpr uint8_t one16[] = { 0x00, 0x3C }; // Half float 1.0
+			static constexpr uint8_t one32[] = { 0x00, 0x00, 0x80, 0x3F };
+			const uint8_t* one = channelSize == 1 ? one8 : channelSize == 2 ? one16 : one32;
+
+			uint32_t texel = channelSize * 3;
+			for (uint32_t y = 0; y < rows; ++y)
+			{
+				const uint8_t* row = source + (size_t)y * pitch;
+				for (uint32_t x = 0; x < width; ++x)
+				{
+					std::memcpy(destination, row + x * texel, texel);
+					std::memcpy(destination + texel, one, channelSize);
+					destination += texel + channelSize;
+				}
+			}
+		}
+
+	}
+
+	VulkanTexture::VulkanTexture(VulkanContext* context, TextureSpecification spec)
+		: m_BoundContext(context), m_Stats(context->GetSharedFrameStats()), m_Specification(spec)
+	{
+		AGI_PROFILE_SCOPE("VulkanTexture::VulkanTexture");
+		m_Stats->ResourcesCreated++;
+
+		VkDevice device = m_BoundContext->GetDevice().Logical;
+
+		m_MipLevels = Utils::CalculateMipLevels(m_Specification);
+
+		bool volume = m_Specification.Type == TextureType::Texture3D;
+		bool cube = m_Specification.Type == TextureType::Cube || m_Specification.Type == TextureType::CubeArray;
+		m_ArrayLayers = volume ? 1 : Utils::GetLayerCount(m_Specification);
+
+		VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+		imageInfo.flags = cube ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+		imageInfo.imageType = volume ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+		imageInfo.format = Utils::TextureFormatToVk(m_Specification);
+		if (m_Specification.Format == ImageFormat::RGB && !Utils::CanSample(m_BoundContext->GetDevice().Physical, imageInfo.format))
+		{
+			TextureSpecification expanded = m_Specification;
+			expanded.Format = ImageFormat::RGBA;
+			imageInfo.format = Utils::TextureFormatToVk(expanded);
+			m_Expand = true;
+		}
+		imageInfo.extent = { m_Specification.Size.x, m_Specification.Size.y, volume ? m_Specification.Layers : 1 };
+		imageInfo.mipLevels = m_MipLevels;
+		imageInfo.arrayLayers = m_ArrayLayers;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VK_CHECK(vkCreateImage, device, &imageInfo, m_BoundContext->GetAllocator(), &m_Image);
+		if (!m_Image) return;
+
+		VkMemoryDedicatedRequirements dedicated = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS };
+		VkMemoryRequirements2 requirements = { VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
+		requirements.pNext = &dedicated;
+
+		if (m_BoundContext->GetDevice().DedicatedAllocation)
+		{
+			VkImageMemoryRequirementsInfo2 requirementsInfo = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2 };
+			requirementsInfo.image = m_Image;
+			vkGetImageMemoryRequirements2(device, &requirementsInfo, &requirements);
+		}
+		else
+		{
+			vkGetImageMemoryRequirements(device, m_Image, &requirements.memoryRequirements);
+		}
+
+		VkMemoryAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+		allocateInfo.allocationSize = requirements.memoryRequirements.size;
+		allocateInfo.memoryTypeIndex = m_BoundContext->FindMemoryType(requirements.memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		// The image owns its memory either way, telling the driver lets it place large
+		// and render target images where they're fastest
+		VkMemoryDedicatedAllocateInfo dedicatedInfo = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO };
+		dedicatedInfo.image = m_Image;
+		if (dedicated.prefersDedicatedAllocation || dedicated.requiresDedicatedAllocation)
+			allocateInfo.pNext = &dedicatedInfo;
+
+		VK_CHECK(vkAllocateMemory, device, &allocateInfo, m_BoundContext->GetAllocator(), &m_Memory);
+		if (!m_Memory) return;
+
+		vkBindImageMemory(device, m_Image, m_Memory, 0);
+
+		VkImageViewCreateInfo viewInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+		viewInfo.image = m_Image;
+		viewInfo.viewType = Utils::GetViewType(m_Specification.Type);
+		viewInfo.format = imageInfo.format;
+		viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, m_ArrayLayers };
+
+		VK_CHECK(vkCreateImageView, device, &viewInfo, m_BoundContext->GetAllocator(), &m_ImageView);
+
+		if (spec.Datasize != 0) SetData(spec.Data, spec.Datasize);
+	}
+
+	VulkanTexture::~VulkanTexture()
+	{
+		m_Stats->ResourcesDestroyed++;
+
+		// Pending copies may still write to the image
+		m_BoundContext->WaitSubmit(m_LastSubmit);
+
+		if (m_BindlessSlot) m_BoundContext->GetBindlessTable().Free(m_BindlessSlot);
+
+		VkDevice device = m_BoundContext->GetDevice().Logical;
+		if (m_ImageView) vkDestroyImageView(device, m_ImageView, m_BoundContext->GetAllocator());
+		if (m_Image) vkDestroyImage(device, m_Image, m_BoundContext->GetAllocator());
+		if (m_Memory) vkFreeMemory(device, m_Memory, m_BoundContext->GetAllocator());
+	}
+
+	void VulkanTexture::SetData(void* data, uint32_t size)
+	{
+		AGI_PROFILE_SCOPE("VulkanTexture::SetData");
+		FrameStatsTimer timer(*m_Stats);
+
+		uint32_t expected = Utils::GetLevelDatasize(m_Specification, 0);
+		if (size != expected)
+		{
+			AGI_ERROR("Data must be entire texture, expected {} bytes but got {}", expected, size);
+			return;
+		}
+
+		TextureRegion region = { 0, 0, m_Specification.Size.x, m_Specification.Size.y };
+		Upload(data, region, 0, 0, Utils::GetLayerCount(m_Specification), 0, m_Specification.GenerateMips);
+	}
+
+	void VulkanTexture::SetData(const void* data, uint32_t size, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t rowPitch)
+	{
+		AGI_PROFILE_SCOPE("VulkanTexture::SetData");
+		FrameStatsTimer timer(*m_Stats);
+
+		if (!Utils::ValidateRegion(m_Specification, m_MipLevels, region, mip, layer, size, rowPitch))
+			return;
+
+		Upload(data, region, mip, layer, 1, rowPitch, mip == 0 && m_Specification.GenerateMips);
+	}
+
+	void VulkanTexture::SetData(const TextureUpload& upload)
+	{
+		AGI_PROFILE_SCOPE("VulkanTexture::SetData");
+		FrameStatsTimer timer(*m_Stats);
+
+		// Rejected uploads are given back, nothing else would free their region
+		VulkanUploadRing& ring = m_BoundContext->GetUploadRing();
+		if (!upload.Data || !m_Image)
+		{
+			AGI_ERROR("Texture upload has no staging memory");
+			ring.Discard(upload);
+			return;
+		}
+
+		uint32_t expected = Utils::GetLevelDatasize(m_Specification, 0);
+		if (upload.Size != expected)
+		{
+			AGI_ERROR("Texture upload needs {} bytes, got {}", expected, upload.Size);
+			ring.Discard(upload);
+			return;
+		}
+
+		TextureRegion region = { 0, 0, m_Specification.Size.x, m_Specification.Size.y };
+		if (m_Expand)
+		{
+			// The copy can't widen texels, restage it. Reading back the write-combined
+			// memory is slow, these textures are better uploaded synchronously
+			Upload(upload.Data, region, 0, 0, Utils::GetLayerCount(m_Specification), 0, m_Specification.GenerateMips);
+			ring.Discard(upload);
+			return;
+		}
+
+		m_Stats->BytesUploaded += upload.Size;
+		DetachFromCache();
+
+		CopyFromBuffer(ring.GetBuffer(), upload.Offset, region, 0, 0, Utils::GetLayerCount(m_Specification), 0, m_Specification.GenerateMips);
+		ring.Submit(upload, m_LastSubmit);
+	}
+
+	void VulkanTexture::SetMipData(uint32_t mip, void* data, uint32_t size)
+	{
+		AGI_PROFILE_SCOPE("VulkanTexture::SetMipData");
+		FrameStatsTimer timer(*m_Stats);
+
+		if (mip >= m_MipLevels)
+		{
+			AGI_ERROR("Texture has {} mip levels, can't set level {}", m_MipLevels, mip);
+			return;
+		}
+
+		uint32_t expected = Utils::GetLevelDatasize(m_Specification, mip);
+		if (size != expected)
+		{
+			AGI_ERROR("Mip level {} needs {} bytes, got {}", mip, expected, size);
+			return;
+		}
+
+		// Part of a prebuilt chain, so nothing is regenerated
+		glm::uvec2 mipSize = Utils::GetMipSize(m_Specification.Size, mip);
+		Upload(data, { 0, 0, mipSize.x, mipSize.y }, mip, 0, Utils::GetLayerCount(m_Specification, mip), 0, false);
+	}
+
+	void VulkanTexture::Upload(const void* data, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t layerCount, uint32_t rowPitch, bool generateMips)
+	{
+		if (!m_Image)
+		{
+			AGI_ERROR("Texture has no image to upload to");
+			return;
+		}
+
+		uint32_t size = Utils::GetRegionDatasize(m_Specification, region, rowPitch) * layerCount;
+
+		m_Stats->BytesUploaded += size;
+		DetachFromCache();
+
+		// Compressed regions are always tightly packed
+		uint32_t texelSize = Utils::GetBytesPerPixel(m_Specification);
+		uint32_t rowLength = Utils::IsCompressed(m_Specification.Format) ? 0 : rowPitch / texelSize;
+
+		// Several layers only come tightly packed, so their rows are all one pitch apart
+		uint32_t staged = size;
+		if (m_Expand)
+		{
+			staged = region.Width * region.Height * layerCount * (texelSize / 3 * 4);
+			rowLength = 0;
+		}
+
+		auto stage = [&](uint8_t* destination) {
+			if (m_Expand)
+				Utils::ExpandToRGBA(destination, (const uint8_t*)data, region.Width, region.Height * layerCount, rowPitch ? rowPitch : region.Width * texelSize, texelSize / 3);
+			else
+				std::memcpy(destination, data, size);
+		};
+
+		// Synchronous uploads are staged through the same ring when they fit
+		TextureUpload upload = m_BoundContext->AllocateUpload(staged);
+		if (upload.Data)
+		{
+			stage((uint8_t*)upload.Data);
+
+			VulkanUploadRing& ring = m_BoundContext->GetUploadRing();
+			CopyFromBuffer(ring.GetBuffer(), upload.Offset, region, mip, layer, layerCount, rowLength, generateMips);
+			ring.Submit(upload, m_LastSubmit);
+			return;
+		}
+
+		// Too big for the ring or it's full of uploads still being filled, use a buffer of its own
+		VulkanHostBuffer staging;
+		if (!m_BoundContext->CreateHostBuffer(staged, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, staging))
+		{
+			AGI_ERROR("No staging memory for a {} byte texture upload", staged);
+			return;
+		}
+
+		stage((uint8_t*)staging.Mapped);
+		CopyFromBuffer(staging.Buffer, 0, region, mip, layer, layerCount, rowLength, generateMips);
+
+		m_BoundContext->WaitSubmit(m_LastSubmit);
+		m_BoundContext->DestroyHostBuffer(staging);
+	}
+
+	void VulkanTexture::GenerateMips()
+	{
+		AGI_PROFILE_SCOPE("VulkanTexture::GenerateMips");
+		FrameStatsTimer timer(*m_Stats);
+
+		if (m_MipLevels == 1 || !m_Initialized) return;
+		if (Utils::IsCompressed(m_Specification.Format))
+		{
+			AGI_WARN("Compressed textures can't generate mips, upload every level with SetMipData()");
+			return;
+		}
+
+		DetachFromCache();
+
+		VulkanCommandBuffer commands = m_BoundContext->BeginSingleUse();
+
+		VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+		barrier.image = m_Image;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, m_ArrayLayers };
+		barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(commands.GetHandle(), VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		commands.GenerateMips(m_Image, m_Specification.Size, m_MipLevels, m_ArrayLayers, GetDepth());
+
+		m_LastSubmit = m_BoundContext->EndSingleUse(commands);
+	}
+
+	uint64_t VulkanTexture::GetBindlessHandle() const
+	{
+		VulkanBindlessTable& table = m_BoundContext->GetBindlessTable();
+		if (m_BindlessSlot || !table.IsEnabled() || !m_ImageView)
+			return m_BindlessSlot;
+
+		// Same state OpenGL keeps on the texture object
+		if (!m_Sampler)
+			m_Sampler = m_BoundContext->CreateSampler(Utils::GetSamplerSpecification(m_Specification));
+
+		VkSampler sampler = m_Sampler.As<VulkanSampler>()->GetSampler();
+		if (!sampler) return 0;
+
+		m_BindlessSlot = table.Allocate(m_ImageView, sampler);
+		return m_BindlessSlot;
+	}
+
+	void VulkanTexture::CopyFromBuffer(VkBuffer buffer, VkDeviceSize offset, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t layerCount, uint32_t rowLength, bool generateMips)
+	{
+		VulkanCommandBuffer commands = m_BoundContext->BeginSingleUse();
+		VkCommandBuffer handle = commands.GetHandle();
+
+		// The whole image moves between layouts together, the first upload discards the undefined contents
+		VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+		barrier.image = m_Image;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, m_MipLevels, 0, m_ArrayLayers };
+		barrier.oldLayout = m_Initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = m_Initialized ? VK_ACCESS_SHADER_READ_BIT : 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		VkPipelineStageFlags sourceStage = m_Initialized ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		vkCmdPipelineBarrier(handle, sourceStage, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkBufferImageCopy copy = {};
+		copy.bufferOffset = offset;
+		copy.bufferRowLength = rowLength;
+		// Layers of a 3D image are its depth slices
+		bool volume = m_Specification.Type == TextureType::Texture3D;
+		copy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip, volume ? 0 : layer, volume ? 1 : layerCount };
+		copy.imageOffset = { (int32_t)region.X, (int32_t)region.Y, volume ? (int32_t)layer : 0 };
+		copy.imageExtent = { region.Width, region.Height, volume ? layerCount : 1 };
+
+		vkCmdCopyBufferToImage(handle, buffer, m_Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+
+		// Blits can't write compressed images
+		if (generateMips && m_MipLevels > 1 && !Utils::IsCompressed(m_Specification.Format))
+		{
+			commands.GenerateMips(m_Image, m_Specification.Size, m_MipLevels, m_ArrayLayers, GetDepth());
+		}
+		else
+		{
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier(handle, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+
+		m_LastSubmit = m_BoundContext->EndSingleUse(commands);
+		m_Initialized = true;
+	}
+
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include "Vulkan.hpp"
+
+namespace AGI {
+
+	class VulkanContext;
+
+	namespace Utils {
+
+		VkFormat TextureFormatToVk(const TextureSpecification& spec);
+
+	}
+
+	// Optimally tiled, device local image. Every upload goes through the
+	// context's staging ring and a one-shot copy on the graphics queue, the
+	// image sits in SHADER_READ_ONLY_OPTIMAL between uploads.
+	class VulkanTexture : public TextureBase
+	{
+	public:
+		VulkanTexture(VulkanContext* context, TextureSpecification spec);
+		virtual ~VulkanTexture();
+
+		virtual const glm::uvec2& GetSize() const override { return m_Specification.Size; }
+		virtual const TextureSpecification& GetSpecification() const override { return m_Specification; }
+		virtual uint32_t GetRendererID() const override { return 0; } // Use GetImage()
+		virtual uint32_t GetMipLevels() const override { return m_MipLevels; }
+
+		virtual void SetData(void* data, uint32_t size) override;
+		virtual void SetData(const void* data, uint32_t size, const TextureRegion& region, uint32_t mip = 0, uint32_t layer = 0, uint32_t rowPitch = 0) override;
+		virtual void SetData(const TextureUpload& upload) override;
+		virtual void SetMipData(uint32_t mip, void* data, uint32_t size) override;
+		virtual void GenerateMips() override;
+		virtual void Bind(uint32_t slot = 0) const override {}
+		virtual uint64_t GetBindlessHandle() const override;
+
+		VkImage GetImage() const { return m_Image; }
+		VkImageView GetImageView() const { return m_ImageView; }
+	private:
+		uint32_t GetDepth() const { return m_Specification.Type == TextureType::Texture3D ? m_Specification.Layers : 1; }
+
+		void Upload(const void* data, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t layerCount, uint32_t rowPitch, bool generateMips);
+
+		// 'rowLength' is in pixels, 0 when rows are tightly packed. Several layers
+		// are only copied together from tightly packed data.
+		void CopyFromBuffer(VkBuffer buffer, VkDeviceSize offset, const TextureRegion& region, uint32_t mip, uint32_t layer, uint32_t layerCount, uint32_t rowLength, bool generateMips);
+	private:
+		VulkanContext* m_BoundContext;
+		std::shared_ptr<FrameStats> m_Stats; // Outlives the context
+
+		TextureSpecification m_Specification;
+		uint32_t m_MipLevels = 1;
+		uint32_t m_ArrayLayers = 1; // 3D textures have a single layer with depth
+
+		VkImage m_Image = nullptr;
+		VkImageView m_ImageView = nullptr;
+		VkDeviceMemory m_Memory = nullptr;
+
+		// Most devices can't sample 3 channel formats, those get an RGBA image
+		// and their data is widened while it's staged
+		bool m_Expand = false;
+
+		// Nothing to keep before the first upload, the image starts UNDEFINED
+		bool m_Initialized = false;
+		uint64_t m_LastSubmit = 0;
+
+		// Only textures in the bindless table need a sampler, shared with every
+		// texture sampled the same way
+		mutable Sampler m_Sampler;
+		mutable uint32_t m_BindlessSlot = 0;
+	};
+
+};
@@ -0,0 +1,78 @@
+#include "agipch.hpp"
+#include "VulkanUploadRing.hpp"
+
+#include "VulkanRenderContext.hpp"
+
+namespace AGI {
+
+	bool VulkanUploadRing::Init(VulkanContext* context, uint32_t size)
+	{
+		m_BoundContext = context;
+		VkDevice device = m_BoundContext->GetDevice().Logical;
+
+		VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+		bufferInfo.size = size;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VK_CHECK_RETURN(vkCreateBuffer, device, &bufferInfo, m_BoundContext->GetAllocator(), &m_Buffer);
+
+		VkMemoryRequirements requirements;
+		vkGetBufferMemoryRequirements(device, m_Buffer, &requirements);
+
+		// Coherent, so writes from other threads need no vkFlushMappedMemoryRanges()
+		uint32_t memoryType = m_BoundContext->FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		if (memoryType == UINT32_MAX)
+		{
+			AGI_ERROR("No host visible memory for texture uploads");
+			Shutdown();
+			return false;
+		}
+
+		VkMemoryAllocateInfo allocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+		allocateInfo.allocationSize = requirements.size;
+		allocateInfo.memoryTypeIndex = memoryType;
+
+		void* mapped = nullptr;
+		if (vkAllocateMemory(device, &allocateInfo, m_BoundContext->GetAllocator(), &m_Memory) != VK_SUCCESS ||
+			vkBindBufferMemory(device, m_Buffer, m_Memory, 0) != VK_SUCCESS ||
+			vkMapMemory(device, m_Memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS)
+		{
+			AGI_ERROR("Failed to map {} bytes of texture upload memory", size);
+			Shutdown();
+			return false;
+		}
+
+		Reset((uint8_t*)mapped, size);
+		return true;
+	}
+
+	void VulkanUploadRing::Shutdown()
+	{
+		if (!m_BoundContext) return;
+
+		bool mapped = m_Mapped != nullptr;
+		Release();
+
+		VkDevice device = m_BoundContext->GetDevice().Logical;
+		if (mapped) vkUnmapMemory(device, m_Memory);
+		if (m_Memory) vkFreeMemory(device, m_Memory, m_BoundContext->GetAllocator());
+
+		if (m_Buffer) vkDestroyBuffer(device, m_Buffer, m_BoundContext->GetAllocator());
+
+		m_Memory = nullptr;
+		m_Buffer = nullptr;
+		m_BoundContext = nullptr;
+	}
+
+	bool VulkanUploadRing::IsSignalled(uint64_t fence)
+	{
+		return m_BoundContext->IsSubmitComplete(fence);
+	}
+
+	void VulkanUploadRing::Wait(uint64_t fence)
+	{
+		m_BoundContext->WaitSubmit(fence);
+	}
+
+};
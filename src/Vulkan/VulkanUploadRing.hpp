@@ -0,0 +1,34 @@
+#pragma once
+#include "Vulkan.hpp"
+
+#include "UploadRing.hpp"
+
+namespace AGI {
+
+	class VulkanContext;
+
+	// Host visible, coherent staging buffer mapped for its whole lifetime.
+	// Copies out of it are recorded with vkCmdCopyBufferToImage() and the
+	// fences are the serials of VulkanContext::EndSingleUse().
+	class VulkanUploadRing : public UploadRing
+	{
+	public:
+		virtual ~VulkanUploadRing() { Shutdown(); }
+
+		bool Init(VulkanContext* context, uint32_t size);
+		void Shutdown();
+
+		bool IsInitialized() const { return m_Buffer != nullptr; }
+		VkBuffer GetBuffer() const { return m_Buffer; }
+	protected:
+		virtual bool IsSignalled(uint64_t fence) override;
+		virtual void Wait(uint64_t fence) override;
+		virtual void DestroyFence(uint64_t fence) override {} // Owned by the context
+	private:
+		VulkanContext* m_BoundContext = nullptr;
+
+		VkBuffer m_Buffer = nullptr;
+		VkDeviceMemory m_Memory = nullptr;
+	};
+
+};
@@ -15,6 +15,7 @@ namespace AGI {
 		: m_Settings(settings), m_Properties(props)
 	{
 		Log::Init(m_Settings.MessageFunc);
+		if (m_Settings.Headless) return;
 
 		if (s_WindowCount == 0)
 		{
@@ -29,6 +30,12 @@ namespace AGI {
 
 	void Window::Init()
 	{
+		if (m_Settings.Headless)
+		{
+			AGI_INFO("Creating headless surface \"{}\" ({}, {})", m_Properties.Title, m_Properties.Size.x, m_Properties.Size.y);
+			return;
+		}
+
 		glfwWindowHint(GLFW_RESIZABLE, m_Properties.Resizable);
 		glfwWindowHint(GLFW_VISIBLE, m_Properties.Visible);
 		glfwWindowHint(GLFW_DECORATED, !m_Properties.Borderless);
@@ -66,6 +73,8 @@ namespace AGI {
 
 	void Window::Shutdown()
 	{
+		if (m_Settings.Headless) return;
+
 		glfwDestroyWindow(m_Window);
 		--s_WindowCount;
 
@@ -75,17 +84,28 @@ namespace AGI {
 
 	void Window::PollEvents()
 	{
+		AGI_PROFILE_SCOPE("Window::PollEvents");
+		if (m_Settings.Headless) return;
+
 		glfwPollEvents();
 	}
 
 	bool Window::ShouldClose(bool closing)
 	{
+		if (m_Settings.Headless)
+		{
+			m_ShouldClose |= closing;
+			return m_ShouldClose;
+		}
+
 		if (closing) glfwSetWindowShouldClose(m_Window, 1);
 		return glfwWindowShouldClose(m_Window);
 	}
 
 	glm::vec2 Window::GetPosition() const
 	{
+		if (!m_Window) return glm::vec2(0, 0);
+
 		int x, y;
 		glfwGetWindowPos(m_Window, &x, &y);
 
@@ -94,6 +114,8 @@ namespace AGI {
 
 	void Window::SetVisable(bool enabled)
 	{
+		if (!m_Window) return;
+
 		if (enabled)
 		{
 			glfwShowWindow(m_Window);
@@ -106,13 +128,14 @@ namespace AGI {
 
 	void Window::SetTitle(const std::string& title)
 	{
-		glfwSetWindowTitle(m_Window, title.c_str());
+		if (m_Window) glfwSetWindowTitle(m_Window, title.c_str());
 		m_Properties.Title = title;
 	}
 	
 	float Window::GetDelta()
 	{
-		float time = glfwGetTime();
+		static const auto s_StartTime = std::chrono::steady_clock::now();
+		float time = m_Settings.Headless ? std::chrono::duration<float>(std::chrono::steady_clock::now() - s_StartTime).count() : glfwGetTime();
 		float timestep = time - m_LastFrameTime;
 		m_LastFrameTime = time;
 		
@@ -121,6 +144,8 @@ namespace AGI {
 
     void Window::InstallCallbacks()
     {
+		if (!m_Window) return;
+
 		// Just try debugging this :)
 		glfwSetWindowPosCallback(m_Window,          [](GLFWwindow* window, int xpos, int ypos)                          { Window* agiwindow = (Window*)glfwGetWindowUserPointer(window); if (agiwindow->m_Events.WindowPosCallback)         { agiwindow->m_Events.WindowPosCallback(agiwindow, { xpos, ypos });         } });
 		glfwSetWindowSizeCallback(m_Window,         [](GLFWwindow* window, int width, int height)                       { Window* agiwindow = (Window*)glfwGetWindowUserPointer(window); if (agiwindow->m_Events.WindowSizeCallback)        { agiwindow->m_Events.WindowSizeCallback(agiwindow, { width, height }); } agiwindow->m_Properties.Size = { width, height }; });
@@ -0,0 +1,277 @@
+// Build-time shader compiler used by agi_add_shaders(). Runs every file through
+// AGI::ShaderPreprocessor like the runtime does, so '#type' sections and
+// '#include's work the same, compiles every stage to SPIR-V with
+// glslangValidator and writes all of them into a single shader pack.
+//
+// agi_shaderc --glslang <exe> --target opengl|vulkan --temp <dir> --output <pack>
+//             [--embed <symbol> <source.cpp> <header.hpp>] [--depfile <file>] <shader files...>
+
+#include "AGI/ShaderPackFormat.hpp"
+#include "AGI/agi.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace AGI;
+
+struct CompiledStage
+{
+	std::string Name;
+	ShaderPackFormat::Stage Stage;
+	std::vector<uint32_t> Code;
+};
+
+static bool ReadFile(const fs::path& path, std::string& contents)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	std::stringstream stream;
+	stream << file.rdbuf();
+	contents = stream.str();
+	return true;
+}
+
+static bool CompileStage(const std::string& glslang, const std::string& target, const fs::path& temp, const fs::path& source,
+	ShaderPackFormat::Stage stage, const std::string& code, CompiledStage& result)
+{
+	const char* extension = stage == ShaderPackFormat::Stage::Vertex ? ".vert" : ".frag";
+	fs::path input = temp / (source.stem().string() + extension);
+	fs::path output = temp / (source.stem().string() + extension + ".spv");
+
+	std::ofstream(input, std::ios::binary) << code;
+
+	// Plain GLSL leaves locations and bindings to the linker, SPIR-V needs them spelled out
+	std::string command = "\"" + glslang + "\" " + (target == "vulkan" ? "-V --target-env vulkan1.2" : "-G --target-env opengl")
+		+ " --auto-map-locations --auto-map-bindings -o \"" + output.string() + "\" \"" + input.string() + "\"";
+
+	if (std::system(command.c_str()) != 0)
+	{
+		std::cerr << source.string() << ": error: " << (extension + 1) << " stage failed to compile, see the errors above\n";
+		return false;
+	}
+
+	std::string binary;
+	if (!ReadFile(output, binary) || binary.size() % sizeof(uint32_t) != 0)
+	{
+		std::cerr << output.string() << ": error: glslang produced no valid SPIR-V\n";
+		return false;
+	}
+
+	result.Stage = stage;
+	result.Code.resize(binary.size() / sizeof(uint32_t));
+	std::memcpy(result.Code.data(), binary.data(), binary.size());
+	return true;
+}
+
+static bool CompileFile(const std::string& glslang, const std::string& target, const fs::path& temp, const fs::path& path,
+	std::vector<CompiledStage>& stages, std::vector<fs::path>& dependencies)
+{
+	// Includes resolve relative to the including file, then to the shader's directory
+	ShaderPreprocessor preprocessor(ShaderPreprocessor::FilesystemProvider(path.parent_path()));
+
+	std::vector<std::string> files;
+	ShaderSources sources = preprocessor.ProcessFile(path.filename().string(), {}, &files);
+	if (sources.empty())
+	{
+		std::cerr << path.string() << ": error: no '#type' sections, or preprocessing failed (see above)\n";
+		return false;
+	}
+
+	for (const std::string& file : files)
+		dependencies.push_back(path.parent_path() / file);
+
+	std::string name = path.stem().string();
+	bool success = true;
+
+	const std::pair<ShaderType, ShaderPackFormat::Stage> order[] = {
+		{ ShaderType::Vertex, ShaderPackFormat::Stage::Vertex }, { ShaderType::Fragment, ShaderPackFormat::Stage::Fragment }
+	};
+
+	for (const auto& [type, stage] : order)
+	{
+		auto it = sources.find(type);
+		if (it == sources.end()) continue;
+
+		CompiledStage& compiled = stages.emplace_back();
+		compiled.Name = name;
+
+		// Keep going so every broken stage gets reported in one build
+		if (!CompileStage(glslang, target, temp, path, stage, it->second, compiled))
+		{
+			// glslang reports '<source>:<line>', the preprocessor's #line directives number the files from 1
+			for (uint32_t index = 1; index <= files.size(); ++index)
+				std::cerr << "  source " << index << ": " << preprocessor.GetSourceName(index) << "\n";
+
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+static void WriteDepfile(const fs::path& depfile, const fs::path& output, const std::vector<fs::path>& dependencies)
+{
+	auto escape = [](std::string path)
+	{
+		std::string result;
+		for (char c : path)
+		{
+			if (c == ' ' || c == '#') result += '\\';
+			if (c == '$') result += '$';
+			result += c;
+		}
+
+		return result;
+	};
+
+	std::ofstream file(depfile);
+	file << escape(output.generic_string()) << ":";
+	for (const fs::path& dependency : dependencies)
+		file << " \\\n  " << escape(dependency.lexically_normal().generic_string());
+
+	file << "\n";
+}
+
+static void WritePack(const fs::path& path, const std::vector<CompiledStage>& stages, ShaderPackFormat::Target target, std::vector<uint32_t>& words)
+{
+	ShaderPackFormat::Header header;
+	header.API = target;
+	header.EntryCount = stages.size();
+
+	std::string names;
+	std::vector<ShaderPackFormat::Entry> entries;
+	uint32_t codeOffset = 0;
+
+	for (const CompiledStage& stage : stages)
+	{
+		ShaderPackFormat::Entry& entry = entries.emplace_back();
+		entry.NameOffset = names.size();
+		entry.NameLength = stage.Name.size();
+		entry.Type = stage.Stage;
+		entry.CodeOffset = codeOffset;
+		entry.CodeWords = stage.Code.size();
+
+		names += stage.Name;
+		codeOffset += stage.Code.size();
+	}
+
+	names.resize((names.size() + 3) / 4 * 4, '\0');
+	header.NameWords = names.size() / 4;
+
+	auto append = [&words](const void* data, size_t bytes)
+	{
+		size_t offset = words.size();
+		words.resize(offset + bytes / sizeof(uint32_t));
+		std::memcpy(words.data() + offset, data, bytes);
+	};
+
+	append(&header, sizeof(header));
+	append(entries.data(), entries.size() * sizeof(ShaderPackFormat::Entry));
+	append(names.data(), names.size());
+	for (const CompiledStage& stage : stages)
+		append(stage.Code.data(), stage.Code.size() * sizeof(uint32_t));
+
+	std::ofstream(path, std::ios::binary).write((const char*)words.data(), words.size() * sizeof(uint32_t));
+}
+
+static void WriteEmbed(const std::string& symbol, const fs::path& source, const fs::path& header, const std::vector<uint32_t>& words)
+{
+	std::ofstream hpp(header);
+	hpp << "#pragma once\n\n#include <cstdint>\n#include <span>\n\n";
+	hpp << "// Generated by agi_shaderc, load with AGI::ShaderPack(" << symbol << ")\n";
+	hpp << "extern const std::span<const uint32_t> " << symbol << ";\n";
+
+	std::ofstream cpp(source);
+	cpp << "#include \"" << header.filename().string() << "\"\n\n";
+	cpp << "static const uint32_t s_Data[" << words.size() << "] = {";
+	for (size_t i = 0; i < words.size(); ++i)
+		cpp << (i % 8 == 0 ? "\n\t" : " ") << "0x" << std::hex << words[i] << ",";
+
+	cpp << std::dec << "\n};\n\n";
+	cpp << "extern const std::span<const uint32_t> " << symbol << "(s_Data, " << words.size() << ");\n";
+}
+
+int main(int argc, char** argv)
+{
+	std::string glslang = "glslangValidator", target = "opengl";
+	std::string symbol;
+	fs::path temp = fs::temp_directory_path(), output, embedSource, embedHeader, depfile;
+	std::vector<fs::path> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--glslang" && hasValue)     glslang = argv[++i];
+		else if (arg == "--target" && hasValue) target = argv[++i];
+		else if (arg == "--temp" && hasValue)   temp = argv[++i];
+		else if (arg == "--output" && hasValue) output = argv[++i];
+		else if (arg == "--depfile" && hasValue) depfile = argv[++i];
+		else if (arg == "--embed" && i + 3 < argc)
+		{
+			symbol = argv[++i];
+			embedSource = argv[++i];
+			embedHeader = argv[++i];
+		}
+		else if (arg.starts_with("--"))
+		{
+			std::cerr << "agi_shaderc: unknown or incomplete option '" << arg << "'\n";
+			return 1;
+		}
+		else
+			files.emplace_back(arg);
+	}
+
+	if (output.empty() || files.empty() || (target != "opengl" && target != "vulkan"))
+	{
+		std::cerr << "usage: agi_shaderc --glslang <exe> --target opengl|vulkan --temp <dir> --output <pack> [--embed <symbol> <cpp> <hpp>] [--depfile <file>] <files...>\n";
+		return 1;
+	}
+
+	fs::create_directories(temp);
+
+	std::vector<CompiledStage> stages;
+	std::vector<fs::path> dependencies;
+	bool success = true;
+	for (const fs::path& file : files)
+		success &= CompileFile(glslang, target, temp, file, stages, dependencies);
+
+	if (!success) return 1;
+
+	// Sorted so the runtime can binary search by name
+	std::stable_sort(stages.begin(), stages.end(), [](const CompiledStage& a, const CompiledStage& b)
+	{
+		return a.Name != b.Name ? a.Name < b.Name : a.Stage < b.Stage;
+	});
+
+	for (size_t i = 1; i < stages.size(); ++i)
+	{
+		if (stages[i].Name == stages[i - 1].Name && stages[i].Stage == stages[i - 1].Stage)
+		{
+			std::cerr << "agi_shaderc: error: shader '" << stages[i].Name << "' defines the same stage twice, or two files share that name\n";
+			return 1;
+		}
+	}
+
+	std::vector<uint32_t> words;
+	WritePack(output, stages, target == "vulkan" ? ShaderPackFormat::Target::Vulkan : ShaderPackFormat::Target::OpenGL, words);
+
+	if (!symbol.empty())
+		WriteEmbed(symbol, embedSource, embedHeader, words);
+
+	if (!depfile.empty())
+		WriteDepfile(depfile, output, dependencies);
+
+	return 0;
+}